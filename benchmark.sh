@@ -8,7 +8,17 @@ SIZES=(10000 15000 20000 25000 30000)
 LOCAL_PROCESSES=(2 4)
 MULTI_VM_PROCESSES=(6 8)
 REMOTE_VM="192.168.56.101"
-OUTPUT="benchmark_results.csv"
+
+# Every run answers the same seeded query set and writes one JSON file
+# into $RESULTS; visualize.py reads them all
+GRAPH_SEED=1
+QUERY_SEED=42
+QUERY_COUNT=20
+WARMUP=1
+SEQ_REPEAT=10
+DIST_REPEAT=3
+RESULTS="results"
+LABEL=$(git rev-parse --short HEAD 2>/dev/null || echo "local")
 
 # Step 1: Clean and Compile
 echo ""
@@ -28,56 +38,100 @@ echo "----------------------------------------"
 mkdir -p data/synthetic
 for SIZE in "${SIZES[@]}"; do
     EDGES=$((SIZE * 6))
-    GRAPH="data/synthetic/graph_${SIZE}.txt"
+    GRAPH="data/synthetic/graph_${SIZE}_seed${GRAPH_SEED}.txt"
     if [ ! -f "$GRAPH" ]; then
         echo "Generating $SIZE nodes with $EDGES edges..."
-        ./build/generator $SIZE $EDGES $GRAPH
+        ./build/generator $SIZE $EDGES $GRAPH --seed $GRAPH_SEED
     else
         echo "Graph $SIZE already exists, skipping..."
     fi
+    LANDMARKS="data/synthetic/graph_${SIZE}_seed${GRAPH_SEED}.lm"
+    if [ ! -f "$LANDMARKS" ]; then
+        echo "Computing landmarks for $SIZE nodes..."
+        ./build/landmark_preprocess $GRAPH $LANDMARKS > /dev/null
+    fi
 done
 echo "All graphs ready"
 
 # Step 3: Run Benchmarks
 echo ""
-echo "Step 3: Running benchmarks..."
+echo "Step 3: Running benchmarks (label $LABEL)..."
 echo "----------------------------------------"
-echo "Implementation,Graph_Size,Processes,Time_ms,Distance,Iterations" > $OUTPUT
+rm -rf $RESULTS
+mkdir -p $RESULTS
 
-# Sequential Tests
+# Sequential solvers, measured in-process; this also writes the query set
+# the other binaries answer
 echo ""
 echo "=== SEQUENTIAL TESTS ==="
 for SIZE in "${SIZES[@]}"; do
-    GRAPH="data/synthetic/graph_${SIZE}.txt"
-    SOURCE=0
-    DEST=$((SIZE-1))
-    
-    echo "Testing Sequential: $SIZE nodes"
-    RESULT=$(./build/sequential $GRAPH $SOURCE $DEST 2>/dev/null)
-    TIME=$(echo "$RESULT" | grep "Execution time:" | awk '{print $3}')
-    DIST=$(echo "$RESULT" | grep "Distance:" | awk '{print $2}')
-    echo "Sequential,$SIZE,1,$TIME,$DIST,N/A" >> $OUTPUT
-    echo "  Sequential: ${TIME}ms, Distance: $DIST"
+    GRAPH="data/synthetic/graph_${SIZE}_seed${GRAPH_SEED}.txt"
+    QUERIES="data/synthetic/queries_${SIZE}_seed${QUERY_SEED}.txt"
+    echo "Testing Sequential: $SIZE nodes, $QUERY_COUNT queries"
+    ./build/benchmark $GRAPH --queries $QUERY_COUNT --seed $QUERY_SEED --save-queries $QUERIES \
+        --warmup $WARMUP --repeat $SEQ_REPEAT \
+        --methods dijkstra,dary,radix,bidir,alt,alt-bidir \
+        --landmarks data/synthetic/graph_${SIZE}_seed${GRAPH_SEED}.lm \
+        --label "$LABEL" --json $RESULTS/sequential_${SIZE}.json
+done
+
+# Query server thread scaling on the same query set
+echo ""
+echo "=== QUERY SERVER SCALING TESTS ==="
+SERVER_THREADS="1,2,4,8"
+for SIZE in "${SIZES[@]}"; do
+    GRAPH="data/synthetic/graph_${SIZE}_seed${GRAPH_SEED}.txt"
+    QUERIES="data/synthetic/queries_${SIZE}_seed${QUERY_SEED}.txt"
+    echo "Testing Query Server: $SIZE nodes"
+    ./build/query_server $GRAPH --queries $QUERIES --scaling $SERVER_THREADS 2>/dev/null \
+        | tee $RESULTS/query_server_${SIZE}.txt
 done
 
+# One distributed configuration: run_distributed <name> <size> <np> <mpirun args> -- <solver args>
+run_distributed() {
+    local NAME=$1 SIZE=$2 NP=$3
+    shift 3
+    local MPI_ARGS=()
+    while [ "$1" != "--" ]; do
+        MPI_ARGS+=("$1")
+        shift
+    done
+    shift
+    local GRAPH="data/synthetic/graph_${SIZE}_seed${GRAPH_SEED}.txt"
+    local QUERIES="data/synthetic/queries_${SIZE}_seed${QUERY_SEED}.txt"
+    local JSON="$RESULTS/${NAME}_${SIZE}_${NP}.json"
+    mpirun -np $NP "${MPI_ARGS[@]}" ./build/distributed $GRAPH --batch $QUERIES --output /dev/null \
+        --warmup $WARMUP --repeat $DIST_REPEAT --name $NAME --label "$LABEL" --json $JSON "$@" \
+        2>/dev/null
+    if [ -f "$JSON" ]; then
+        echo "    $NAME: written to $JSON"
+    else
+        echo "    $NAME: FAILED"
+    fi
+}
+
 # Local Distributed Tests (2, 4 processors)
 echo ""
 echo "=== LOCAL DISTRIBUTED TESTS (2, 4 Processors) ==="
 for SIZE in "${SIZES[@]}"; do
-    GRAPH="data/synthetic/graph_${SIZE}.txt"
-    SOURCE=0
-    DEST=$((SIZE-1))
-    
     echo "Testing Distributed: $SIZE nodes"
-    
     for NP in "${LOCAL_PROCESSES[@]}"; do
         echo "  [$NP processors - local]"
-        RESULT=$(mpirun -np $NP ./build/distributed $GRAPH $SOURCE $DEST 2>/dev/null)
-        TIME=$(echo "$RESULT" | grep "Execution time:" | awk '{print $3}')
-        DIST=$(echo "$RESULT" | grep "Distance:" | awk '{print $2}')
-        ITERS=$(echo "$RESULT" | grep "Iterations:" | awk '{print $2}')
-        echo "Distributed-Local,$SIZE,$NP,$TIME,$DIST,$ITERS" >> $OUTPUT
-        echo "    Time: ${TIME}ms, Distance: $DIST, Iterations: $ITERS"
+        run_distributed Distributed-Local $SIZE $NP --
+        # Same run without supersteps
+        run_distributed Distributed-Local-Async $SIZE $NP -- --mode async
+    done
+done
+
+# Hybrid MPI + OpenMP: one rank per VM, relaxation threads inside it
+echo ""
+echo "=== HYBRID MPI + OPENMP TESTS (1 process x N threads) ==="
+HYBRID_THREADS=(2 4)
+for SIZE in "${SIZES[@]}"; do
+    echo "Testing Hybrid Distributed: $SIZE nodes"
+    for THREADS in "${HYBRID_THREADS[@]}"; do
+        echo "  [1 process x $THREADS threads]"
+        run_distributed Distributed-Hybrid-${THREADS}t $SIZE 1 -- --threads $THREADS
     done
 done
 
@@ -99,25 +153,18 @@ else
     HOSTFILE="mpi_hosts.txt"
     echo "localhost slots=4" > $HOSTFILE
     echo "$REMOTE_VM slots=4" >> $HOSTFILE
-    
+
     for SIZE in "${SIZES[@]}"; do
-        GRAPH="data/synthetic/graph_${SIZE}.txt"
-        SOURCE=0
-        DEST=$((SIZE-1))
-        
         echo "Testing Multi-VM Distributed: $SIZE nodes"
-        
         for NP in "${MULTI_VM_PROCESSES[@]}"; do
             echo "  [$NP processors - multi-VM]"
-            RESULT=$(mpirun -np $NP --hostfile $HOSTFILE ./build/distributed $GRAPH $SOURCE $DEST 2>/dev/null)
-            TIME=$(echo "$RESULT" | grep "Execution time:" | awk '{print $3}')
-            DIST=$(echo "$RESULT" | grep "Distance:" | awk '{print $2}')
-            ITERS=$(echo "$RESULT" | grep "Iterations:" | awk '{print $2}')
-            echo "Distributed-MultiVM,$SIZE,$NP,$TIME,$DIST,$ITERS" >> $OUTPUT
-            echo "    Time: ${TIME}ms, Distance: $DIST, Iterations: $ITERS"
+            run_distributed Distributed-MultiVM $SIZE $NP --hostfile $HOSTFILE --
+            run_distributed Distributed-MultiVM-Async $SIZE $NP --hostfile $HOSTFILE -- --mode async
+            # Idle processes take frontier work from busy ones
+            run_distributed Distributed-MultiVM-Async-Steal $SIZE $NP --hostfile $HOSTFILE -- --mode async --steal
         done
     done
-    
+
     rm -f $HOSTFILE
 fi
 
@@ -126,49 +173,17 @@ echo "=========================================="
 echo "Benchmark Complete!"
 echo "=========================================="
 echo ""
-echo "Results saved to: $OUTPUT"
+echo "Results saved to: $RESULTS/"
 echo ""
-echo "Summary Table:"
-echo "=========================================="
-column -t -s',' $OUTPUT
-
-# Calculate speedups
-echo ""
-echo "=========================================="
-echo "Speedup Analysis:"
-echo "=========================================="
 
-for SIZE in "${SIZES[@]}"; do
-    SEQ_TIME=$(grep "Sequential,$SIZE,1" $OUTPUT | cut -d',' -f4)
-    
-    if [ ! -z "$SEQ_TIME" ] && [ "$SEQ_TIME" != "0" ]; then
-        echo ""
-        echo "$SIZE nodes (Sequential: ${SEQ_TIME}ms):"
-        
-        # Local processors
-        for NP in "${LOCAL_PROCESSES[@]}"; do
-            DIST_TIME=$(grep "Distributed-Local,$SIZE,$NP" $OUTPUT | cut -d',' -f4)
-            if [ ! -z "$DIST_TIME" ] && [ "$DIST_TIME" != "0" ]; then
-                SPEEDUP=$(echo "scale=2; $SEQ_TIME / $DIST_TIME" | bc)
-                EFFICIENCY=$(echo "scale=1; ($SPEEDUP / $NP) * 100" | bc)
-                echo "  $NP processes (local): ${DIST_TIME}ms → ${SPEEDUP}x speedup (${EFFICIENCY}% efficiency)"
-            fi
-        done
-        
-        # Multi-VM processors
-        for NP in "${MULTI_VM_PROCESSES[@]}"; do
-            DIST_TIME=$(grep "Distributed-MultiVM,$SIZE,$NP" $OUTPUT | cut -d',' -f4)
-            if [ ! -z "$DIST_TIME" ] && [ "$DIST_TIME" != "0" ]; then
-                SPEEDUP=$(echo "scale=2; $SEQ_TIME / $DIST_TIME" | bc)
-                EFFICIENCY=$(echo "scale=1; ($SPEEDUP / $NP) * 100" | bc)
-                echo "  $NP processes (multi-VM): ${DIST_TIME}ms → ${SPEEDUP}x speedup (${EFFICIENCY}% efficiency)"
-            fi
-        done
-    fi
-done
+# Summary table and speedups from the JSON files
+python3 visualize.py $RESULTS --summary || echo "(visualize.py needs pandas and numpy for the summary)"
 
 echo ""
 echo "=========================================="
+echo "Compare against an earlier run with:"
+echo "  python3 visualize.py $RESULTS --baseline <old_results> --summary"
+echo ""
 echo "Note: Multi-VM tests require:"
 echo "  1. SSH access to $REMOTE_VM"
 echo "  2. MPI installed on both VMs"
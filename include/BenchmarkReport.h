@@ -0,0 +1,161 @@
+#ifndef BENCHMARK_REPORT_H
+#define BENCHMARK_REPORT_H
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+// Machine-readable benchmark results shared by the benchmark harness and
+// the distributed binary (--json). One file describes one run on one graph:
+//
+//   {"label": ..., "graph": {"file": ..., "nodes": N, "edges": M},
+//    "config": {"queries": q, "seed": s, "warmup": w, "repeat": r},
+//    "results": [{"implementation": ..., "processes": p, "threads": t,
+//                 "time_us": {"min", "median", "mean", "stddev", "max", "samples"},
+//                 "metrics": {...}}, ...]}
+//
+// time_us summarises the measured repetitions; each repetition answers the
+// whole query set. visualize.py reads these files.
+
+// Summary of repeated measurements
+struct SampleStats {
+    int samples = 0;
+    double min = 0.0;
+    double median = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;  // Sample standard deviation
+    double max = 0.0;
+
+    static SampleStats compute(std::vector<double> values) {
+        SampleStats stats;
+        stats.samples = values.size();
+        if (values.empty()) {
+            return stats;
+        }
+        std::sort(values.begin(), values.end());
+        size_t n = values.size();
+        stats.min = values.front();
+        stats.max = values.back();
+        stats.median = (n % 2 == 1) ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+
+        double total = 0.0;
+        for (double value : values) {
+            total += value;
+        }
+        stats.mean = total / n;
+        if (n > 1) {
+            double squares = 0.0;
+            for (double value : values) {
+                squares += (value - stats.mean) * (value - stats.mean);
+            }
+            stats.stddev = std::sqrt(squares / (n - 1));
+        }
+        return stats;
+    }
+};
+
+// One measured configuration
+struct BenchmarkResult {
+    std::string implementation;  // e.g. "Sequential-bidir", "Distributed-Local"
+    int processes = 1;
+    int threads = 1;
+    SampleStats timeUs;
+    std::vector<std::pair<std::string, double>> metrics;  // Averages per repetition
+
+    void addMetric(const std::string& name, double value) {
+        metrics.emplace_back(name, value);
+    }
+};
+
+class BenchmarkReport {
+private:
+    std::string label;
+    std::string graphFile;
+    long long nodes;
+    long long edges;
+    int queries;
+    long long seed;  // -1 if the queries were not generated
+    int warmup;
+    int repeat;
+    std::vector<BenchmarkResult> results;
+
+    static std::string quote(const std::string& text) {
+        std::string quoted = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                quoted += '\\';
+            }
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    // JSON has no infinity or NaN
+    static std::string number(double value) {
+        if (!std::isfinite(value)) {
+            return "null";
+        }
+        std::ostringstream text;
+        text.precision(12);
+        text << value;
+        return text.str();
+    }
+
+public:
+    BenchmarkReport(const std::string& runLabel, const std::string& graph, long long nodeCount,
+                    long long edgeCount, int queryCount, long long querySeed,
+                    int warmupCount, int repeatCount)
+        : label(runLabel), graphFile(graph), nodes(nodeCount), edges(edgeCount),
+          queries(queryCount), seed(querySeed), warmup(warmupCount), repeat(repeatCount) {}
+
+    void add(const BenchmarkResult& result) {
+        results.push_back(result);
+    }
+
+    bool write(const std::string& filename) const {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot create file " << filename << std::endl;
+            return false;
+        }
+
+        file << "{\n";
+        file << "  \"label\": " << quote(label) << ",\n";
+        file << "  \"graph\": {\"file\": " << quote(graphFile) << ", \"nodes\": " << nodes
+             << ", \"edges\": " << edges << "},\n";
+        file << "  \"config\": {\"queries\": " << queries << ", \"seed\": "
+             << (seed >= 0 ? std::to_string(seed) : "null") << ", \"warmup\": " << warmup
+             << ", \"repeat\": " << repeat << "},\n";
+        file << "  \"results\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchmarkResult& result = results[i];
+            const SampleStats& time = result.timeUs;
+            file << (i == 0 ? "\n" : ",\n");
+            file << "    {\"implementation\": " << quote(result.implementation)
+                 << ", \"processes\": " << result.processes << ", \"threads\": " << result.threads << ",\n";
+            file << "     \"time_us\": {\"min\": " << number(time.min) << ", \"median\": " << number(time.median)
+                 << ", \"mean\": " << number(time.mean) << ", \"stddev\": " << number(time.stddev)
+                 << ", \"max\": " << number(time.max) << ", \"samples\": " << time.samples << "},\n";
+            file << "     \"metrics\": {";
+            for (size_t m = 0; m < result.metrics.size(); m++) {
+                file << (m == 0 ? "" : ", ") << quote(result.metrics[m].first) << ": "
+                     << number(result.metrics[m].second);
+            }
+            file << "}}";
+        }
+        file << "\n  ]\n}\n";
+
+        if (!file) {
+            std::cerr << "Error: Failed writing " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,401 @@
+#ifndef BINARY_GRAPH_FORMAT_H
+#define BINARY_GRAPH_FORMAT_H
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// On-disk CSR graph format (one file, native byte order):
+//
+//   BinaryGraphHeader                       64 bytes
+//   offsets   index  x (nodeCount + 1)     (padded to 8 bytes)
+//   targets   int32  x edgeCount           (padded to 8 bytes)
+//   weights   weight x edgeCount           (padded to 8 bytes)
+//   xCoords   double x nodeCount           (only if HAS_COORDINATES)
+//   yCoords   double x nodeCount           (only if HAS_COORDINATES)
+//   origIds   int32  x nodeCount           (only if HAS_ORIGINAL_IDS, padded to 8 bytes)
+//
+// The header's layout field gives the element types of the offsets
+// (int32 or uint64) and weights (double, float or uint32) sections; layout
+// 0 is int32/double. Every section starts on an 8-byte boundary, so a
+// mapped file can be used in place as the CSR arrays without any parsing or
+// copying when the graph type matches the layout.
+//
+// A reordered graph (see NodeOrdering.h) stores, for every node, the ID it
+// had in the file it was converted from, so tools can keep answering
+// queries in those IDs.
+//
+// Version 2 added the layout field (reserved in version 1) and the
+// original ID table. Version 1 files are int32/double without an ID table
+// and still load; a file with flags this reader does not know is rejected.
+namespace BinaryGraphFormat {
+    const char MAGIC[8] = {'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H'};
+    const uint32_t VERSION = 2;
+    const uint32_t ENDIAN_TAG = 0x01020304;
+    const uint32_t ENDIAN_TAG_SWAPPED = 0x04030201;
+
+    // Header flags
+    const uint32_t HAS_COORDINATES = 1u << 0;
+    const uint32_t HAS_ORIGINAL_IDS = 1u << 1;
+    const uint32_t KNOWN_FLAGS = HAS_COORDINATES | HAS_ORIGINAL_IDS;
+
+    // Round a byte count up to the next 8-byte boundary
+    inline uint64_t align8(uint64_t bytes) {
+        return (bytes + 7) & ~uint64_t(7);
+    }
+}
+
+// Element type of the offsets section: the edge index
+enum class EdgeIndexType : uint32_t {
+    Int32 = 0,   // Up to 2^31 - 1 edges
+    UInt64 = 1
+};
+
+// Element type of the weights section
+enum class WeightType : uint32_t {
+    Float64 = 0,
+    Float32 = 1,  // ~7 significant digits
+    UInt32 = 2    // Non-negative integral weights (e.g. road data in fixed units)
+};
+
+inline bool parseEdgeIndexType(const std::string& name, EdgeIndexType& type) {
+    if (name == "32") {
+        type = EdgeIndexType::Int32;
+    } else if (name == "64") {
+        type = EdgeIndexType::UInt64;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline bool parseWeightType(const std::string& name, WeightType& type) {
+    if (name == "double") {
+        type = WeightType::Float64;
+    } else if (name == "float") {
+        type = WeightType::Float32;
+    } else if (name == "uint32") {
+        type = WeightType::UInt32;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline const char* getWeightTypeName(WeightType type) {
+    switch (type) {
+        case WeightType::Float32: return "float";
+        case WeightType::UInt32: return "uint32";
+        default: return "double";
+    }
+}
+
+inline size_t getEdgeIndexBytes(EdgeIndexType type) {
+    return type == EdgeIndexType::UInt64 ? sizeof(uint64_t) : sizeof(int32_t);
+}
+
+inline size_t getWeightBytes(WeightType type) {
+    return type == WeightType::Float64 ? sizeof(double) : sizeof(uint32_t);
+}
+
+// Compile-time mapping from the C++ edge index and weight types to the
+// layout codes, plus range-checked conversion into them
+template <typename Index> struct EdgeIndexTraits;
+
+template <> struct EdgeIndexTraits<int> {
+    static constexpr EdgeIndexType TYPE = EdgeIndexType::Int32;
+};
+
+template <> struct EdgeIndexTraits<uint64_t> {
+    static constexpr EdgeIndexType TYPE = EdgeIndexType::UInt64;
+};
+
+template <typename Weight> struct WeightTraits;
+
+template <> struct WeightTraits<double> {
+    static constexpr WeightType TYPE = WeightType::Float64;
+    static bool convert(double value, double& weight) {
+        weight = value;
+        return true;
+    }
+};
+
+template <> struct WeightTraits<float> {
+    static constexpr WeightType TYPE = WeightType::Float32;
+    static bool convert(double value, float& weight) {
+        weight = (float)value;
+        return true;
+    }
+};
+
+template <> struct WeightTraits<uint32_t> {
+    static constexpr WeightType TYPE = WeightType::UInt32;
+    static bool convert(double value, uint32_t& weight) {
+        if (!(value >= 0.0 && value <= 4294967295.0) || value != (double)(uint64_t)value) {
+            return false;
+        }
+        weight = (uint32_t)value;
+        return true;
+    }
+};
+
+// Read count offsets stored as `type` into Index, false if one does not fit
+template <typename Index>
+bool decodeEdgeIndices(const void* raw, EdgeIndexType type, size_t count, Index* out) {
+    const uint64_t limit = (uint64_t)std::numeric_limits<Index>::max();
+    for (size_t i = 0; i < count; i++) {
+        uint64_t value;
+        if (type == EdgeIndexType::UInt64) {
+            std::memcpy(&value, static_cast<const char*>(raw) + i * sizeof(uint64_t), sizeof(value));
+        } else {
+            int32_t narrow;
+            std::memcpy(&narrow, static_cast<const char*>(raw) + i * sizeof(int32_t), sizeof(narrow));
+            value = (uint64_t)narrow;
+        }
+        if (value > limit) {
+            return false;
+        }
+        out[i] = (Index)value;
+    }
+    return true;
+}
+
+// Read count weights stored as `type` into Weight, false if one does not fit
+template <typename Weight>
+bool decodeWeights(const void* raw, WeightType type, size_t count, Weight* out) {
+    for (size_t i = 0; i < count; i++) {
+        double value;
+        if (type == WeightType::Float64) {
+            std::memcpy(&value, static_cast<const char*>(raw) + i * sizeof(double), sizeof(value));
+        } else if (type == WeightType::Float32) {
+            float narrow;
+            std::memcpy(&narrow, static_cast<const char*>(raw) + i * sizeof(float), sizeof(narrow));
+            value = narrow;
+        } else {
+            uint32_t narrow;
+            std::memcpy(&narrow, static_cast<const char*>(raw) + i * sizeof(uint32_t), sizeof(narrow));
+            value = narrow;
+        }
+        if (!WeightTraits<Weight>::convert(value, out[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct BinaryGraphHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    uint64_t nodeCount;
+    uint64_t edgeCount;
+    uint32_t flags;
+    uint32_t layout;         // EdgeIndexType | WeightType << 8
+    uint64_t payloadBytes;   // Bytes following the header
+    uint64_t checksum;       // Hash of the payload (see payloadChecksum)
+    uint64_t reserved1;
+
+    BinaryGraphHeader()
+        : version(BinaryGraphFormat::VERSION),
+          endianTag(BinaryGraphFormat::ENDIAN_TAG),
+          nodeCount(0), edgeCount(0), flags(0), layout(0),
+          payloadBytes(0), checksum(0), reserved1(0) {
+        std::memcpy(magic, BinaryGraphFormat::MAGIC, sizeof(magic));
+    }
+
+    bool hasMagic() const {
+        return std::memcmp(magic, BinaryGraphFormat::MAGIC, sizeof(magic)) == 0;
+    }
+
+    EdgeIndexType getEdgeIndexType() const { return (EdgeIndexType)(layout & 0xff); }
+    WeightType getWeightType() const { return (WeightType)((layout >> 8) & 0xff); }
+
+    void setLayout(EdgeIndexType index, WeightType weight) {
+        layout = (uint32_t)index | (uint32_t)weight << 8;
+    }
+
+    bool hasKnownLayout() const {
+        return (layout & ~uint32_t(0xffff)) == 0 &&
+               getEdgeIndexType() <= EdgeIndexType::UInt64 && getWeightType() <= WeightType::UInt32;
+    }
+
+    // Version, layout and flags this reader understands (byte order and
+    // sizes are checked separately)
+    bool isSupportedVersion() const {
+        if (version == 1) {
+            return layout == 0 && (flags & ~BinaryGraphFormat::HAS_COORDINATES) == 0;
+        }
+        return version == BinaryGraphFormat::VERSION && hasKnownLayout() &&
+               (flags & ~BinaryGraphFormat::KNOWN_FLAGS) == 0;
+    }
+
+    // Byte offsets of each section, relative to the start of the file
+    uint64_t offsetsPos() const { return sizeof(BinaryGraphHeader); }
+    uint64_t targetsPos() const {
+        return offsetsPos() + BinaryGraphFormat::align8((nodeCount + 1) * getEdgeIndexBytes(getEdgeIndexType()));
+    }
+    uint64_t weightsPos() const { return targetsPos() + BinaryGraphFormat::align8(edgeCount * sizeof(int32_t)); }
+    uint64_t xCoordsPos() const {
+        return weightsPos() + BinaryGraphFormat::align8(edgeCount * getWeightBytes(getWeightType()));
+    }
+    uint64_t yCoordsPos() const { return xCoordsPos() + nodeCount * sizeof(double); }
+    uint64_t originalIdsPos() const {
+        return (flags & BinaryGraphFormat::HAS_COORDINATES)
+            ? yCoordsPos() + nodeCount * sizeof(double)
+            : xCoordsPos();
+    }
+
+    uint64_t expectedPayloadBytes() const {
+        uint64_t end = (flags & BinaryGraphFormat::HAS_ORIGINAL_IDS)
+            ? originalIdsPos() + BinaryGraphFormat::align8(nodeCount * sizeof(int32_t))
+            : originalIdsPos();
+        return end - sizeof(BinaryGraphHeader);
+    }
+};
+
+static_assert(sizeof(BinaryGraphHeader) == 64, "BinaryGraphHeader must stay 64 bytes");
+
+// Streaming 64-bit checksum over the payload.
+// Consumes 8-byte words (FNV-style multiply/xor with a final avalanche), so
+// verifying a multi-gigabyte file runs at memory bandwidth.
+class PayloadChecksum {
+private:
+    uint64_t state;
+    uint64_t length;
+    unsigned char tail[8];
+    size_t tailSize;
+
+    void mixWord(uint64_t word) {
+        state ^= word;
+        state *= 0x100000001b3ULL;
+        state ^= state >> 29;
+    }
+
+public:
+    PayloadChecksum() : state(0xcbf29ce484222325ULL), length(0), tailSize(0) {}
+
+    void update(const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        length += bytes;
+
+        // Finish a partial word left over from the previous call
+        if (tailSize > 0) {
+            size_t take = std::min(sizeof(tail) - tailSize, bytes);
+            std::memcpy(tail + tailSize, p, take);
+            tailSize += take;
+            p += take;
+            bytes -= take;
+        }
+        if (tailSize == 8) {
+            uint64_t word;
+            std::memcpy(&word, tail, 8);
+            mixWord(word);
+            tailSize = 0;
+        }
+
+        while (bytes >= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, 8);
+            mixWord(word);
+            p += 8;
+            bytes -= 8;
+        }
+
+        while (bytes > 0) {
+            tail[tailSize++] = *p++;
+            bytes--;
+        }
+    }
+
+    uint64_t finish() const {
+        uint64_t h = state;
+        if (tailSize > 0) {
+            uint64_t word = 0;
+            std::memcpy(&word, tail, tailSize);
+            h ^= word;
+            h *= 0x100000001b3ULL;
+        }
+        h ^= length;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+};
+
+// Read-only memory mapping of a whole file (RAII)
+class MappedFile {
+private:
+    void* base;
+    size_t length;
+
+public:
+    MappedFile() : base(nullptr), length(0) {}
+
+    ~MappedFile() {
+        if (base != nullptr) {
+            munmap(base, length);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Error: Cannot open file " << filename << std::endl;
+            return false;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+            std::cerr << "Error: Cannot stat file " << filename << std::endl;
+            ::close(fd);
+            return false;
+        }
+
+        length = static_cast<size_t>(info.st_size);
+        base = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        if (base == MAP_FAILED) {
+            std::cerr << "Error: Cannot mmap file " << filename << std::endl;
+            base = nullptr;
+            length = 0;
+            return false;
+        }
+        return true;
+    }
+
+    const unsigned char* data() const {
+        return static_cast<const unsigned char*>(base);
+    }
+
+    size_t size() const {
+        return length;
+    }
+};
+
+// Check whether a file starts with the binary graph magic
+inline bool isBinaryGraphFile(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    char magic[8];
+    ssize_t got = ::read(fd, magic, sizeof(magic));
+    ::close(fd);
+    return got == sizeof(magic) &&
+           std::memcmp(magic, BinaryGraphFormat::MAGIC, sizeof(magic)) == 0;
+}
+
+#endif
@@ -0,0 +1,643 @@
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include "Graph.h"
+#include "BinaryGraphFormat.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <fstream>
+
+// Immutable compressed sparse row (CSR) graph.
+// The outgoing edges of node u occupy the index range
+// [edgeBegin(u), edgeEnd(u)) of the targets/weights arrays, so walking an
+// adjacency list is a linear scan over two contiguous arrays instead of a
+// pointer chase through one heap-allocated vector per node.
+//
+// The arrays are either owned (built from a text file or a Graph) or point
+// straight into a memory-mapped binary file (see BinaryGraphFormat.h).
+//
+// EdgeIndex is the type of edge indices and offsets (int, or uint64_t past
+// 2^31 - 1 edges) and Weight the stored weight type (double, float or
+// integral uint32_t). Node IDs are int throughout. Searches still add
+// weights up in double, so a narrower Weight only shrinks the edge arrays:
+// uint32_t or float weights make an edge 8 bytes instead of 12.
+//
+// A graph renumbered with permute() (see NodeOrdering.h) remembers the
+// original ID of every node. Internally everything runs on the new IDs;
+// tools translate at their boundary with getInternalId/getOriginalId.
+template <typename EdgeIndexT, typename WeightT>
+class BasicCSRGraph {
+public:
+    using EdgeIndex = EdgeIndexT;
+    using Weight = WeightT;
+
+private:
+    int nodeCount;
+    EdgeIndex edgeCount;
+
+    // Views used by all accessors
+    const EdgeIndex* offsets;  // nodeCount + 1 entries
+    const int* targets;        // edgeCount entries
+    const Weight* weights;     // edgeCount entries
+    const double* xCoords;     // nodeCount entries (for A* heuristic)
+    const double* yCoords;
+
+    // Owned storage (empty when the graph is mapped from a binary file)
+    std::vector<EdgeIndex> offsetStore;
+    std::vector<int> targetStore;
+    std::vector<Weight> weightStore;
+    std::vector<double> xStore;
+    std::vector<double> yStore;
+
+    // Original IDs of a renumbered graph (always owned; empty otherwise):
+    // originalStore[v] is the original ID of node v, internalStore the inverse
+    std::vector<int> originalStore;
+    std::vector<int> internalStore;
+
+    // Keeps the mapping alive for as long as any copy of the graph uses it
+    std::shared_ptr<MappedFile> mapping;
+
+    // Point the views at the owned storage
+    void bindOwnedStorage() {
+        offsets = offsetStore.data();
+        targets = targetStore.data();
+        weights = weightStore.data();
+        xCoords = xStore.data();
+        yCoords = yStore.data();
+    }
+
+    // Build CSR arrays from an edge list with a counting sort on the source.
+    // The sort is stable, so each adjacency list keeps its insertion order.
+    void buildFromEdgeList(
+        int numNodes,
+        const std::vector<int>& from,
+        const std::vector<int>& to,
+        const std::vector<Weight>& edgeWeights
+    ) {
+        nodeCount = numNodes;
+        edgeCount = from.size();
+        mapping.reset();
+        originalStore.clear();
+        internalStore.clear();
+
+        offsetStore.assign(nodeCount + 1, 0);
+        for (EdgeIndex i = 0; i < edgeCount; i++) {
+            offsetStore[from[i] + 1]++;
+        }
+        for (int u = 0; u < nodeCount; u++) {
+            offsetStore[u + 1] += offsetStore[u];
+        }
+
+        targetStore.resize(edgeCount);
+        weightStore.resize(edgeCount);
+        std::vector<EdgeIndex> cursor(offsetStore.begin(), offsetStore.end() - 1);
+        for (EdgeIndex i = 0; i < edgeCount; i++) {
+            EdgeIndex slot = cursor[from[i]]++;
+            targetStore[slot] = to[i];
+            weightStore[slot] = edgeWeights[i];
+        }
+
+        xStore.assign(nodeCount, 0.0);
+        yStore.assign(nodeCount, 0.0);
+        bindOwnedStorage();
+    }
+
+public:
+    // Constructor
+    BasicCSRGraph() : nodeCount(0), edgeCount(0), offsetStore(1, 0) {
+        bindOwnedStorage();
+    }
+
+    // Build from an adjacency-list Graph
+    explicit BasicCSRGraph(const BasicGraph<Weight>& graph) : nodeCount(0), edgeCount(0) {
+        int numNodes = graph.getNodeCount();
+        std::vector<int> from, to;
+        std::vector<Weight> edgeWeights;
+        from.reserve(graph.getEdgeCount());
+        to.reserve(graph.getEdgeCount());
+        edgeWeights.reserve(graph.getEdgeCount());
+
+        for (int u = 0; u < numNodes; u++) {
+            for (const BasicEdge<Weight>& edge : graph.getAdjacencyList(u)) {
+                from.push_back(u);
+                to.push_back(edge.destination);
+                edgeWeights.push_back(edge.weight);
+            }
+        }
+
+        buildFromEdgeList(numNodes, from, to, edgeWeights);
+
+        for (int u = 0; u < numNodes; u++) {
+            xStore[u] = graph.getNode(u).x;
+            yStore[u] = graph.getNode(u).y;
+        }
+    }
+
+    // Reverse graph: every edge u -> v becomes v -> u with the same weight.
+    // Coordinates are copied so the heuristic works on either direction.
+    BasicCSRGraph getReverse() const {
+        std::vector<int> from(edgeCount), to(edgeCount);
+        std::vector<Weight> edgeWeights(weights, weights + edgeCount);
+        for (int u = 0; u < nodeCount; u++) {
+            for (EdgeIndex e = offsets[u]; e < offsets[u + 1]; e++) {
+                from[e] = targets[e];
+                to[e] = u;
+            }
+        }
+
+        BasicCSRGraph reverse;
+        reverse.buildFromEdgeList(nodeCount, from, to, edgeWeights);
+        reverse.xStore.assign(xCoords, xCoords + nodeCount);
+        reverse.yStore.assign(yCoords, yCoords + nodeCount);
+        reverse.originalStore = originalStore;
+        reverse.internalStore = internalStore;
+        reverse.bindOwnedStorage();
+        return reverse;
+    }
+
+    // Renumbered copy: node newToOld[i] of this graph becomes node i. Each
+    // row is sorted by target so edge scans walk the distance array
+    // forwards. The copy maps its IDs back to this graph's original IDs.
+    BasicCSRGraph permute(const std::vector<int>& newToOld) const {
+        std::vector<int> oldToNew(nodeCount);
+        for (int i = 0; i < nodeCount; i++) {
+            oldToNew[newToOld[i]] = i;
+        }
+
+        BasicCSRGraph result;
+        result.nodeCount = nodeCount;
+        result.edgeCount = edgeCount;
+        result.offsetStore.assign(nodeCount + 1, 0);
+        for (int i = 0; i < nodeCount; i++) {
+            result.offsetStore[i + 1] = result.offsetStore[i] + getDegree(newToOld[i]);
+        }
+        result.targetStore.resize(edgeCount);
+        result.weightStore.resize(edgeCount);
+        result.xStore.resize(nodeCount);
+        result.yStore.resize(nodeCount);
+        result.originalStore.resize(nodeCount);
+        result.internalStore.resize(nodeCount);
+
+        std::vector<std::pair<int, Weight>> row;
+        for (int i = 0; i < nodeCount; i++) {
+            int u = newToOld[i];
+            row.clear();
+            for (EdgeIndex e = offsets[u]; e < offsets[u + 1]; e++) {
+                row.emplace_back(oldToNew[targets[e]], weights[e]);
+            }
+            std::sort(row.begin(), row.end());
+            EdgeIndex slot = result.offsetStore[i];
+            for (const auto& edge : row) {
+                result.targetStore[slot] = edge.first;
+                result.weightStore[slot] = edge.second;
+                slot++;
+            }
+            result.xStore[i] = xCoords[u];
+            result.yStore[i] = yCoords[u];
+            result.originalStore[i] = getOriginalId(u);
+            result.internalStore[getOriginalId(u)] = i;
+        }
+        result.bindOwnedStorage();
+        return result;
+    }
+
+    // Copies share a mapping but must re-point views at their own storage
+    BasicCSRGraph(const BasicCSRGraph& other)
+        : nodeCount(other.nodeCount), edgeCount(other.edgeCount),
+          offsets(other.offsets), targets(other.targets), weights(other.weights),
+          xCoords(other.xCoords), yCoords(other.yCoords),
+          offsetStore(other.offsetStore), targetStore(other.targetStore),
+          weightStore(other.weightStore), xStore(other.xStore), yStore(other.yStore),
+          originalStore(other.originalStore), internalStore(other.internalStore),
+          mapping(other.mapping) {
+        if (!mapping) {
+            bindOwnedStorage();
+        } else if (!xStore.empty()) {
+            // Mapped file without coordinates keeps zeroed coordinates locally
+            xCoords = xStore.data();
+            yCoords = yStore.data();
+        }
+    }
+
+    BasicCSRGraph& operator=(const BasicCSRGraph& other) {
+        if (this != &other) {
+            BasicCSRGraph copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    // Moving a vector keeps its buffer, so the views stay valid
+    BasicCSRGraph(BasicCSRGraph&&) = default;
+    BasicCSRGraph& operator=(BasicCSRGraph&&) = default;
+
+    // Get number of nodes
+    int getNodeCount() const {
+        return nodeCount;
+    }
+
+    // Get number of edges
+    EdgeIndex getEdgeCount() const {
+        return edgeCount;
+    }
+
+    // First edge index of a node
+    EdgeIndex edgeBegin(int nodeId) const {
+        return offsets[nodeId];
+    }
+
+    // One past the last edge index of a node
+    EdgeIndex edgeEnd(int nodeId) const {
+        return offsets[nodeId + 1];
+    }
+
+    // Out-degree of a node
+    int getDegree(int nodeId) const {
+        return offsets[nodeId + 1] - offsets[nodeId];
+    }
+
+    // Destination of an edge
+    int getTarget(EdgeIndex edgeIndex) const {
+        return targets[edgeIndex];
+    }
+
+    // Weight of an edge
+    Weight getWeight(EdgeIndex edgeIndex) const {
+        return weights[edgeIndex];
+    }
+
+    // Raw array access for bulk loops
+    const EdgeIndex* getOffsets() const { return offsets; }
+    const int* getTargets() const { return targets; }
+    const Weight* getWeights() const { return weights; }
+
+    // Hash of the node count, adjacency structure and weights, the same for
+    // every stored index and weight type. Files derived from a graph (.ch,
+    // .lm) record it to recognise the graph they were computed for.
+    uint64_t getContentHash() const {
+        // Offsets and weights are widened in chunks to int64 and double;
+        // the first chunk starts with the node and edge counts
+        const size_t CHUNK = 4096;
+        PayloadChecksum checksum;
+        std::vector<int64_t> wideOffsets = {nodeCount, (int64_t)edgeCount};
+        for (size_t begin = 0; begin <= (size_t)nodeCount; begin += CHUNK) {
+            size_t end = std::min(begin + CHUNK, (size_t)nodeCount + 1);
+            wideOffsets.insert(wideOffsets.end(), offsets + begin, offsets + end);
+            checksum.update(wideOffsets.data(), wideOffsets.size() * sizeof(int64_t));
+            wideOffsets.clear();
+        }
+        checksum.update(targets, (size_t)edgeCount * sizeof(int));
+        std::vector<double> wideWeights;
+        for (size_t begin = 0; begin < (size_t)edgeCount; begin += CHUNK) {
+            size_t end = std::min(begin + CHUNK, (size_t)edgeCount);
+            wideWeights.assign(weights + begin, weights + end);
+            checksum.update(wideWeights.data(), wideWeights.size() * sizeof(double));
+        }
+        return checksum.finish();
+    }
+
+    // True if the arrays live in a memory-mapped binary file
+    bool isMapped() const { return mapping != nullptr; }
+
+    // True if any node has non-zero coordinates
+    bool hasCoordinates() const {
+        for (int u = 0; u < nodeCount; u++) {
+            if (xCoords[u] != 0.0 || yCoords[u] != 0.0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Node coordinates
+    double getX(int nodeId) const { return xCoords[nodeId]; }
+    double getY(int nodeId) const { return yCoords[nodeId]; }
+
+    // True if the graph was renumbered and knows its original IDs
+    bool hasOriginalIds() const { return !originalStore.empty(); }
+
+    // Original ID of an internal node, and the reverse. Both are the
+    // identity unless the graph was renumbered.
+    int getOriginalId(int nodeId) const {
+        return originalStore.empty() ? nodeId : originalStore[nodeId];
+    }
+    int getInternalId(int originalId) const {
+        return internalStore.empty() ? originalId : internalStore[originalId];
+    }
+
+    // Calculate Euclidean distance heuristic (for A*)
+    double getHeuristic(int fromNode, int toNode) const {
+        if (fromNode < 0 || fromNode >= nodeCount ||
+            toNode < 0 || toNode >= nodeCount) {
+            return 0.0;
+        }
+
+        double dx = xCoords[fromNode] - xCoords[toNode];
+        double dy = yCoords[fromNode] - yCoords[toNode];
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    // Load a graph file, detecting the binary format by its magic
+    bool loadFromFile(const std::string& filename) {
+        if (isBinaryGraphFile(filename)) {
+            return loadBinaryFile(filename);
+        }
+        return loadTextFile(filename);
+    }
+
+    // Load graph directly from a text edge list into CSR form.
+    // Same file format as Graph::loadFromFile, but edges are collected into
+    // flat arrays and bucketed once, without per-node vectors.
+    bool loadTextFile(const std::string& filename) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot open file " << filename << std::endl;
+            return false;
+        }
+
+        long long numNodes, numEdges;
+        if (!(file >> numNodes >> numEdges) || numNodes < 0 || numEdges < 0 ||
+            numNodes > std::numeric_limits<int>::max()) {
+            std::cerr << "Error: Invalid header in " << filename << std::endl;
+            return false;
+        }
+        if ((unsigned long long)numEdges > (unsigned long long)std::numeric_limits<EdgeIndex>::max()) {
+            std::cerr << "Error: " << filename << " has " << numEdges
+                      << " edges, more than this graph's edge index can address" << std::endl;
+            return false;
+        }
+
+        std::vector<int> from, to;
+        std::vector<Weight> edgeWeights;
+        from.reserve(numEdges);
+        to.reserve(numEdges);
+        edgeWeights.reserve(numEdges);
+
+        // Read edges, dropping out-of-range ones like Graph::addEdge does
+        for (long long i = 0; i < numEdges; i++) {
+            int u, v;
+            double weight;
+            if (!(file >> u >> v >> weight)) {
+                std::cerr << "Error: Truncated edge list in " << filename << std::endl;
+                return false;
+            }
+            if (u >= 0 && u < numNodes && v >= 0 && v < numNodes) {
+                Weight stored;
+                if (!WeightTraits<Weight>::convert(weight, stored)) {
+                    std::cerr << "Error: Weight " << weight << " of edge " << u << " -> " << v
+                              << " does not fit " << getWeightTypeName(WeightTraits<Weight>::TYPE)
+                              << " weights" << std::endl;
+                    return false;
+                }
+                from.push_back(u);
+                to.push_back(v);
+                edgeWeights.push_back(stored);
+            }
+        }
+
+        file.close();
+        buildFromEdgeList(numNodes, from, to, edgeWeights);
+        return true;
+    }
+
+    // Map a binary graph file and use its sections in place.
+    // With verifyChecksum the whole payload is read once and hashed; without
+    // it only the pages that are actually touched are ever read from disk.
+    // A file whose layout differs from this graph type is converted into
+    // owned arrays instead.
+    bool loadBinaryFile(const std::string& filename, bool verifyChecksum = true) {
+        auto file = std::make_shared<MappedFile>();
+        if (!file->open(filename)) {
+            return false;
+        }
+
+        if (file->size() < sizeof(BinaryGraphHeader)) {
+            std::cerr << "Error: " << filename << " is too small for a graph header" << std::endl;
+            return false;
+        }
+
+        BinaryGraphHeader header;
+        std::memcpy(&header, file->data(), sizeof(header));
+
+        if (!header.hasMagic()) {
+            std::cerr << "Error: " << filename << " is not a binary graph file" << std::endl;
+            return false;
+        }
+        if (header.endianTag == BinaryGraphFormat::ENDIAN_TAG_SWAPPED) {
+            std::cerr << "Error: " << filename << " was written on a host with the opposite byte order" << std::endl;
+            return false;
+        }
+        if (header.endianTag != BinaryGraphFormat::ENDIAN_TAG ||
+            !header.isSupportedVersion()) {
+            std::cerr << "Error: " << filename << " has unsupported format version "
+                      << header.version << ", layout or flags" << std::endl;
+            return false;
+        }
+        if (header.nodeCount > (uint64_t)std::numeric_limits<int>::max() ||
+            header.payloadBytes != header.expectedPayloadBytes() ||
+            file->size() < sizeof(BinaryGraphHeader) + header.payloadBytes) {
+            std::cerr << "Error: " << filename << " is truncated or has an inconsistent header" << std::endl;
+            return false;
+        }
+        if (header.edgeCount > (uint64_t)std::numeric_limits<EdgeIndex>::max()) {
+            std::cerr << "Error: " << filename << " has " << header.edgeCount
+                      << " edges, more than this graph's edge index can address" << std::endl;
+            return false;
+        }
+
+        if (verifyChecksum) {
+            PayloadChecksum checksum;
+            checksum.update(file->data() + sizeof(BinaryGraphHeader), header.payloadBytes);
+            if (checksum.finish() != header.checksum) {
+                std::cerr << "Error: Checksum mismatch in " << filename << std::endl;
+                return false;
+            }
+        }
+
+        // Everything is decoded and validated into a fresh graph, so a
+        // failed load leaves this one untouched
+        const unsigned char* base = file->data();
+        BasicCSRGraph loaded;
+        loaded.nodeCount = static_cast<int>(header.nodeCount);
+        loaded.edgeCount = static_cast<EdgeIndex>(header.edgeCount);
+        int numNodes = loaded.nodeCount;
+        EdgeIndex numEdges = loaded.edgeCount;
+        bool inPlace = header.getEdgeIndexType() == EdgeIndexTraits<EdgeIndex>::TYPE &&
+                       header.getWeightType() == WeightTraits<Weight>::TYPE;
+
+        if (inPlace) {
+            loaded.offsetStore.clear();
+            loaded.offsets = reinterpret_cast<const EdgeIndex*>(base + header.offsetsPos());
+            loaded.targets = reinterpret_cast<const int*>(base + header.targetsPos());
+            loaded.weights = reinterpret_cast<const Weight*>(base + header.weightsPos());
+        } else {
+            loaded.offsetStore.resize(numNodes + 1);
+            loaded.weightStore.resize(numEdges);
+            loaded.targetStore.resize(numEdges);
+            if (!decodeEdgeIndices(base + header.offsetsPos(), header.getEdgeIndexType(),
+                                   loaded.offsetStore.size(), loaded.offsetStore.data())) {
+                std::cerr << "Error: " << filename
+                          << " has edge offsets beyond what this graph's edge index can address" << std::endl;
+                return false;
+            }
+            if (!decodeWeights(base + header.weightsPos(), header.getWeightType(),
+                               loaded.weightStore.size(), loaded.weightStore.data())) {
+                std::cerr << "Error: " << filename << " has "
+                          << getWeightTypeName(header.getWeightType())
+                          << " weights that do not fit " << getWeightTypeName(WeightTraits<Weight>::TYPE)
+                          << std::endl;
+                return false;
+            }
+            std::memcpy(loaded.targetStore.data(), base + header.targetsPos(), (size_t)numEdges * sizeof(int32_t));
+        }
+
+        bool withCoordinates = header.flags & BinaryGraphFormat::HAS_COORDINATES;
+        if (inPlace && withCoordinates) {
+            loaded.xCoords = reinterpret_cast<const double*>(base + header.xCoordsPos());
+            loaded.yCoords = reinterpret_cast<const double*>(base + header.yCoordsPos());
+        } else if (withCoordinates) {
+            const double* x = reinterpret_cast<const double*>(base + header.xCoordsPos());
+            const double* y = reinterpret_cast<const double*>(base + header.yCoordsPos());
+            loaded.xStore.assign(x, x + numNodes);
+            loaded.yStore.assign(y, y + numNodes);
+        } else {
+            loaded.xStore.assign(numNodes, 0.0);
+            loaded.yStore.assign(numNodes, 0.0);
+        }
+
+        if (header.flags & BinaryGraphFormat::HAS_ORIGINAL_IDS) {
+            const int32_t* ids = reinterpret_cast<const int32_t*>(base + header.originalIdsPos());
+            loaded.originalStore.assign(ids, ids + numNodes);
+            loaded.internalStore.assign(numNodes, -1);
+            for (int v = 0; v < numNodes; v++) {
+                int original = loaded.originalStore[v];
+                if (original < 0 || original >= numNodes || loaded.internalStore[original] >= 0) {
+                    std::cerr << "Error: " << filename << " has an invalid original ID table" << std::endl;
+                    return false;
+                }
+                loaded.internalStore[original] = v;
+            }
+        }
+
+        // A converted graph owns everything and lets the file go
+        if (inPlace) {
+            loaded.mapping = file;
+            if (!withCoordinates) {
+                loaded.xCoords = loaded.xStore.data();
+                loaded.yCoords = loaded.yStore.data();
+            }
+        } else {
+            loaded.bindOwnedStorage();
+        }
+        *this = std::move(loaded);
+        return true;
+    }
+
+    // Write the graph in the binary CSR format, in this graph type's layout
+    bool saveBinaryFile(const std::string& filename) const {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot create file " << filename << std::endl;
+            return false;
+        }
+
+        BinaryGraphHeader header;
+        header.nodeCount = nodeCount;
+        header.edgeCount = edgeCount;
+        header.setLayout(EdgeIndexTraits<EdgeIndex>::TYPE, WeightTraits<Weight>::TYPE);
+        if (hasCoordinates()) {
+            header.flags |= BinaryGraphFormat::HAS_COORDINATES;
+        }
+        if (hasOriginalIds()) {
+            header.flags |= BinaryGraphFormat::HAS_ORIGINAL_IDS;
+        }
+        header.payloadBytes = header.expectedPayloadBytes();
+
+        // Sections in file order, each followed by padding to 8 bytes
+        struct Section { const void* data; uint64_t bytes; };
+        std::vector<Section> sections = {
+            {offsets, (uint64_t)(nodeCount + 1) * sizeof(EdgeIndex)},
+            {targets, (uint64_t)edgeCount * sizeof(int32_t)},
+            {weights, (uint64_t)edgeCount * sizeof(Weight)}
+        };
+        if (header.flags & BinaryGraphFormat::HAS_COORDINATES) {
+            sections.push_back({xCoords, (uint64_t)nodeCount * sizeof(double)});
+            sections.push_back({yCoords, (uint64_t)nodeCount * sizeof(double)});
+        }
+        if (header.flags & BinaryGraphFormat::HAS_ORIGINAL_IDS) {
+            sections.push_back({originalStore.data(), (uint64_t)nodeCount * sizeof(int32_t)});
+        }
+
+        const char padding[8] = {0};
+        PayloadChecksum checksum;
+        for (const Section& section : sections) {
+            checksum.update(section.data, section.bytes);
+            uint64_t pad = BinaryGraphFormat::align8(section.bytes) - section.bytes;
+            checksum.update(padding, pad);
+        }
+        header.checksum = checksum.finish();
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const Section& section : sections) {
+            file.write(static_cast<const char*>(section.data), section.bytes);
+            uint64_t pad = BinaryGraphFormat::align8(section.bytes) - section.bytes;
+            file.write(padding, pad);
+        }
+
+        return file.good();
+    }
+
+    // Approximate memory footprint of the CSR arrays in bytes
+    size_t getMemoryBytes() const {
+        return (size_t)(nodeCount + 1) * sizeof(EdgeIndex) +
+               (size_t)edgeCount * (sizeof(int) + sizeof(Weight)) +
+               (size_t)nodeCount * 2 * sizeof(double) +
+               (originalStore.size() + internalStore.size()) * sizeof(int);
+    }
+
+    // Print graph info
+    void printInfo() const {
+        std::cout << "Graph Info:\n";
+        std::cout << "  Nodes: " << nodeCount << "\n";
+        std::cout << "  Edges: " << edgeCount << "\n";
+        std::cout << "  Avg degree: " << (nodeCount > 0 ? (double)edgeCount / nodeCount : 0) << "\n";
+        std::cout << "  CSR memory: " << getMemoryBytes() / 1024 << " KB"
+                  << (isMapped() ? " (memory-mapped)" : "") << "\n";
+        if (EdgeIndexTraits<EdgeIndex>::TYPE != EdgeIndexType::Int32 ||
+            WeightTraits<Weight>::TYPE != WeightType::Float64) {
+            std::cout << "  Layout: " << sizeof(EdgeIndex) * 8 << "-bit edge index, "
+                      << getWeightTypeName(WeightTraits<Weight>::TYPE) << " weights\n";
+        }
+        if (hasOriginalIds()) {
+            std::cout << "  Node IDs: renumbered (queries use the original IDs)\n";
+        }
+    }
+};
+
+// The original layout: int edge indices and double weights
+using CSRGraph = BasicCSRGraph<int, double>;
+
+// Call body((Graph*)nullptr) with the graph type of a layout chosen at
+// runtime, so a tool can instantiate its solvers for exactly that type
+template <typename Body>
+auto withGraphLayout(EdgeIndexType index, WeightType weight, const Body& body) {
+    if (index == EdgeIndexType::UInt64) {
+        switch (weight) {
+            case WeightType::Float32: return body((BasicCSRGraph<uint64_t, float>*)nullptr);
+            case WeightType::UInt32: return body((BasicCSRGraph<uint64_t, uint32_t>*)nullptr);
+            default: return body((BasicCSRGraph<uint64_t, double>*)nullptr);
+        }
+    }
+    switch (weight) {
+        case WeightType::Float32: return body((BasicCSRGraph<int, float>*)nullptr);
+        case WeightType::UInt32: return body((BasicCSRGraph<int, uint32_t>*)nullptr);
+        default: return body((CSRGraph*)nullptr);
+    }
+}
+
+#endif
@@ -0,0 +1,353 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "BinaryGraphFormat.h"
+#include <mpi.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Checkpoints of a distributed run. Each rank keeps the solver state of its
+// own nodes in two slots, <prefix>.<rank>.0 and <prefix>.<rank>.1, in native
+// byte order:
+//
+//   CheckpointHeader                   96 bytes
+//   distances double x ownedCount     (owned slots)
+//   frontier  int32  x frontierCount  (owned slots whose edges still have
+//                                      to be relaxed)
+//
+// Checkpoints are only taken where no update is in flight (right after the
+// exchange of a superstep) and every rank takes number n at the same point.
+// Numbers are never reused, so the n-th files of all ranks form one
+// consistent state: every node off the frontier has relaxed its edges at
+// its current distance, and any superstep solver seeded with the frontiers
+// finishes the search.
+namespace CheckpointFormat {
+    const char MAGIC[8] = {'S', 'S', 'S', 'P', 'C', 'K', 'P', 'T'};
+    const uint32_t VERSION = 2;
+}
+
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t rank;
+    int32_t worldSize;
+    int32_t ownedCount;
+    int32_t frontierCount;
+    int32_t query;
+    uint64_t sequence;
+    uint64_t runHash;
+    uint64_t partitionHash;
+    int32_t iterations;
+    int32_t buckets;
+    int64_t edgesRelaxed;
+    int64_t localUpdates;
+    uint64_t checksum;       // PayloadChecksum of distances and frontier
+    uint64_t queryHash;      // Batch: the queries up to the one being solved
+
+    CheckpointHeader()
+        : version(CheckpointFormat::VERSION), rank(0), worldSize(0), ownedCount(0),
+          frontierCount(0), query(0), sequence(0), runHash(0), partitionHash(0),
+          iterations(0), buckets(0), edgesRelaxed(0), localUpdates(0), checksum(0), queryHash(0) {
+        std::memcpy(magic, CheckpointFormat::MAGIC, sizeof(magic));
+    }
+};
+
+static_assert(sizeof(CheckpointHeader) == 96, "CheckpointHeader must stay 96 bytes");
+
+// One rank's state at a checkpoint
+struct CheckpointState {
+    uint64_t sequence = 0;
+    uint64_t runHash = 0;        // Kind of run and its sources
+    uint64_t partitionHash = 0;  // Graph size and the global IDs of the owned slots
+    int rank = 0;
+    int worldSize = 0;
+    int query = 0;               // Batch position of the query being solved
+    uint64_t queryHash = 0;      // PayloadChecksum of the batch's queries up to it
+    int iterations = 0;          // Solver counters so far
+    int buckets = 0;
+    long long edgesRelaxed = 0;
+    long long localUpdates = 0;
+    std::vector<double> distances;
+    std::vector<int> frontier;
+};
+
+// Writes a rank's checkpoints on a background thread, so the solver only
+// pays for copying its distances. save() is collective: it first waits
+// until the rank's previous checkpoint is on disk and agrees with all
+// ranks that it is, and only then starts overwriting the other slot. A
+// checkpoint that failed on some rank is not confirmed, so the next one
+// goes to the same slot again under a new number. The newest checkpoint
+// complete on every rank therefore always survives a crash, whichever rank
+// dies mid-write.
+//
+// A file is written under a temporary name, synced and renamed, so a slot
+// holds either a whole checkpoint or its previous one.
+class CheckpointWriter {
+private:
+    std::string prefix;
+    int rank;
+    uint64_t nextSequence;
+    int confirmedSlot;            // Slot of the last checkpoint complete everywhere, -1 if none
+    int pendingSlot;              // Slot the writer thread writes
+    CheckpointState pending;      // Owned by the writer thread while it runs
+    std::thread writer;
+    bool writeOk;
+    int written;
+    double stallMs;
+
+    static bool writeAll(int fd, const void* data, size_t bytes) {
+        const char* p = static_cast<const char*>(data);
+        while (bytes > 0) {
+            ssize_t n = ::write(fd, p, bytes);
+            if (n <= 0) {
+                return false;
+            }
+            p += n;
+            bytes -= n;
+        }
+        return true;
+    }
+
+    // Wait for the write in flight; false if it failed
+    bool join() {
+        if (writer.joinable()) {
+            writer.join();
+            return writeOk;
+        }
+        return true;
+    }
+
+    // Collective: true if the last write succeeded on every rank
+    bool confirm() {
+        int localOk = join(), allOk = 0;
+        MPI_Allreduce(&localOk, &allOk, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+        if (!localOk) {
+            std::cerr << "Warning: Rank " << rank << " could not write checkpoint "
+                      << getSlotPath(pendingSlot) << std::endl;
+        }
+        return allOk;
+    }
+
+public:
+    CheckpointWriter(const std::string& filePrefix, int myRank)
+        : prefix(filePrefix), rank(myRank), nextSequence(0), confirmedSlot(-1), pendingSlot(0),
+          writeOk(true), written(0), stallMs(0.0) {}
+
+    ~CheckpointWriter() {
+        join();
+    }
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    std::string getSlotPath(int slot) const {
+        return prefix + "." + std::to_string(rank) + "." + std::to_string(slot);
+    }
+
+    // Collective: hand state over for writing as the next checkpoint. The
+    // buffers of an earlier state are swapped back into state for reuse.
+    // If some rank failed to write the previous checkpoint, this one
+    // replaces it in the same slot, so the slot everyone still has is not
+    // overwritten.
+    void save(CheckpointState& state) {
+        auto start = std::chrono::steady_clock::now();
+        bool previous = writer.joinable();
+        bool ok = confirm();
+        if (previous && ok) {
+            written++;
+            confirmedSlot = pendingSlot;
+        }
+        pendingSlot = (confirmedSlot == 0) ? 1 : 0;
+        state.sequence = nextSequence++;
+        std::swap(pending, state);
+        writer = std::thread([this]() { writeOk = writeFile(getSlotPath(pendingSlot), pending); });
+        stallMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Collective: wait for the last checkpoint; false if any rank failed
+    bool finish() {
+        if (!writer.joinable()) {
+            return true;
+        }
+        bool ok = confirm();
+        if (ok) {
+            written++;
+            confirmedSlot = pendingSlot;
+        }
+        return ok;
+    }
+
+    // Delete this rank's checkpoint files once the run is complete
+    void remove() const {
+        for (int slot = 0; slot < 2; slot++) {
+            ::unlink(getSlotPath(slot).c_str());
+        }
+    }
+
+    // Checkpoints known to be complete on every rank
+    int getWrittenCount() const {
+        return written;
+    }
+
+    // Time save() held up the solver: copying is the caller's, this is
+    // waiting for the previous write and the confirmation
+    double getStallMs() const {
+        return stallMs;
+    }
+
+    static bool writeFile(const std::string& path, const CheckpointState& state) {
+        CheckpointHeader header;
+        header.rank = state.rank;
+        header.worldSize = state.worldSize;
+        header.ownedCount = state.distances.size();
+        header.frontierCount = state.frontier.size();
+        header.query = state.query;
+        header.queryHash = state.queryHash;
+        header.sequence = state.sequence;
+        header.runHash = state.runHash;
+        header.partitionHash = state.partitionHash;
+        header.iterations = state.iterations;
+        header.buckets = state.buckets;
+        header.edgesRelaxed = state.edgesRelaxed;
+        header.localUpdates = state.localUpdates;
+        PayloadChecksum checksum;
+        checksum.update(state.distances.data(), state.distances.size() * sizeof(double));
+        checksum.update(state.frontier.data(), state.frontier.size() * sizeof(int32_t));
+        header.checksum = checksum.finish();
+
+        std::string temporary = path + ".tmp";
+        int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = writeAll(fd, &header, sizeof(header)) &&
+                  writeAll(fd, state.distances.data(), state.distances.size() * sizeof(double)) &&
+                  writeAll(fd, state.frontier.data(), state.frontier.size() * sizeof(int32_t)) &&
+                  ::fsync(fd) == 0;
+        ok = (::close(fd) == 0) && ok;
+        if (!ok || ::rename(temporary.c_str(), path.c_str()) != 0) {
+            ::unlink(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // False if the file is missing, truncated or damaged
+    static bool readFile(const std::string& path, CheckpointState& state) {
+        std::ifstream file(path, std::ios::binary);
+        CheckpointHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, CheckpointFormat::MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != CheckpointFormat::VERSION ||
+            header.ownedCount < 0 || header.frontierCount < 0 || header.frontierCount > header.ownedCount) {
+            return false;
+        }
+        state.distances.resize(header.ownedCount);
+        state.frontier.resize(header.frontierCount);
+        if (!file.read(reinterpret_cast<char*>(state.distances.data()), state.distances.size() * sizeof(double)) ||
+            !file.read(reinterpret_cast<char*>(state.frontier.data()), state.frontier.size() * sizeof(int32_t))) {
+            return false;
+        }
+        PayloadChecksum checksum;
+        checksum.update(state.distances.data(), state.distances.size() * sizeof(double));
+        checksum.update(state.frontier.data(), state.frontier.size() * sizeof(int32_t));
+        if (checksum.finish() != header.checksum) {
+            return false;
+        }
+        for (int slot : state.frontier) {
+            if (slot < 0 || slot >= header.ownedCount) {
+                return false;
+            }
+        }
+        state.sequence = header.sequence;
+        state.runHash = header.runHash;
+        state.partitionHash = header.partitionHash;
+        state.rank = header.rank;
+        state.worldSize = header.worldSize;
+        state.query = header.query;
+        state.queryHash = header.queryHash;
+        state.iterations = header.iterations;
+        state.buckets = header.buckets;
+        state.edgesRelaxed = header.edgesRelaxed;
+        state.localUpdates = header.localUpdates;
+        return true;
+    }
+
+    // Collective: read the newest checkpoint that is complete on every rank
+    // and continue numbering after every number any rank holds, so a
+    // leftover of the crashed run is never mistaken for a new checkpoint.
+    // Fails on every rank if there is none, or if a rank's file belongs to
+    // another run (different sources, graph, partition or process count).
+    // A batch run checks the queries itself against queryHash.
+    bool loadLatest(CheckpointState& state, uint64_t runHash, uint64_t partitionHash, int worldSize) {
+        CheckpointState slots[2];
+        bool valid[2];
+        long long held[2];
+        for (int slot = 0; slot < 2; slot++) {
+            valid[slot] = readFile(getSlotPath(slot), slots[slot]);
+            held[slot] = valid[slot] ? (long long)slots[slot].sequence : -1;
+        }
+        int ranks = 0;
+        MPI_Comm_size(MPI_COMM_WORLD, &ranks);
+        std::vector<long long> allHeld(2 * (size_t)ranks);
+        MPI_Allgather(held, 2, MPI_LONG_LONG, allHeld.data(), 2, MPI_LONG_LONG, MPI_COMM_WORLD);
+
+        // Newest number in a slot of every rank
+        long long common = -1;
+        long long newest = -1;
+        for (int candidate = 0; candidate < 2; candidate++) {
+            long long sequence = allHeld[candidate];
+            bool everywhere = sequence > common;
+            for (int r = 1; r < ranks && everywhere; r++) {
+                everywhere = allHeld[2 * r] == sequence || allHeld[2 * r + 1] == sequence;
+            }
+            if (everywhere) {
+                common = sequence;
+            }
+        }
+        for (long long sequence : allHeld) {
+            newest = std::max(newest, sequence);
+        }
+
+        int found = -1;
+        for (int slot = 0; slot < 2; slot++) {
+            if (valid[slot] && (long long)slots[slot].sequence == common) {
+                found = slot;
+            }
+        }
+        int status = (found < 0) ? 0 : 2;
+        if (found >= 0 && (slots[found].runHash != runHash || slots[found].partitionHash != partitionHash ||
+                           slots[found].worldSize != worldSize || slots[found].rank != rank)) {
+            status = 1;
+        }
+        int globalStatus = 0;
+        MPI_Allreduce(&status, &globalStatus, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+        if (globalStatus < 2) {
+            if (rank == 0) {
+                if (globalStatus == 0) {
+                    std::cerr << "Error: No checkpoint under " << prefix << " is complete on every rank" << std::endl;
+                } else {
+                    std::cerr << "Error: Checkpoint under " << prefix
+                              << " belongs to another run, graph, partition or process count" << std::endl;
+                }
+            }
+            return false;
+        }
+
+        state = std::move(slots[found]);
+        nextSequence = newest + 1;
+        confirmedSlot = found;
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,618 @@
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include "CSRGraph.h"
+#include "SearchSpace.h"
+#include <vector>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+
+// Contraction Hierarchies (Geisberger et al.).
+//
+// Preprocessing removes ("contracts") nodes one at a time in order of
+// importance. When v is removed, every path u -> v -> w between remaining
+// neighbours that is the only shortest u-w path gets a shortcut edge u -> w
+// that remembers v as its middle node. A node's rank is its position in
+// the contraction order.
+//
+// A query then only has to walk upwards in rank: the forward search from s
+// follows edges to higher-ranked nodes, the backward search from t follows
+// incoming edges from higher-ranked nodes, and the shortest path meets at
+// its highest-ranked node. Shortcuts are expanded back into original edges
+// via their middle nodes.
+//
+// File layout (.ch, native endianness, checked by the tag):
+//   CHFileHeader
+//   int    rank[nodeCount]
+//   upward list:   int offsets[nodeCount+1], int nodes[upEdges],
+//                  double weights[upEdges], int middles[upEdges]
+//   downward list: same arrays with downEdges entries
+
+// Edges of one search direction in CSR form. For the upward list,
+// nodes[e] is the head of an edge u -> x with rank[x] > rank[u]; for the
+// downward list the entry at x is the tail of an edge y -> x with
+// rank[y] > rank[x]. middles[e] is -1 for an original edge.
+struct CHEdgeList {
+    std::vector<int> offsets;
+    std::vector<int> nodes;
+    std::vector<double> weights;
+    std::vector<int> middles;
+
+    int begin(int node) const { return offsets[node]; }
+    int end(int node) const { return offsets[node + 1]; }
+    size_t size() const { return nodes.size(); }
+};
+
+struct CHFileHeader {
+    char magic[8];           // "CHIERARC"
+    uint32_t version;
+    uint32_t endianTag;
+    int64_t nodeCount;
+    int64_t sourceEdgeCount; // Edges of the graph the hierarchy was built from
+    uint64_t sourceHash;     // getContentHash() of that graph
+    int64_t upEdges;
+    int64_t downEdges;
+};
+
+// Preprocessing knobs
+struct CHBuildOptions {
+    // Settle limit of a witness search. Stopping early can only miss a
+    // witness, which adds a superfluous shortcut but never a wrong one.
+    int witnessSettleLimit = 100;
+    // Stop contracting once the remaining graph averages more arcs per
+    // node than this (0 = contract everything)
+    double coreDegree = 0.0;
+};
+
+// Preprocessing statistics
+struct CHBuildStats {
+    int coreNodes = 0;
+    long long shortcuts = 0;
+    long long witnessSearches = 0;
+    long long lazyUpdates = 0;
+    double buildMs = 0.0;
+};
+
+class ContractionHierarchy {
+private:
+    static constexpr const char* MAGIC = "CHIERARC";
+    static const uint32_t VERSION = 2;
+    static const uint32_t ENDIAN_TAG = 0x01020304;
+
+    int nodeCount;
+    long long sourceEdgeCount;
+    uint64_t sourceHash;
+    std::vector<int> rank;
+    CHEdgeList upward;
+    CHEdgeList downward;
+
+    // Arc of the graph still being contracted
+    struct Arc {
+        int node;
+        double weight;
+        int middle;
+    };
+
+    // Remaining graph during preprocessing
+    struct WorkGraph {
+        std::vector<std::vector<Arc>> out;
+        std::vector<std::vector<Arc>> in;
+        std::vector<int> deletedNeighbors;
+        std::vector<int> level;  // Depth in the hierarchy built so far
+
+        // Insert u -> w, or lower the weight of an existing u -> w
+        void addArc(int u, int w, double weight, int middle) {
+            for (Arc& arc : out[u]) {
+                if (arc.node == w) {
+                    if (weight < arc.weight) {
+                        arc.weight = weight;
+                        arc.middle = middle;
+                        for (Arc& back : in[w]) {
+                            if (back.node == u) {
+                                back.weight = weight;
+                                back.middle = middle;
+                            }
+                        }
+                    }
+                    return;
+                }
+            }
+            out[u].push_back({w, weight, middle});
+            in[w].push_back({u, weight, middle});
+        }
+    };
+
+    // Shortest distances from source avoiding `skip`, bounded by
+    // maxDistance and settleLimit. Runs on the remaining graph; results are
+    // read back from `space`.
+    static void witnessSearch(const WorkGraph& work, SearchSpace<BinaryHeapQueue>& space,
+                              int source, int skip, double maxDistance, int settleLimit) {
+        space.prepare(work.out.size());
+        space.label(source, 0.0, -1);
+        space.pq.push(source, 0.0);
+        int settled = 0;
+
+        while (!space.pq.empty() && settled < settleLimit) {
+            int u = space.pq.pop();
+            if (space.isSettled(u)) {
+                continue;
+            }
+            space.settle(u);
+            settled++;
+            double distU = space.getDistance(u);
+            if (distU > maxDistance) {
+                break;
+            }
+            for (const Arc& arc : work.out[u]) {
+                if (arc.node == skip) {
+                    continue;
+                }
+                double newDist = distU + arc.weight;
+                if (newDist < space.getDistance(arc.node)) {
+                    space.label(arc.node, newDist, u);
+                    space.pq.push(arc.node, newDist);
+                }
+            }
+        }
+    }
+
+    // Shortcuts needed to contract v (node = tail, middle = head)
+    static void findShortcuts(const WorkGraph& work, SearchSpace<BinaryHeapQueue>& space, int v,
+                              int settleLimit, std::vector<Arc>& shortcuts, CHBuildStats& stats) {
+        shortcuts.clear();
+        double maxOut = 0.0;
+        for (const Arc& out : work.out[v]) {
+            maxOut = std::max(maxOut, out.weight);
+        }
+
+        for (const Arc& in : work.in[v]) {
+            int u = in.node;
+            witnessSearch(work, space, u, v, in.weight + maxOut, settleLimit);
+            stats.witnessSearches++;
+
+            for (const Arc& out : work.out[v]) {
+                int w = out.node;
+                double viaV = in.weight + out.weight;
+                if (w != u && space.getDistance(w) > viaV) {
+                    shortcuts.push_back({u, viaV, w});
+                }
+            }
+        }
+    }
+
+    // Edge difference plus deleted neighbours: prefers nodes whose removal
+    // adds few shortcuts, and spreads contraction evenly over the graph
+    static int computePriority(const WorkGraph& work, int v, size_t shortcutCount) {
+        int degree = work.in[v].size() + work.out[v].size();
+        return 2 * ((int)shortcutCount - degree) + work.deletedNeighbors[v] + work.level[v];
+    }
+
+    // Drop every arc that points at v
+    static void removeArcsTo(std::vector<Arc>& arcs, int v) {
+        arcs.erase(std::remove_if(arcs.begin(), arcs.end(),
+                                  [v](const Arc& arc) { return arc.node == v; }),
+                   arcs.end());
+    }
+
+    // Pack per-node edge lists into CSR
+    static void buildEdgeList(CHEdgeList& list, const std::vector<std::vector<Arc>>& arcs) {
+        list.offsets.assign(arcs.size() + 1, 0);
+        for (size_t u = 0; u < arcs.size(); u++) {
+            list.offsets[u + 1] = list.offsets[u] + arcs[u].size();
+        }
+        list.nodes.clear();
+        list.weights.clear();
+        list.middles.clear();
+        for (const std::vector<Arc>& nodeArcs : arcs) {
+            for (const Arc& arc : nodeArcs) {
+                list.nodes.push_back(arc.node);
+                list.weights.push_back(arc.weight);
+                list.middles.push_back(arc.middle);
+            }
+        }
+    }
+
+    // Middle node of the hierarchy edge a -> b (lightest if parallel)
+    int findMiddle(int a, int b) const {
+        const CHEdgeList& list = (rank[a] < rank[b]) ? upward : downward;
+        int at = (rank[a] < rank[b]) ? a : b;
+        int other = (rank[a] < rank[b]) ? b : a;
+        int middle = -1;
+        double best = std::numeric_limits<double>::infinity();
+        for (int e = list.begin(at); e < list.end(at); e++) {
+            if (list.nodes[e] == other && list.weights[e] < best) {
+                best = list.weights[e];
+                middle = list.middles[e];
+            }
+        }
+        return middle;
+    }
+
+    // Append the original nodes of hierarchy edge a -> b, excluding a
+    void unpackEdge(int a, int b, std::vector<int>& path) const {
+        int middle = findMiddle(a, b);
+        if (middle == -1) {
+            path.push_back(b);
+            return;
+        }
+        unpackEdge(a, middle, path);
+        unpackEdge(middle, b, path);
+    }
+
+    template <typename T>
+    static void writeArray(std::ofstream& file, const std::vector<T>& values) {
+        file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    template <typename T>
+    static bool readArray(std::ifstream& file, std::vector<T>& values, size_t count) {
+        values.resize(count);
+        file.read(reinterpret_cast<char*>(values.data()), count * sizeof(T));
+        return (bool)file;
+    }
+
+    static bool readEdgeList(std::ifstream& file, CHEdgeList& list, int nodes, size_t edges) {
+        if (!readArray(file, list.offsets, nodes + 1) || !readArray(file, list.nodes, edges) ||
+            !readArray(file, list.weights, edges) || !readArray(file, list.middles, edges)) {
+            return false;
+        }
+        return list.offsets[0] == 0 && (size_t)list.offsets[nodes] == edges;
+    }
+
+public:
+    ContractionHierarchy() : nodeCount(0), sourceEdgeCount(0), sourceHash(0) {}
+
+    // Order and contract the nodes of a graph. Contraction stops early once
+    // the remaining graph averages more than options.coreDegree arcs per
+    // node; those core nodes keep all their edges among each other and rank
+    // above every contracted node, so queries finish with a plain
+    // bidirectional search inside the core.
+    static ContractionHierarchy build(const CSRGraph& graph, const CHBuildOptions& options,
+                                      CHBuildStats& stats) {
+        ContractionHierarchy ch;
+        int n = graph.getNodeCount();
+        ch.nodeCount = n;
+        ch.sourceEdgeCount = graph.getEdgeCount();
+        ch.sourceHash = graph.getContentHash();
+        ch.rank.assign(n, -1);
+
+        // Parallel edges collapse to the lightest one; self loops never
+        // lie on a shortest path
+        WorkGraph work;
+        work.out.resize(n);
+        work.in.resize(n);
+        work.deletedNeighbors.assign(n, 0);
+        work.level.assign(n, 0);
+        for (int u = 0; u < n; u++) {
+            for (int e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+                if (graph.getTarget(e) != u) {
+                    work.addArc(u, graph.getTarget(e), graph.getWeight(e), -1);
+                }
+            }
+        }
+        long long remainingArcs = 0;
+        for (int u = 0; u < n; u++) {
+            remainingArcs += work.out[u].size();
+        }
+
+        SearchSpace<BinaryHeapQueue> space;
+        std::vector<Arc> shortcuts;
+        DaryHeapQueue<4> order;
+        order.init(n);
+        for (int v = 0; v < n; v++) {
+            findShortcuts(work, space, v, options.witnessSettleLimit, shortcuts, stats);
+            order.push(v, computePriority(work, v, shortcuts.size()));
+        }
+
+        // Final edges of every node, split by direction, collected as the
+        // node is contracted (all remaining neighbours rank higher)
+        std::vector<std::vector<Arc>> up(n), down(n);
+
+        int nextRank = 0;
+        while (!order.empty()) {
+            int remaining = n - nextRank;
+            if (options.coreDegree > 0 && remainingArcs > options.coreDegree * remaining) {
+                break;
+            }
+
+            // Lazy update: re-evaluate the best candidate, and put it back if
+            // it is no longer the minimum
+            int v = order.pop();
+            findShortcuts(work, space, v, options.witnessSettleLimit, shortcuts, stats);
+            int priority = computePriority(work, v, shortcuts.size());
+            if (!order.empty() && priority > order.minKey()) {
+                order.push(v, priority);
+                stats.lazyUpdates++;
+                continue;
+            }
+
+            // Neighbours lose their arcs to v; v keeps them as final edges
+            for (const Arc& arc : work.out[v]) {
+                removeArcsTo(work.in[arc.node], v);
+                work.deletedNeighbors[arc.node]++;
+                work.level[arc.node] = std::max(work.level[arc.node], work.level[v] + 1);
+            }
+            for (const Arc& arc : work.in[v]) {
+                removeArcsTo(work.out[arc.node], v);
+                work.deletedNeighbors[arc.node]++;
+                work.level[arc.node] = std::max(work.level[arc.node], work.level[v] + 1);
+            }
+            remainingArcs -= work.out[v].size() + work.in[v].size();
+            up[v].swap(work.out[v]);
+            down[v].swap(work.in[v]);
+
+            for (const Arc& shortcut : shortcuts) {
+                size_t before = work.out[shortcut.node].size();
+                work.addArc(shortcut.node, shortcut.middle, shortcut.weight, v);
+                remainingArcs += work.out[shortcut.node].size() - before;
+            }
+            stats.shortcuts += shortcuts.size();
+            ch.rank[v] = nextRank++;
+        }
+
+        // Core: rank what is left on top, and keep every core arc in both
+        // lists so either search can cross the core in any direction
+        stats.coreNodes = n - nextRank;
+        for (int v = 0; v < n; v++) {
+            if (ch.rank[v] == -1) {
+                ch.rank[v] = nextRank++;
+                up[v] = work.out[v];
+                down[v] = work.in[v];
+            }
+        }
+
+        buildEdgeList(ch.upward, up);
+        buildEdgeList(ch.downward, down);
+        return ch;
+    }
+
+    int getNodeCount() const { return nodeCount; }
+    long long getSourceEdgeCount() const { return sourceEdgeCount; }
+    size_t getUpwardEdgeCount() const { return upward.size(); }
+    size_t getDownwardEdgeCount() const { return downward.size(); }
+    int getRank(int node) const { return rank[node]; }
+
+    // A hierarchy only answers correctly for the graph it was built from
+    template <typename Graph>
+    bool matches(const Graph& graph) const {
+        return nodeCount == graph.getNodeCount() && sourceEdgeCount == (long long)graph.getEdgeCount() &&
+               sourceHash == graph.getContentHash();
+    }
+
+    size_t getMemoryBytes() const {
+        size_t edges = upward.size() + downward.size();
+        return rank.size() * sizeof(int) + 2 * (nodeCount + 1) * sizeof(int) +
+               edges * (2 * sizeof(int) + sizeof(double));
+    }
+
+    // Bidirectional upward search. Each side stops once its smallest key
+    // reaches the best meeting distance. A node is stalled (its edges are
+    // not relaxed) if a higher-ranked neighbour already proves a shorter
+    // distance to it, which prunes most of the upward search space.
+    template <typename Queue>
+    PathResult query(SearchSpace<Queue>& forward, SearchSpace<Queue>& backward,
+                     int source, int destination) const {
+        const double INF = std::numeric_limits<double>::infinity();
+        PathResult result;
+        SearchStats& stats = result.stats;
+
+        forward.prepare(nodeCount);
+        backward.prepare(nodeCount);
+        forward.label(source, 0.0, -1);
+        backward.label(destination, 0.0, -1);
+        forward.pq.push(source, 0.0);
+        backward.pq.push(destination, 0.0);
+        stats.heapPushes += 2;
+
+        // Index 0 searches upward edges, index 1 incoming upward edges
+        SearchSpace<Queue>* space[2] = {&forward, &backward};
+        const CHEdgeList* relaxList[2] = {&upward, &downward};
+        const CHEdgeList* stallList[2] = {&downward, &upward};
+
+        double best = INF;
+        int meetNode = -1;
+        bool active[2] = {true, true};
+        int d = 1;
+
+        while (active[0] || active[1]) {
+            // Alternate between the sides that are still running
+            d = active[1 - d] ? 1 - d : d;
+            SearchSpace<Queue>& current = *space[d];
+            const SearchSpace<Queue>& other = *space[1 - d];
+
+            if (current.pq.empty() || current.pq.minKey() >= best) {
+                active[d] = false;
+                continue;
+            }
+
+            stats.maxQueueSize = std::max(stats.maxQueueSize,
+                                          (long long)(forward.pq.size() + backward.pq.size()));
+            int u = current.pq.pop();
+            if (current.isSettled(u)) {
+                stats.stalePops++;
+                continue;
+            }
+            current.settle(u);
+            stats.nodesSettled++;
+
+            double distU = current.getDistance(u);
+            double otherDist = other.getDistance(u);
+            if (otherDist != INF && distU + otherDist < best) {
+                best = distU + otherDist;
+                meetNode = u;
+            }
+
+            // Stall-on-demand
+            const CHEdgeList& stall = *stallList[d];
+            bool stalled = false;
+            for (int e = stall.begin(u); e < stall.end(u) && !stalled; e++) {
+                stalled = current.getDistance(stall.nodes[e]) + stall.weights[e] < distU;
+            }
+            if (stalled) {
+                continue;
+            }
+
+            const CHEdgeList& list = *relaxList[d];
+            for (int e = list.begin(u); e < list.end(u); e++) {
+                int v = list.nodes[e];
+                double newDist = distU + list.weights[e];
+                stats.edgesRelaxed++;
+                if (newDist < current.getDistance(v)) {
+                    current.label(v, newDist, u);
+                    if (current.pq.push(v, newDist)) {
+                        stats.heapPushes++;
+                    } else {
+                        stats.decreaseKeys++;
+                    }
+                }
+            }
+        }
+
+        if (meetNode != -1) {
+            result.found = true;
+            result.totalDistance = best;
+
+            // Hierarchy path source -> meet -> destination, then expand
+            // every shortcut into original edges
+            std::vector<int> hierarchyPath;
+            forward.buildPath(result, meetNode);
+            hierarchyPath.swap(result.path);
+            for (int node = backward.getPredecessor(meetNode); node != -1;
+                 node = backward.getPredecessor(node)) {
+                hierarchyPath.push_back(node);
+            }
+
+            result.path.push_back(hierarchyPath[0]);
+            for (size_t i = 1; i < hierarchyPath.size(); i++) {
+                unpackEdge(hierarchyPath[i - 1], hierarchyPath[i], result.path);
+            }
+        }
+        return result;
+    }
+
+    // Exhaustive upward search from root without a target: forward walks
+    // upward edges, backward walks incoming upward edges. visit(node,
+    // distance) is called for every settled node that is not stalled;
+    // stalled nodes carry no shortest distance and are skipped. Returns the
+    // number of settled nodes. Many-to-many tables are built from these
+    // searches (see DistanceMatrix.h).
+    template <typename Queue, typename Visitor>
+    long long upwardSearch(SearchSpace<Queue>& space, int root, bool backward,
+                           const Visitor& visit) const {
+        const CHEdgeList& relax = backward ? downward : upward;
+        const CHEdgeList& stall = backward ? upward : downward;
+        long long settled = 0;
+
+        space.prepare(nodeCount);
+        space.label(root, 0.0, -1);
+        space.pq.push(root, 0.0);
+
+        while (!space.pq.empty()) {
+            int u = space.pq.pop();
+            if (space.isSettled(u)) {
+                continue;
+            }
+            space.settle(u);
+            settled++;
+
+            double distU = space.getDistance(u);
+            bool stalled = false;
+            for (int e = stall.begin(u); e < stall.end(u) && !stalled; e++) {
+                stalled = space.getDistance(stall.nodes[e]) + stall.weights[e] < distU;
+            }
+            if (stalled) {
+                continue;
+            }
+            visit(u, distU);
+
+            for (int e = relax.begin(u); e < relax.end(u); e++) {
+                int v = relax.nodes[e];
+                double newDist = distU + relax.weights[e];
+                if (newDist < space.getDistance(v)) {
+                    space.label(v, newDist, u);
+                    space.pq.push(v, newDist);
+                }
+            }
+        }
+        return settled;
+    }
+
+    bool saveToFile(const std::string& filename) const {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot create file " << filename << std::endl;
+            return false;
+        }
+
+        CHFileHeader header;
+        std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.version = VERSION;
+        header.endianTag = ENDIAN_TAG;
+        header.nodeCount = nodeCount;
+        header.sourceEdgeCount = sourceEdgeCount;
+        header.sourceHash = sourceHash;
+        header.upEdges = upward.size();
+        header.downEdges = downward.size();
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        writeArray(file, rank);
+        for (const CHEdgeList* list : {&upward, &downward}) {
+            writeArray(file, list->offsets);
+            writeArray(file, list->nodes);
+            writeArray(file, list->weights);
+            writeArray(file, list->middles);
+        }
+
+        if (!file) {
+            std::cerr << "Error: Failed writing " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool loadFromFile(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot open file " << filename << std::endl;
+            return false;
+        }
+
+        CHFileHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file || std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0) {
+            std::cerr << "Error: " << filename << " is not a contraction hierarchy" << std::endl;
+            return false;
+        }
+        if (header.endianTag != ENDIAN_TAG || header.version != VERSION) {
+            std::cerr << "Error: Unsupported hierarchy version or byte order in "
+                      << filename << std::endl;
+            return false;
+        }
+
+        nodeCount = header.nodeCount;
+        sourceEdgeCount = header.sourceEdgeCount;
+        sourceHash = header.sourceHash;
+        if (!readArray(file, rank, nodeCount) ||
+            !readEdgeList(file, upward, nodeCount, header.upEdges) ||
+            !readEdgeList(file, downward, nodeCount, header.downEdges)) {
+            std::cerr << "Error: Truncated or corrupt hierarchy file " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void printInfo() const {
+        std::cout << "Hierarchy Statistics:\n";
+        std::cout << "  Nodes: " << nodeCount << "\n";
+        std::cout << "  Upward edges: " << upward.size() << "\n";
+        std::cout << "  Downward edges: " << downward.size() << "\n";
+        std::cout << "  Memory: " << getMemoryBytes() / 1024 << " KB\n";
+    }
+};
+
+#endif
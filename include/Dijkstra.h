@@ -0,0 +1,450 @@
+#ifndef DIJKSTRA_H
+#define DIJKSTRA_H
+
+#include "CSRGraph.h"
+#include "SearchSpace.h"
+#include "ContractionHierarchy.h"
+#include "Landmarks.h"
+#include "PathTreeCache.h"
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+// Point-to-point shortest path solvers over a read-only CSRGraph.
+//
+// The graph is never modified by a search, so any number of solvers may
+// share one graph. All mutable state lives in a SearchSpace, which belongs
+// to exactly one solver (and therefore one thread) at a time. The solvers
+// are templates over the graph type, so every BasicCSRGraph layout gets its
+// own relaxation loop; distances are always accumulated in double.
+
+// Sequential Dijkstra's Algorithm
+template <typename Queue, typename Graph>
+PathResult sequentialDijkstra(const Graph& graph, SearchSpace<Queue>& space,
+                              int source, int destination) {
+    PathResult result;
+    SearchStats& stats = result.stats;
+
+    // Invalidate the labels left by the previous query
+    space.prepare(graph.getNodeCount());
+    Queue& pq = space.pq;
+
+    // Start from source
+    space.label(source, 0.0, -1);
+    pq.push(source, 0.0);
+    stats.heapPushes++;
+
+    while (!pq.empty()) {
+        stats.maxQueueSize = std::max(stats.maxQueueSize, (long long)pq.size());
+        int currentNode = pq.pop();
+
+        // Skip if already visited (stale entry of a lazy queue)
+        if (space.isSettled(currentNode)) {
+            stats.stalePops++;
+            continue;
+        }
+
+        space.settle(currentNode);
+        stats.nodesSettled++;
+
+        // Early termination if destination reached
+        if (currentNode == destination) {
+            break;
+        }
+
+        // Explore neighbors
+        double currentDistance = space.getDistance(currentNode);
+        auto edgeEnd = graph.edgeEnd(currentNode);
+
+        for (auto e = graph.edgeBegin(currentNode); e < edgeEnd; e++) {
+            int neighbor = graph.getTarget(e);
+            double newDistance = currentDistance + graph.getWeight(e);
+            stats.edgesRelaxed++;
+
+            // Relaxation step
+            if (newDistance < space.getDistance(neighbor)) {
+                space.label(neighbor, newDistance, currentNode);
+                if (pq.push(neighbor, newDistance)) {
+                    stats.heapPushes++;
+                } else {
+                    stats.decreaseKeys++;
+                }
+            }
+        }
+    }
+
+    if (space.isSettled(destination)) {
+        result.found = true;
+        result.totalDistance = space.getDistance(destination);
+        space.buildPath(result, destination);
+    }
+    return result;
+}
+
+// One-to-all Dijkstra from one or more sources, run until the queue is
+// empty. Afterwards space.getDistance(v) is the distance from v's nearest
+// source (infinity if unreachable) for every node.
+template <typename Queue, typename Graph>
+SearchStats oneToAllDijkstra(const Graph& graph, SearchSpace<Queue>& space,
+                             const std::vector<int>& sources) {
+    SearchStats stats;
+    space.prepare(graph.getNodeCount());
+    Queue& pq = space.pq;
+
+    for (int source : sources) {
+        if (space.getDistance(source) > 0.0) {
+            space.label(source, 0.0, -1);
+            pq.push(source, 0.0);
+            stats.heapPushes++;
+        }
+    }
+
+    while (!pq.empty()) {
+        stats.maxQueueSize = std::max(stats.maxQueueSize, (long long)pq.size());
+        int currentNode = pq.pop();
+
+        if (space.isSettled(currentNode)) {
+            stats.stalePops++;
+            continue;
+        }
+        space.settle(currentNode);
+        stats.nodesSettled++;
+
+        double currentDistance = space.getDistance(currentNode);
+        auto edgeEnd = graph.edgeEnd(currentNode);
+        for (auto e = graph.edgeBegin(currentNode); e < edgeEnd; e++) {
+            int neighbor = graph.getTarget(e);
+            double newDistance = currentDistance + graph.getWeight(e);
+            stats.edgesRelaxed++;
+
+            if (newDistance < space.getDistance(neighbor)) {
+                space.label(neighbor, newDistance, currentNode);
+                if (pq.push(neighbor, newDistance)) {
+                    stats.heapPushes++;
+                } else {
+                    stats.decreaseKeys++;
+                }
+            }
+        }
+    }
+    return stats;
+}
+
+// A* heuristics: callables giving a lower bound on the distance a -> b
+template <typename Graph>
+struct EuclideanHeuristic {
+    const Graph& graph;
+    double operator()(int from, int to) const { return graph.getHeuristic(from, to); }
+};
+
+template <typename Graph>
+EuclideanHeuristic(const Graph&) -> EuclideanHeuristic<Graph>;
+
+struct LandmarkHeuristic {
+    const LandmarkSet& landmarks;
+    double operator()(int from, int to) const { return landmarks.lowerBound(from, to); }
+};
+
+// Sequential Dijkstra with A* heuristic
+template <typename Queue, typename Graph, typename Heuristic>
+PathResult sequentialAStarDijkstra(const Graph& graph, SearchSpace<Queue>& space,
+                                   int source, int destination, const Heuristic& heuristic) {
+    PathResult result;
+    SearchStats& stats = result.stats;
+
+    // Invalidate the labels left by the previous query
+    space.prepare(graph.getNodeCount());
+    Queue& pq = space.pq;
+
+    // Start from source
+    space.label(source, 0.0, -1);
+    pq.push(source, heuristic(source, destination));
+    stats.heapPushes++;
+
+    while (!pq.empty()) {
+        stats.maxQueueSize = std::max(stats.maxQueueSize, (long long)pq.size());
+        int currentNode = pq.pop();
+
+        // Skip if already visited (stale entry of a lazy queue)
+        if (space.isSettled(currentNode)) {
+            stats.stalePops++;
+            continue;
+        }
+
+        space.settle(currentNode);
+        stats.nodesSettled++;
+
+        // Early termination if destination reached
+        if (currentNode == destination) {
+            break;
+        }
+
+        // Explore neighbors
+        double currentDistance = space.getDistance(currentNode);
+        auto edgeEnd = graph.edgeEnd(currentNode);
+
+        for (auto e = graph.edgeBegin(currentNode); e < edgeEnd; e++) {
+            int neighbor = graph.getTarget(e);
+            double newDistance = currentDistance + graph.getWeight(e);
+            stats.edgesRelaxed++;
+
+            // Relaxation step
+            if (newDistance < space.getDistance(neighbor)) {
+                space.label(neighbor, newDistance, currentNode);
+
+                // Calculate f-score: g(n) + h(n)
+                double fScore = newDistance + heuristic(neighbor, destination);
+
+                if (pq.push(neighbor, fScore)) {
+                    stats.heapPushes++;
+                } else {
+                    stats.decreaseKeys++;
+                }
+            }
+        }
+    }
+
+    if (space.isSettled(destination)) {
+        result.found = true;
+        result.totalDistance = space.getDistance(destination);
+        space.buildPath(result, destination);
+    }
+    return result;
+}
+
+// Bidirectional Dijkstra / A*.
+// A forward search from the source over the graph and a backward search
+// from the destination over the reverse graph run alternately, always
+// advancing the side with the smaller queue key. Every relaxed edge that
+// reaches a node labelled by the other side gives a candidate path length
+// mu; the search stops once minKeyForward + minKeyBackward >= mu, at which
+// point no undiscovered path can be shorter.
+//
+// With A* both sides use the average potential
+//     pf(v) = (h(v, t) - h(s, v)) / 2,   pb(v) = -pf(v)
+// which keeps the two reduced-cost searches consistent with each other,
+// so the same stopping rule applies to the keys dist + potential.
+template <typename Queue, typename Graph, typename Heuristic>
+PathResult bidirectionalDijkstra(const Graph& graph, const Graph& reverse,
+                                 SearchSpace<Queue>& forward, SearchSpace<Queue>& backward,
+                                 int source, int destination, bool useAStar,
+                                 const Heuristic& heuristic) {
+    const double INF = std::numeric_limits<double>::infinity();
+    PathResult result;
+    SearchStats& stats = result.stats;
+    int nodeCount = graph.getNodeCount();
+
+    auto potential = [&](int node) {
+        if (!useAStar) {
+            return 0.0;
+        }
+        return 0.5 * (heuristic(node, destination) - heuristic(source, node));
+    };
+
+    // Index 0 is the forward search, index 1 the backward search
+    const Graph* side[2] = {&graph, &reverse};
+    SearchSpace<Queue>* space[2] = {&forward, &backward};
+    for (int d = 0; d < 2; d++) {
+        space[d]->prepare(nodeCount);
+    }
+
+    forward.label(source, 0.0, -1);
+    backward.label(destination, 0.0, -1);
+    forward.pq.push(source, potential(source));
+    backward.pq.push(destination, -potential(destination));
+    stats.heapPushes += 2;
+
+    double best = (source == destination) ? 0.0 : INF;
+    int meetNode = (source == destination) ? source : -1;
+
+    while (!forward.pq.empty() && !backward.pq.empty()) {
+        double forwardKey = forward.pq.minKey();
+        double backwardKey = backward.pq.minKey();
+        if (forwardKey + backwardKey >= best) {
+            break;
+        }
+
+        int d = (forwardKey <= backwardKey) ? 0 : 1;
+        double sign = (d == 0) ? 1.0 : -1.0;
+        SearchSpace<Queue>& current = *space[d];
+        const SearchSpace<Queue>& other = *space[1 - d];
+        stats.maxQueueSize = std::max(stats.maxQueueSize,
+                                      (long long)(forward.pq.size() + backward.pq.size()));
+        int currentNode = current.pq.pop();
+
+        // Skip if already visited (stale entry of a lazy queue)
+        if (current.isSettled(currentNode)) {
+            stats.stalePops++;
+            continue;
+        }
+
+        current.settle(currentNode);
+        stats.nodesSettled++;
+
+        // Explore neighbors in this direction
+        const Graph& g = *side[d];
+        double currentDistance = current.getDistance(currentNode);
+        auto edgeEnd = g.edgeEnd(currentNode);
+
+        for (auto e = g.edgeBegin(currentNode); e < edgeEnd; e++) {
+            int neighbor = g.getTarget(e);
+            double newDistance = currentDistance + g.getWeight(e);
+            stats.edgesRelaxed++;
+
+            // Relaxation step
+            if (newDistance < current.getDistance(neighbor)) {
+                current.label(neighbor, newDistance, currentNode);
+                if (current.pq.push(neighbor, newDistance + sign * potential(neighbor))) {
+                    stats.heapPushes++;
+                } else {
+                    stats.decreaseKeys++;
+                }
+            }
+
+            // Meet in the middle
+            double otherDistance = other.getDistance(neighbor);
+            if (otherDistance != INF && newDistance + otherDistance < best) {
+                best = newDistance + otherDistance;
+                meetNode = neighbor;
+            }
+        }
+    }
+
+    if (meetNode != -1) {
+        result.found = true;
+        result.totalDistance = best;
+
+        // Source -> meet from the forward tree, meet -> destination from
+        // the backward tree (whose predecessors are successors in the graph)
+        forward.buildPath(result, meetNode);
+        for (int node = backward.getPredecessor(meetNode); node != -1; node = backward.getPredecessor(node)) {
+            result.path.push_back(node);
+        }
+    }
+    return result;
+}
+
+// Search configuration from the command line
+struct SearchOptions {
+    bool useAStar = false;
+    bool bidirectional = false;
+    QueuePolicy policy = QueuePolicy::Binary;
+    const ContractionHierarchy* hierarchy = nullptr;  // Answer with CH if set
+    const LandmarkSet* landmarks = nullptr;           // ALT bounds for A* if set
+    PathTreeCache* treeCache = nullptr;               // Answer repeated sources from trees if set
+
+    // Trees come from plain Dijkstra, so they stand in only for the
+    // one-directional searches (Dijkstra and A*, whose distances are the
+    // same); bidirectional and CH queries sum their paths differently and
+    // would change in the last digits
+    bool usesTreeCache() const {
+        return treeCache && !hierarchy && !bidirectional;
+    }
+};
+
+// Point-to-point solver that keeps its scratch state between queries.
+// One instance per thread; the graphs are shared.
+template <typename Queue, typename Graph = CSRGraph>
+class QuerySolver {
+private:
+    const Graph& graph;
+    const Graph* reverse;  // Only for bidirectional search
+    SearchOptions options;
+    SearchSpace<Queue> forward;
+    SearchSpace<Queue> backward;
+
+    // Answer from the cached tree of source, building it if the cache
+    // admits the source; false if the query has to be searched
+    bool solveFromTree(int source, int destination, PathResult& result) {
+        PathTreeCache& cache = *options.treeCache;
+        bool admit;
+        std::shared_ptr<const PathTree> tree = cache.find(source, admit);
+        if (!tree) {
+            if (!admit) {
+                return false;
+            }
+            uint64_t version = cache.getVersion();
+            result.stats = oneToAllDijkstra(graph, forward, std::vector<int>{source});
+            auto built = std::make_shared<PathTree>();
+            built->source = source;
+            built->predecessors.resize(graph.getNodeCount());
+            for (int v = 0; v < graph.getNodeCount(); v++) {
+                built->predecessors[v] = forward.getPredecessor(v);
+            }
+            cache.insert(built, version);
+            tree = built;
+        }
+
+        if (destination != source && tree->predecessors[destination] < 0) {
+            return true;
+        }
+        for (int node = destination; node != -1; node = tree->predecessors[node]) {
+            result.path.push_back(node);
+        }
+        std::reverse(result.path.begin(), result.path.end());
+
+        // Dijkstra reached each node over the lightest parallel edge from
+        // its predecessor; summing in path order reproduces its distance
+        double distance = 0.0;
+        for (size_t i = 0; i + 1 < result.path.size(); i++) {
+            int u = result.path[i];
+            double lightest = std::numeric_limits<double>::infinity();
+            for (auto e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+                if (graph.getTarget(e) == result.path[i + 1]) {
+                    lightest = std::min(lightest, (double)graph.getWeight(e));
+                }
+            }
+            distance = distance + lightest;
+        }
+        result.found = true;
+        result.totalDistance = distance;
+        return true;
+    }
+
+    // Answer in internal IDs
+    PathResult solveInternal(int source, int destination) {
+        PathResult cached;
+        if (options.usesTreeCache() && solveFromTree(source, destination, cached)) {
+            return cached;
+        }
+        if (options.hierarchy) {
+            return options.hierarchy->query(forward, backward, source, destination);
+        }
+        if (options.landmarks) {
+            LandmarkHeuristic heuristic{*options.landmarks};
+            if (options.bidirectional) {
+                return bidirectionalDijkstra(graph, *reverse, forward, backward,
+                                             source, destination, options.useAStar, heuristic);
+            }
+            return sequentialAStarDijkstra(graph, forward, source, destination, heuristic);
+        }
+        EuclideanHeuristic heuristic{graph};
+        if (options.bidirectional) {
+            return bidirectionalDijkstra(graph, *reverse, forward, backward,
+                                         source, destination, options.useAStar, heuristic);
+        }
+        if (options.useAStar) {
+            return sequentialAStarDijkstra(graph, forward, source, destination, heuristic);
+        }
+        return sequentialDijkstra(graph, forward, source, destination);
+    }
+
+public:
+    QuerySolver(const Graph& g, const Graph* reverseGraph, const SearchOptions& searchOptions)
+        : graph(g), reverse(reverseGraph), options(searchOptions) {}
+
+    // Source, destination and path are in the graph's original IDs, so a
+    // renumbered graph answers exactly like the file it was built from
+    PathResult solve(int source, int destination) {
+        if (!graph.hasOriginalIds()) {
+            return solveInternal(source, destination);
+        }
+        PathResult result = solveInternal(graph.getInternalId(source), graph.getInternalId(destination));
+        for (int& node : result.path) {
+            node = graph.getOriginalId(node);
+        }
+        return result;
+    }
+};
+
+#endif
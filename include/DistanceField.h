@@ -0,0 +1,309 @@
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+#include <vector>
+#include <string>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+
+// One-to-all (or multi-source) distance field on disk, native byte order:
+//
+//   DistanceFieldHeader                    64 bytes
+//   sources  int32 x sourceCount          (padded to 8 bytes)
+//   values   nodeCount entries, one per node in ID order
+//
+// Values are encoded in one of three ways:
+//   double  8 bytes, +inf if unreachable
+//   float   4 bytes, +inf if unreachable; half the size, ~7 significant digits
+//   fixed   4 bytes, unsigned round(distance * scale). UNREACHABLE (all ones)
+//           marks unreachable nodes, and larger distances saturate one below
+//           it. The scale is stored in the header.
+// Encoding runs over flat blocks of doubles in branch-free loops that the
+// compiler vectorises, so writing a field costs little more than the copy.
+enum class DistanceEncoding {
+    Float64,
+    Float32,
+    Fixed32
+};
+
+inline bool parseDistanceEncoding(const std::string& name, DistanceEncoding& encoding) {
+    if (name == "double") {
+        encoding = DistanceEncoding::Float64;
+    } else if (name == "float") {
+        encoding = DistanceEncoding::Float32;
+    } else if (name == "fixed") {
+        encoding = DistanceEncoding::Fixed32;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline const char* getDistanceEncodingName(DistanceEncoding encoding) {
+    switch (encoding) {
+        case DistanceEncoding::Float32: return "float";
+        case DistanceEncoding::Fixed32: return "fixed";
+        default: return "double";
+    }
+}
+
+inline size_t getDistanceEncodingBytes(DistanceEncoding encoding) {
+    return encoding == DistanceEncoding::Float64 ? sizeof(double) : sizeof(uint32_t);
+}
+
+namespace DistanceFieldFormat {
+    const char MAGIC[8] = {'S', 'S', 'S', 'P', 'D', 'I', 'S', 'T'};
+    const uint32_t VERSION = 1;
+    const uint32_t UNREACHABLE = 0xffffffffu;  // Fixed-point value of an unreachable node
+    const uint32_t MAX_FIXED = UNREACHABLE - 1;
+
+    // Largest scale that keeps maxDistance representable in fixed point
+    // (one unit of headroom for rounding)
+    inline double chooseFixedScale(double maxDistance) {
+        return maxDistance > 0.0 ? (MAX_FIXED - 1) / maxDistance : 1.0;
+    }
+}
+
+struct DistanceFieldHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t encoding;     // DistanceEncoding
+    uint64_t nodeCount;
+    uint64_t sourceCount;
+    double scale;          // Fixed point only: stored value = distance * scale
+    uint64_t reserved[3];
+
+    DistanceFieldHeader()
+        : version(DistanceFieldFormat::VERSION), encoding(0), nodeCount(0),
+          sourceCount(0), scale(1.0), reserved{0, 0, 0} {
+        std::memcpy(magic, DistanceFieldFormat::MAGIC, sizeof(magic));
+    }
+
+    DistanceEncoding getEncoding() const { return (DistanceEncoding)encoding; }
+
+    // Byte offset of the value section, relative to the start of the file
+    uint64_t valuesPos() const {
+        return sizeof(DistanceFieldHeader) + ((sourceCount * sizeof(int32_t) + 7) & ~uint64_t(7));
+    }
+};
+
+static_assert(sizeof(DistanceFieldHeader) == 64, "DistanceFieldHeader must stay 64 bytes");
+
+// Header, source list and padding: everything before the values
+inline std::vector<char> buildDistanceFieldPrefix(DistanceFieldHeader& header, DistanceEncoding encoding,
+                                                  int nodeCount, const std::vector<int>& sources,
+                                                  double scale) {
+    header.encoding = (uint32_t)encoding;
+    header.nodeCount = nodeCount;
+    header.sourceCount = sources.size();
+    header.scale = scale;
+
+    std::vector<char> prefix(header.valuesPos(), 0);
+    std::memcpy(prefix.data(), &header, sizeof(header));
+    for (size_t i = 0; i < sources.size(); i++) {
+        int32_t id = sources[i];
+        std::memcpy(prefix.data() + sizeof(header) + i * sizeof(int32_t), &id, sizeof(id));
+    }
+    return prefix;
+}
+
+// Encode count distances into out (count * getDistanceEncodingBytes bytes).
+// Returns the number of finite fixed-point values that had to saturate.
+inline long long encodeDistances(const double* distances, size_t count, DistanceEncoding encoding,
+                                 double scale, void* out) {
+    long long saturated = 0;
+    if (encoding == DistanceEncoding::Float64) {
+        std::memcpy(out, distances, count * sizeof(double));
+    } else if (encoding == DistanceEncoding::Float32) {
+        float* values = static_cast<float*>(out);
+        for (size_t i = 0; i < count; i++) {
+            values[i] = (float)distances[i];
+        }
+    } else {
+        uint32_t* values = static_cast<uint32_t*>(out);
+        const double limit = DistanceFieldFormat::MAX_FIXED;
+        for (size_t i = 0; i < count; i++) {
+            double scaled = distances[i] * scale + 0.5;
+            bool reachable = distances[i] < std::numeric_limits<double>::infinity();
+            saturated += reachable & (scaled > limit);
+            double clamped = scaled < limit ? scaled : limit;
+            values[i] = reachable ? (uint32_t)clamped : DistanceFieldFormat::UNREACHABLE;
+        }
+    }
+    return saturated;
+}
+
+// Decode count values written by encodeDistances
+inline void decodeDistances(const void* in, size_t count, DistanceEncoding encoding,
+                            double scale, double* distances) {
+    if (encoding == DistanceEncoding::Float64) {
+        std::memcpy(distances, in, count * sizeof(double));
+    } else if (encoding == DistanceEncoding::Float32) {
+        const float* values = static_cast<const float*>(in);
+        for (size_t i = 0; i < count; i++) {
+            distances[i] = values[i];
+        }
+    } else {
+        const uint32_t* values = static_cast<const uint32_t*>(in);
+        const double inverse = 1.0 / scale;
+        for (size_t i = 0; i < count; i++) {
+            distances[i] = values[i] == DistanceFieldFormat::UNREACHABLE
+                ? std::numeric_limits<double>::infinity() : values[i] * inverse;
+        }
+    }
+}
+
+// Streams a distance field to disk in node order, one block at a time
+class DistanceFieldWriter {
+private:
+    static const size_t BLOCK_NODES = 1 << 16;
+
+    std::ofstream file;
+    std::string filename;
+    DistanceFieldHeader header;
+    std::vector<double> block;
+    std::vector<char> encoded;
+    uint64_t written;
+    long long saturated;
+
+    void flushBlock() {
+        if (block.empty()) {
+            return;
+        }
+        saturated += encodeDistances(block.data(), block.size(), header.getEncoding(),
+                                     header.scale, encoded.data());
+        file.write(encoded.data(), block.size() * getDistanceEncodingBytes(header.getEncoding()));
+        written += block.size();
+        block.clear();
+    }
+
+public:
+    DistanceFieldWriter() : written(0), saturated(0) {}
+
+    // Write the header and the source list
+    bool open(const std::string& path, DistanceEncoding encoding, int nodeCount,
+              const std::vector<int>& sources, double scale) {
+        filename = path;
+        file.open(path, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot create file " << path << std::endl;
+            return false;
+        }
+        std::vector<char> prefix = buildDistanceFieldPrefix(header, encoding, nodeCount, sources, scale);
+        file.write(prefix.data(), prefix.size());
+
+        block.reserve(BLOCK_NODES);
+        encoded.resize(BLOCK_NODES * sizeof(double));
+        return true;
+    }
+
+    // Next node's distance
+    void append(double distance) {
+        block.push_back(distance);
+        if (block.size() == BLOCK_NODES) {
+            flushBlock();
+        }
+    }
+
+    void append(const double* distances, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            append(distances[i]);
+        }
+    }
+
+    // Finite distances clamped to the largest fixed-point value
+    long long getSaturatedCount() const { return saturated; }
+
+    bool close() {
+        flushBlock();
+        if (written != header.nodeCount) {
+            std::cerr << "Error: " << filename << " got " << written << " of "
+                      << header.nodeCount << " distances" << std::endl;
+            return false;
+        }
+        file.close();
+        if (!file) {
+            std::cerr << "Error: Failed writing " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+// Parse a source list: "3", "3,17,42", or "@file" with one node ID per line
+inline bool parseSourceList(const std::string& spec, std::vector<int>& sources) {
+    sources.clear();
+    if (!spec.empty() && spec[0] == '@') {
+        std::ifstream file(spec.substr(1));
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot open source file " << spec.substr(1) << std::endl;
+            return false;
+        }
+        int id;
+        while (file >> id) {
+            sources.push_back(id);
+        }
+    } else {
+        size_t start = 0;
+        while (start <= spec.size()) {
+            size_t end = spec.find(',', start);
+            if (end == std::string::npos) {
+                end = spec.size();
+            }
+            std::string item = spec.substr(start, end - start);
+            char* rest = nullptr;
+            long id = std::strtol(item.c_str(), &rest, 10);
+            if (item.empty() || *rest != '\0') {
+                std::cerr << "Error: Invalid source '" << item << "'" << std::endl;
+                return false;
+            }
+            sources.push_back((int)id);
+            start = end + 1;
+        }
+    }
+    if (sources.empty()) {
+        std::cerr << "Error: No sources given" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Read a whole distance field back as doubles
+inline bool loadDistanceField(const std::string& filename, DistanceFieldHeader& header,
+                              std::vector<int>& sources, std::vector<double>& distances) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, DistanceFieldFormat::MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != DistanceFieldFormat::VERSION ||
+        header.encoding > (uint32_t)DistanceEncoding::Fixed32) {
+        std::cerr << "Error: " << filename << " is not a distance field file" << std::endl;
+        return false;
+    }
+
+    std::vector<int32_t> ids(header.sourceCount);
+    file.read(reinterpret_cast<char*>(ids.data()), ids.size() * sizeof(int32_t));
+    sources.assign(ids.begin(), ids.end());
+    file.seekg(header.valuesPos());
+
+    size_t width = getDistanceEncodingBytes(header.getEncoding());
+    std::vector<char> values(header.nodeCount * width);
+    if (!file.read(values.data(), values.size())) {
+        std::cerr << "Error: Truncated distance field " << filename << std::endl;
+        return false;
+    }
+    distances.resize(header.nodeCount);
+    decodeDistances(values.data(), header.nodeCount, header.getEncoding(), header.scale, distances.data());
+    return true;
+}
+
+#endif
@@ -0,0 +1,309 @@
+#ifndef DISTANCE_MATRIX_H
+#define DISTANCE_MATRIX_H
+
+#include "Dijkstra.h"
+#include "ContractionHierarchy.h"
+#include "DistanceField.h"
+#include "ParallelFor.h"
+#include <vector>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+
+// Many-to-many distance tables (sources x targets) computed in one pass.
+//
+// With a contraction hierarchy the table uses bucket-based search (Knopp et
+// al.):
+//   1. A backward upward search runs from every target t. Each settled
+//      node x gets the bucket entry (t, d(x, t)).
+//   2. A forward upward search runs from every source s. At each settled
+//      node x it scans x's bucket, and row s takes min d(s, x) + d(x, t).
+// Every shortest path meets at its highest-ranked node, which both
+// searches settle. The table therefore costs |S| + |T| small upward
+// searches instead of |S| x |T| queries. Both phases are independent
+// searches and run on worker threads; the buckets are read-only in phase 2.
+//
+// Without a hierarchy each source runs one Dijkstra, stopped once every
+// target is settled.
+//
+// Matrix file (native byte order):
+//   DistanceMatrixHeader                       64 bytes
+//   sources  int32 x rows, targets int32 x cols  (padded to 8 bytes together)
+//   values   rows x cols, row-major, encoded as in DistanceField.h
+namespace DistanceMatrixFormat {
+    const char MAGIC[8] = {'D', 'I', 'S', 'T', 'M', 'T', 'R', 'X'};
+    const uint32_t VERSION = 1;
+}
+
+struct DistanceMatrixHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t encoding;   // DistanceEncoding
+    uint64_t rows;
+    uint64_t cols;
+    double scale;        // Fixed point only: stored value = distance * scale
+    uint64_t reserved[3];
+
+    DistanceMatrixHeader()
+        : version(DistanceMatrixFormat::VERSION), encoding(0), rows(0), cols(0),
+          scale(1.0), reserved{0, 0, 0} {
+        std::memcpy(magic, DistanceMatrixFormat::MAGIC, sizeof(magic));
+    }
+
+    // Byte offset of the value section, relative to the start of the file
+    uint64_t valuesPos() const {
+        return sizeof(DistanceMatrixHeader) + (((rows + cols) * sizeof(int32_t) + 7) & ~uint64_t(7));
+    }
+};
+
+static_assert(sizeof(DistanceMatrixHeader) == 64, "DistanceMatrixHeader must stay 64 bytes");
+
+// Work counters of one table computation
+struct MatrixStats {
+    long long backwardSettled = 0;
+    long long forwardSettled = 0;
+    long long bucketEntries = 0;
+    long long bucketScans = 0;   // Entries read in phase 2
+    double bucketMs = 0.0;       // Phase 1 (CH only)
+    double tableMs = 0.0;        // Phase 2, or all Dijkstra searches
+};
+
+class DistanceMatrixEngine {
+private:
+    static const int ROW_BLOCK = 64;  // Rows computed per block before they are written
+
+    const CSRGraph& graph;
+    const ContractionHierarchy* hierarchy;
+    int threads;
+
+    // Buckets in CSR form: node -> (target column, distance) entries
+    struct BucketEntry {
+        int column;
+        double distance;
+    };
+    std::vector<int> bucketOffsets;
+    std::vector<BucketEntry> buckets;
+
+    // Dijkstra fallback
+    std::vector<int> targetMark;  // Node -> 1 if it is a target
+    int distinctTargets = 0;
+
+    // Phase 1: bucket entries of every target, merged by node in column
+    // order so the buckets do not depend on thread timing
+    void buildBuckets(const std::vector<int>& targets, MatrixStats& stats) {
+        int nodeCount = graph.getNodeCount();
+        std::vector<std::vector<std::pair<int, double>>> perTarget(targets.size());
+        std::vector<SearchSpace<DaryHeapQueue<4>>> spaces(threads);
+        std::vector<long long> settled(threads, 0);
+
+        parallelFor(targets.size(), threads, [&](long long column, int t) {
+            std::vector<std::pair<int, double>>& entries = perTarget[column];
+            settled[t] += hierarchy->upwardSearch(spaces[t], targets[column], true,
+                [&](int node, double distance) { entries.emplace_back(node, distance); });
+        });
+
+        bucketOffsets.assign(nodeCount + 1, 0);
+        for (const auto& entries : perTarget) {
+            for (const auto& entry : entries) {
+                bucketOffsets[entry.first + 1]++;
+            }
+        }
+        for (int v = 0; v < nodeCount; v++) {
+            bucketOffsets[v + 1] += bucketOffsets[v];
+        }
+        buckets.resize(bucketOffsets[nodeCount]);
+        std::vector<int> fill(bucketOffsets.begin(), bucketOffsets.end() - 1);
+        for (size_t column = 0; column < perTarget.size(); column++) {
+            for (const auto& entry : perTarget[column]) {
+                buckets[fill[entry.first]++] = BucketEntry{(int)column, entry.second};
+            }
+        }
+
+        for (long long count : settled) {
+            stats.backwardSettled += count;
+        }
+        stats.bucketEntries = buckets.size();
+    }
+
+    // Phase 2 for one source: scan the buckets of its upward search space
+    long long fillRowCH(SearchSpace<DaryHeapQueue<4>>& space, int source, double* row, long long& scans) const {
+        return hierarchy->upwardSearch(space, source, false, [&](int node, double distance) {
+            int end = bucketOffsets[node + 1];
+            scans += end - bucketOffsets[node];
+            for (int i = bucketOffsets[node]; i < end; i++) {
+                const BucketEntry& entry = buckets[i];
+                double total = distance + entry.distance;
+                row[entry.column] = std::min(row[entry.column], total);
+            }
+        });
+    }
+
+    // One Dijkstra per source, stopped once all targets are settled
+    long long fillRowDijkstra(SearchSpace<DaryHeapQueue<4>>& space, int source,
+                              const std::vector<int>& targets, double* row) const {
+        space.prepare(graph.getNodeCount());
+        space.label(source, 0.0, -1);
+        space.pq.push(source, 0.0);
+        int remaining = distinctTargets;
+        long long settled = 0;
+
+        while (!space.pq.empty() && remaining > 0) {
+            int u = space.pq.pop();
+            if (space.isSettled(u)) {
+                continue;
+            }
+            space.settle(u);
+            settled++;
+            remaining -= targetMark[u];
+
+            double distU = space.getDistance(u);
+            for (int e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+                int v = graph.getTarget(e);
+                double newDist = distU + graph.getWeight(e);
+                if (newDist < space.getDistance(v)) {
+                    space.label(v, newDist, u);
+                    space.pq.push(v, newDist);
+                }
+            }
+        }
+
+        // The search only stops early once every target is settled, so an
+        // unsettled target is unreachable
+        for (size_t column = 0; column < targets.size(); column++) {
+            row[column] = space.isSettled(targets[column])
+                ? space.getDistance(targets[column]) : std::numeric_limits<double>::infinity();
+        }
+        return settled;
+    }
+
+public:
+    // hierarchy may be null; it must have been built for graph
+    DistanceMatrixEngine(const CSRGraph& g, const ContractionHierarchy* ch, int threadCount)
+        : graph(g), hierarchy(ch), threads(std::max(1, threadCount)) {}
+
+    // Compute the table and hand it out in blocks of consecutive rows:
+    // sink(firstRow, rowCount, values) with rowCount x targets.size()
+    // row-major values. Blocks arrive in row order.
+    template <typename RowSink>
+    MatrixStats compute(const std::vector<int>& sources, const std::vector<int>& targets,
+                        const RowSink& sink) {
+        using Clock = std::chrono::steady_clock;
+        MatrixStats stats;
+        size_t cols = targets.size();
+
+        auto phaseStart = Clock::now();
+        if (hierarchy) {
+            buildBuckets(targets, stats);
+        } else {
+            targetMark.assign(graph.getNodeCount(), 0);
+            distinctTargets = 0;
+            for (int target : targets) {
+                distinctTargets += (targetMark[target] == 0);
+                targetMark[target] = 1;
+            }
+        }
+        stats.bucketMs = std::chrono::duration<double, std::milli>(Clock::now() - phaseStart).count();
+
+        phaseStart = Clock::now();
+        std::vector<SearchSpace<DaryHeapQueue<4>>> spaces(threads);
+        std::vector<long long> settled(threads, 0), scans(threads, 0);
+        std::vector<double> block((size_t)ROW_BLOCK * threads * cols);
+        size_t blockRows = (size_t)ROW_BLOCK * threads;
+
+        for (size_t first = 0; first < sources.size(); first += blockRows) {
+            size_t rows = std::min(blockRows, sources.size() - first);
+            std::fill(block.begin(), block.begin() + rows * cols, std::numeric_limits<double>::infinity());
+            parallelFor(rows, threads, [&](long long r, int t) {
+                double* row = &block[r * cols];
+                settled[t] += hierarchy ? fillRowCH(spaces[t], sources[first + r], row, scans[t])
+                                        : fillRowDijkstra(spaces[t], sources[first + r], targets, row);
+            });
+            sink(first, rows, block.data());
+        }
+        stats.tableMs = std::chrono::duration<double, std::milli>(Clock::now() - phaseStart).count();
+
+        for (int t = 0; t < threads; t++) {
+            stats.forwardSettled += settled[t];
+            stats.bucketScans += scans[t];
+        }
+        return stats;
+    }
+
+    size_t getBucketBytes() const {
+        return bucketOffsets.capacity() * sizeof(int) + buckets.capacity() * sizeof(BucketEntry);
+    }
+};
+
+// Streams a matrix file row block by row block
+class DistanceMatrixWriter {
+private:
+    std::ofstream file;
+    std::string filename;
+    DistanceMatrixHeader header;
+    std::vector<char> encoded;
+    uint64_t rowsWritten;
+    long long saturated;
+
+public:
+    DistanceMatrixWriter() : rowsWritten(0), saturated(0) {}
+
+    bool open(const std::string& path, DistanceEncoding encoding, const std::vector<int>& sources,
+              const std::vector<int>& targets, double scale) {
+        filename = path;
+        file.open(path, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot create file " << path << std::endl;
+            return false;
+        }
+        header.encoding = (uint32_t)encoding;
+        header.rows = sources.size();
+        header.cols = targets.size();
+        header.scale = scale;
+
+        std::vector<char> prefix(header.valuesPos(), 0);
+        std::memcpy(prefix.data(), &header, sizeof(header));
+        char* ids = prefix.data() + sizeof(header);
+        for (const std::vector<int>* list : {&sources, &targets}) {
+            for (int node : *list) {
+                int32_t id = node;
+                std::memcpy(ids, &id, sizeof(id));
+                ids += sizeof(id);
+            }
+        }
+        file.write(prefix.data(), prefix.size());
+        return true;
+    }
+
+    // The next rows, rows x cols values
+    void writeRows(size_t rows, const double* values) {
+        size_t count = rows * header.cols;
+        encoded.resize(count * getDistanceEncodingBytes((DistanceEncoding)header.encoding));
+        saturated += encodeDistances(values, count, (DistanceEncoding)header.encoding,
+                                     header.scale, encoded.data());
+        file.write(encoded.data(), encoded.size());
+        rowsWritten += rows;
+    }
+
+    long long getSaturatedCount() const { return saturated; }
+
+    bool close() {
+        if (rowsWritten != header.rows) {
+            std::cerr << "Error: " << filename << " got " << rowsWritten << " of "
+                      << header.rows << " rows" << std::endl;
+            return false;
+        }
+        file.close();
+        if (!file) {
+            std::cerr << "Error: Failed writing " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,398 @@
+#ifndef DYNAMIC_GRAPH_H
+#define DYNAMIC_GRAPH_H
+
+#include "PriorityQueue.h"
+#include <vector>
+#include <string>
+#include <limits>
+#include <cmath>
+#include <chrono>
+#include <sstream>
+#include <unordered_set>
+#include <iostream>
+#include <fstream>
+
+// Edge updates on a live graph and incremental repair of distance fields.
+//
+// Update file, one update per line ('#' starts a comment):
+//   set u v w   change the weight of every u -> v edge to w
+//   add u v w   insert a new edge u -> v with weight w
+//   del u v     delete every u -> v edge
+//   commit      end of a batch; the end of the file ends the last one
+// Weights must be finite and non-negative. Every batch is applied as a
+// whole and the distances are repaired once per batch.
+enum class EdgeUpdateKind {
+    SetWeight,
+    Insert,
+    Delete
+};
+
+struct EdgeUpdate {
+    EdgeUpdateKind kind;
+    int from;
+    int to;
+    double weight;  // Unused for Delete
+};
+
+// Read all batches of an update file
+inline bool loadEdgeUpdates(const std::string& filename, std::vector<std::vector<EdgeUpdate>>& batches) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open update file " << filename << std::endl;
+        return false;
+    }
+
+    batches.assign(1, {});
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::istringstream fields(line.substr(0, line.find('#')));
+        std::string op;
+        if (!(fields >> op)) {
+            continue;
+        }
+        if (op == "commit") {
+            if (!batches.back().empty()) {
+                batches.emplace_back();
+            }
+            continue;
+        }
+
+        EdgeUpdate update{EdgeUpdateKind::Delete, -1, -1, 0.0};
+        bool ok = false;
+        if (op == "set" || op == "add") {
+            update.kind = (op == "set") ? EdgeUpdateKind::SetWeight : EdgeUpdateKind::Insert;
+            ok = (fields >> update.from >> update.to >> update.weight) &&
+                 std::isfinite(update.weight) && update.weight >= 0.0;
+        } else if (op == "del") {
+            ok = (bool)(fields >> update.from >> update.to);
+        }
+        if (!ok) {
+            std::cerr << "Error: " << filename << ":" << lineNumber
+                      << ": expected 'set u v w', 'add u v w', 'del u v' or 'commit'" << std::endl;
+            return false;
+        }
+        batches.back().push_back(update);
+    }
+    if (batches.back().empty()) {
+        batches.pop_back();
+    }
+    return true;
+}
+
+// One edge that changed: oldWeight or newWeight is infinite for an edge
+// that was inserted or deleted
+struct EdgeChange {
+    int from;
+    int to;
+    double oldWeight;
+    double newWeight;
+};
+
+// Mutable graph with outgoing and incoming adjacency lists.
+// The CSR graphs are immutable and only ever rebuilt; this one takes edge
+// updates in place at O(degree) each, and its incoming lists let the
+// repair find the remaining parents of a node whose path got longer.
+class DynamicGraph {
+public:
+    struct Arc {
+        int node;      // Target of an outgoing arc, source of an incoming one
+        double weight;
+    };
+
+private:
+    std::vector<std::vector<Arc>> outArcs;
+    std::vector<std::vector<Arc>> inArcs;
+    long long edgeCount;
+
+    static void setWeights(std::vector<Arc>& arcs, int node, double weight) {
+        for (Arc& arc : arcs) {
+            if (arc.node == node) {
+                arc.weight = weight;
+            }
+        }
+    }
+
+    static void removeArcs(std::vector<Arc>& arcs, int node) {
+        size_t kept = 0;
+        for (const Arc& arc : arcs) {
+            if (arc.node != node) {
+                arcs[kept++] = arc;
+            }
+        }
+        arcs.resize(kept);
+    }
+
+public:
+    DynamicGraph() : edgeCount(0) {}
+
+    // Copy any CSR graph; weights are held as double
+    template <typename Graph>
+    explicit DynamicGraph(const Graph& graph)
+        : outArcs(graph.getNodeCount()), inArcs(graph.getNodeCount()), edgeCount(0) {
+        for (int u = 0; u < graph.getNodeCount(); u++) {
+            outArcs[u].reserve(graph.getDegree(u));
+            for (auto e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+                int v = graph.getTarget(e);
+                double w = graph.getWeight(e);
+                outArcs[u].push_back(Arc{v, w});
+                inArcs[v].push_back(Arc{u, w});
+                edgeCount++;
+            }
+        }
+    }
+
+    int getNodeCount() const { return outArcs.size(); }
+    long long getEdgeCount() const { return edgeCount; }
+
+    const std::vector<Arc>& getOutArcs(int u) const { return outArcs[u]; }
+    const std::vector<Arc>& getInArcs(int v) const { return inArcs[v]; }
+
+    // Apply one update and append the edges it changed to changes. An
+    // update of an invalid node or a missing edge is skipped with a
+    // warning, as in the batch query tools, and returns false.
+    bool apply(const EdgeUpdate& update, std::vector<EdgeChange>& changes) {
+        const double INF = std::numeric_limits<double>::infinity();
+        int u = update.from;
+        int v = update.to;
+        if (u < 0 || u >= getNodeCount() || v < 0 || v >= getNodeCount()) {
+            std::cerr << "Warning: Skipping update of " << u << " -> " << v << " (invalid node)" << std::endl;
+            return false;
+        }
+
+        if (update.kind == EdgeUpdateKind::Insert) {
+            outArcs[u].push_back(Arc{v, update.weight});
+            inArcs[v].push_back(Arc{u, update.weight});
+            edgeCount++;
+            changes.push_back(EdgeChange{u, v, INF, update.weight});
+            return true;
+        }
+
+        size_t before = changes.size();
+        for (const Arc& arc : outArcs[u]) {
+            if (arc.node == v) {
+                double newWeight = (update.kind == EdgeUpdateKind::Delete) ? INF : update.weight;
+                changes.push_back(EdgeChange{u, v, arc.weight, newWeight});
+            }
+        }
+        if (changes.size() == before) {
+            std::cerr << "Warning: Skipping update of " << u << " -> " << v << " (no such edge)" << std::endl;
+            return false;
+        }
+
+        if (update.kind == EdgeUpdateKind::Delete) {
+            removeArcs(outArcs[u], v);
+            removeArcs(inArcs[v], u);
+            edgeCount -= changes.size() - before;
+        } else {
+            setWeights(outArcs[u], v, update.weight);
+            setWeights(inArcs[v], u, update.weight);
+        }
+        return true;
+    }
+};
+
+// Work done by one repair
+struct RepairStats {
+    long long skipped = 0;       // Updates that named no edge
+    long long edgesChanged = 0;
+    long long affected = 0;      // Nodes whose distance had to be recomputed
+    long long settled = 0;       // Nodes settled by the repair search
+    long long edgesScanned = 0;  // Incoming and outgoing edges looked at
+    double repairMs = 0.0;
+};
+
+// One-to-all (or multi-source) distances kept up to date under edge updates.
+//
+// A batch is applied in the style of Ramalingam and Reps. An edge u -> v is
+// tight if dist(u) + w = dist(v), i.e. it lies on some shortest path.
+//   1. On the graph before the batch: a node is affected if it loses every
+//      tight incoming edge from an unaffected node. The heads of tight edges
+//      that get heavier or disappear are the first candidates. Candidates
+//      are decided in order of distance, and every affected node makes its
+//      tight successors candidates in turn.
+//   2. The batch is applied. Each affected node takes its best distance
+//      over the incoming edges from unaffected nodes and is queued with it,
+//      and so are the tails of all changed edges.
+//   3. A Dijkstra over the queued nodes settles the new distances.
+// The work is proportional to the nodes whose distances change and their
+// edges, not to the size of the graph.
+class IncrementalSSSP {
+private:
+    DynamicGraph& graph;
+    std::vector<int> sources;
+    std::vector<double> distances;
+    std::vector<char> isSource;
+
+    // Scratch for the repair, cleared after each batch
+    std::vector<char> state;
+    std::vector<int> touched;
+    DaryHeapQueue<4> heap;
+
+    static constexpr char CANDIDATE = 1;
+    static constexpr char AFFECTED = 2;
+    static constexpr char KEPT = 3;
+
+    void markCandidate(int node) {
+        if (state[node] == 0 && !isSource[node]) {
+            touched.push_back(node);
+            state[node] = CANDIDATE;
+            heap.push(node, distances[node]);
+        }
+    }
+
+    // Dijkstra from the queued nodes; labels only ever go down
+    void settleQueued(RepairStats& stats) {
+        while (!heap.empty()) {
+            int u = heap.pop();
+            stats.settled++;
+            double distU = distances[u];
+            for (const DynamicGraph::Arc& arc : graph.getOutArcs(u)) {
+                stats.edgesScanned++;
+                double candidate = distU + arc.weight;
+                if (candidate < distances[arc.node]) {
+                    distances[arc.node] = candidate;
+                    heap.push(arc.node, candidate);
+                }
+            }
+        }
+    }
+
+    static long long edgeKey(int u, int v) {
+        return (long long)u << 32 | (unsigned)v;
+    }
+
+    // Phase 1; returns the affected nodes
+    std::vector<int> findAffected(const std::vector<EdgeUpdate>& batch, RepairStats& stats) {
+        // Node pairs whose edges get heavier or go away cannot support
+        // their heads any more
+        std::unordered_set<long long> weakened;
+        for (const EdgeUpdate& update : batch) {
+            if (update.kind == EdgeUpdateKind::Insert || update.from < 0 ||
+                update.from >= graph.getNodeCount()) {
+                continue;
+            }
+            for (const DynamicGraph::Arc& arc : graph.getOutArcs(update.from)) {
+                bool heavier = update.kind == EdgeUpdateKind::Delete || update.weight > arc.weight;
+                if (arc.node == update.to && heavier) {
+                    weakened.insert(edgeKey(update.from, update.to));
+                    if (distances[update.from] + arc.weight == distances[arc.node]) {
+                        markCandidate(arc.node);
+                    }
+                }
+            }
+        }
+
+        std::vector<int> affected;
+        while (!heap.empty()) {
+            int y = heap.pop();
+            // Nodes closer than y are all decided by now. A parent at the
+            // same distance (zero-weight edge) may not be; unless it was
+            // kept it counts as lost, which only affects more nodes.
+            bool supported = false;
+            for (const DynamicGraph::Arc& arc : graph.getInArcs(y)) {
+                stats.edgesScanned++;
+                if ((state[arc.node] == KEPT || (state[arc.node] == 0 && arc.weight > 0.0)) &&
+                    distances[arc.node] + arc.weight == distances[y] &&
+                    (weakened.empty() || !weakened.count(edgeKey(arc.node, y)))) {
+                    supported = true;
+                    break;
+                }
+            }
+            if (supported) {
+                state[y] = KEPT;
+                continue;
+            }
+            state[y] = AFFECTED;
+            affected.push_back(y);
+            for (const DynamicGraph::Arc& arc : graph.getOutArcs(y)) {
+                stats.edgesScanned++;
+                if (distances[y] + arc.weight == distances[arc.node]) {
+                    markCandidate(arc.node);
+                }
+            }
+        }
+        return affected;
+    }
+
+public:
+    explicit IncrementalSSSP(DynamicGraph& dynamicGraph) : graph(dynamicGraph) {}
+
+    // Distances from scratch
+    RepairStats compute(const std::vector<int>& sourceNodes) {
+        auto start = std::chrono::steady_clock::now();
+        int nodeCount = graph.getNodeCount();
+        sources = sourceNodes;
+        distances.assign(nodeCount, std::numeric_limits<double>::infinity());
+        isSource.assign(nodeCount, 0);
+        state.assign(nodeCount, 0);
+        heap.init(nodeCount);
+
+        RepairStats stats;
+        for (int source : sources) {
+            isSource[source] = 1;
+            distances[source] = 0.0;
+            heap.push(source, 0.0);
+        }
+        settleQueued(stats);
+        stats.affected = nodeCount;
+        stats.repairMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    // Apply a batch to the graph and repair the distances
+    RepairStats applyBatch(const std::vector<EdgeUpdate>& batch) {
+        const double INF = std::numeric_limits<double>::infinity();
+        auto start = std::chrono::steady_clock::now();
+        RepairStats stats;
+
+        heap.init(graph.getNodeCount());
+        std::vector<int> affected = findAffected(batch, stats);
+        stats.affected = affected.size();
+
+        std::vector<EdgeChange> changes;
+        for (const EdgeUpdate& update : batch) {
+            stats.skipped += !graph.apply(update, changes);
+        }
+        stats.edgesChanged = changes.size();
+
+        // 2. Affected nodes restart from their unaffected in-neighbours; the
+        //    tails of changed edges relax their (new) edges again
+        for (int y : affected) {
+            distances[y] = INF;
+        }
+        for (int y : affected) {
+            double best = INF;
+            for (const DynamicGraph::Arc& arc : graph.getInArcs(y)) {
+                stats.edgesScanned++;
+                if (state[arc.node] != AFFECTED) {
+                    best = std::min(best, distances[arc.node] + arc.weight);
+                }
+            }
+            if (best < INF) {
+                distances[y] = best;
+                heap.push(y, best);
+            }
+        }
+        for (const EdgeChange& change : changes) {
+            if (distances[change.from] < INF) {
+                heap.push(change.from, distances[change.from]);
+            }
+        }
+
+        // 3. Settle everything that was queued
+        settleQueued(stats);
+        for (int node : touched) {
+            state[node] = 0;
+        }
+        touched.clear();
+        stats.repairMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    double getDistance(int node) const { return distances[node]; }
+    const std::vector<int>& getSources() const { return sources; }
+};
+
+#endif
@@ -8,40 +8,48 @@
 #include <fstream>
 #include <sstream>
 
-// Edge structure - represents a weighted connection between nodes
-struct Edge {
+// Edge structure - represents a weighted connection between nodes.
+// With float or uint32_t weights an edge is 8 bytes instead of 16.
+template <typename Weight>
+struct BasicEdge {
     int destination;      // Target node
-    double weight;        // Edge cost/distance
+    Weight weight;        // Edge cost/distance
     
-    Edge(int dest, double w) : destination(dest), weight(w) {}
+    BasicEdge(int dest, Weight w) : destination(dest), weight(w) {}
 };
 
+using Edge = BasicEdge<double>;
+
 // Node structure - represents a vertex in the graph
-struct Node {
-    int id;                          // Node identifier
-    double x, y;                     // Coordinates (for A* heuristic)
-    std::vector<Edge> adjacencyList; // Outgoing edges
+template <typename Weight>
+struct BasicNode {
+    int id;                                      // Node identifier
+    double x, y;                                 // Coordinates (for A* heuristic)
+    std::vector<BasicEdge<Weight>> adjacencyList; // Outgoing edges
     
-    Node() : id(-1), x(0.0), y(0.0) {}
-    Node(int nodeId, double xCoord = 0.0, double yCoord = 0.0) 
+    BasicNode() : id(-1), x(0.0), y(0.0) {}
+    BasicNode(int nodeId, double xCoord = 0.0, double yCoord = 0.0) 
         : id(nodeId), x(xCoord), y(yCoord) {}
     
     // Add an edge from this node
-    void addEdge(int dest, double weight) {
+    void addEdge(int dest, Weight weight) {
         adjacencyList.emplace_back(dest, weight);
     }
 };
 
+using Node = BasicNode<double>;
+
 // Main Graph class
-class Graph {
+template <typename Weight>
+class BasicGraph {
 private:
-    std::vector<Node> nodes;
+    std::vector<BasicNode<Weight>> nodes;
     int nodeCount;
     int edgeCount;
 
 public:
     // Constructor
-    Graph(int numNodes = 0) : nodeCount(numNodes), edgeCount(0) {
+    BasicGraph(int numNodes = 0) : nodeCount(numNodes), edgeCount(0) {
         nodes.resize(numNodes);
         for (int i = 0; i < numNodes; i++) {
             nodes[i].id = i;
@@ -76,7 +84,7 @@ public:
     }
     
     // Add a directed edge
-    void addEdge(int from, int to, double weight) {
+    void addEdge(int from, int to, Weight weight) {
         if (from >= 0 && from < nodeCount && to >= 0 && to < nodeCount) {
             nodes[from].addEdge(to, weight);
             edgeCount++;
@@ -84,18 +92,18 @@ public:
     }
     
     // Add a bidirectional edge (undirected graph)
-    void addBidirectionalEdge(int from, int to, double weight) {
+    void addBidirectionalEdge(int from, int to, Weight weight) {
         addEdge(from, to, weight);
         addEdge(to, from, weight);
     }
     
     // Get a node reference
-    const Node& getNode(int id) const {
+    const BasicNode<Weight>& getNode(int id) const {
         return nodes[id];
     }
     
     // Get adjacency list for a node
-    const std::vector<Edge>& getAdjacencyList(int nodeId) const {
+    const std::vector<BasicEdge<Weight>>& getAdjacencyList(int nodeId) const {
         return nodes[nodeId].adjacencyList;
     }
     
@@ -132,7 +140,7 @@ public:
             int from, to;
             double weight;
             file >> from >> to >> weight;
-            addEdge(from, to, weight);
+            addEdge(from, to, (Weight)weight);
         }
         
         file.close();
@@ -151,7 +159,7 @@ public:
         
         // Write all edges
         for (int i = 0; i < nodeCount; i++) {
-            for (const Edge& edge : nodes[i].adjacencyList) {
+            for (const BasicEdge<Weight>& edge : nodes[i].adjacencyList) {
                 file << i << " " << edge.destination << " " << edge.weight << "\n";
             }
         }
@@ -187,18 +195,42 @@ public:
     }
 };
 
-// Priority queue element for Dijkstra/A*
-struct PQElement {
+using Graph = BasicGraph<double>;
+
+// Priority queue element for Dijkstra/A*. The key is the distance in plain
+// Dijkstra and the f-score g(n) + h(n) in A*; the distance itself lives in
+// the SearchSpace, so the element does not carry it a second time.
+template <typename Key>
+struct BasicPQElement {
     int nodeId;
-    double distance;
-    double fScore;  // f(n) = g(n) + h(n) for A*
+    Key key;
     
-    PQElement(int id, double dist, double f = 0.0) 
-        : nodeId(id), distance(dist), fScore(f) {}
+    BasicPQElement(int id, Key k) : nodeId(id), key(k) {}
     
     // For priority queue (min-heap)
-    bool operator>(const PQElement& other) const {
-        return fScore > other.fScore;
+    bool operator>(const BasicPQElement& other) const {
+        return key > other.key;
+    }
+};
+
+using PQElement = BasicPQElement<double>;
+
+// Work counters of a single search
+struct SearchStats {
+    long long nodesSettled = 0;
+    long long edgesRelaxed = 0;
+    long long heapPushes = 0;     // New queue entries
+    long long decreaseKeys = 0;   // In-place key decreases (indexed heaps)
+    long long stalePops = 0;      // Popped entries for already settled nodes
+    long long maxQueueSize = 0;
+    
+    void print() const {
+        std::cout << "Nodes settled: " << nodesSettled << "\n";
+        std::cout << "Edges relaxed: " << edgesRelaxed << "\n";
+        std::cout << "Heap pushes: " << heapPushes << "\n";
+        std::cout << "Decrease-keys: " << decreaseKeys << "\n";
+        std::cout << "Stale pops: " << stalePops << "\n";
+        std::cout << "Max queue size: " << maxQueueSize << "\n";
     }
 };
 
@@ -208,6 +240,7 @@ struct PathResult {
     double totalDistance;
     bool found;
     double executionTime;  // in milliseconds
+    SearchStats stats;
     
     PathResult() 
         : totalDistance(std::numeric_limits<double>::infinity()), 
@@ -232,4 +265,14 @@ struct PathResult {
     }
 };
 
+// Whether two searches agree on a distance. Sums of the same weights in a
+// different order may differ slightly; unreachable (infinite) distances
+// only match each other.
+inline bool sameDistance(double expected, double actual) {
+    if (std::isinf(expected) || std::isinf(actual)) {
+        return expected == actual;
+    }
+    return std::fabs(expected - actual) <= 1e-9 * std::fmax(1.0, std::fabs(expected));
+}
+
 #endif 
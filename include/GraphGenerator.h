@@ -0,0 +1,613 @@
+#ifndef GRAPH_GENERATOR_H
+#define GRAPH_GENERATOR_H
+
+#include "BinaryGraphFormat.h"
+#include "ParallelFor.h"
+#include <vector>
+#include <string>
+#include <random>
+#include <atomic>
+#include <algorithm>
+#include <utility>
+#include <limits>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <iostream>
+#include <fstream>
+
+// Synthetic graph models and a streaming writer for them.
+//
+// A model splits its edges into chunks, and chunk c is generated from its own
+// random stream seeded by (seed, c). The output therefore depends only on the
+// seed, never on the thread count or on the order the chunks run in. Worker
+// threads generate chunks and the writer streams them to disk:
+//   - text is formatted per chunk and written in chunk order;
+//   - binary CSR files are written in two passes, first counting degrees and
+//     then scattering edges into the memory-mapped output file.
+// Memory use is O(nodes) plus one chunk per thread, never O(edges).
+
+// One undirected edge; the writer stores it in both directions
+struct GeneratedEdge {
+    int from;
+    int to;
+    double weight;
+};
+
+// Independent random stream for one chunk of one generation step
+inline std::mt19937_64 chunkStream(uint64_t seed, uint32_t step, uint64_t chunk) {
+    std::seed_seq sequence{(uint32_t)seed, (uint32_t)(seed >> 32), step,
+                           (uint32_t)chunk, (uint32_t)(chunk >> 32)};
+    return std::mt19937_64(sequence);
+}
+
+class GraphModel {
+public:
+    static constexpr int NODE_CHUNK = 1 << 16;  // Nodes per chunk for node-driven models
+    static constexpr int EDGE_CHUNK = 1 << 18;  // Edges per chunk for edge-driven models
+
+    virtual ~GraphModel() {}
+
+    virtual int getNodeCount() const = 0;
+    virtual long long getChunkCount() const = 0;
+
+    // Append the edges of one chunk. Must be deterministic and safe to call
+    // concurrently for different chunks.
+    virtual void generateChunk(long long chunk, std::vector<GeneratedEdge>& edges) const = 0;
+
+    // Per-node state the chunks depend on (e.g. point positions)
+    virtual void prepare(int threads) { (void)threads; }
+
+    virtual bool hasCoordinates() const { return false; }
+    virtual void getCoordinates(int node, double& x, double& y) const {
+        (void)node;
+        x = y = 0.0;
+    }
+};
+
+// Random connected graph: a random spanning tree (node i attaches to a
+// uniformly chosen earlier node) plus uniformly random extra edges.
+// Like the original generator, edgeCount counts each tree edge once and
+// each extra edge in both directions.
+class RandomGraphModel : public GraphModel {
+private:
+    int nodeCount;
+    long long extraEdges;
+    uint64_t seed;
+    double minWeight;
+    double maxWeight;
+    long long treeChunks;
+    std::vector<double> xCoords;
+    std::vector<double> yCoords;
+
+public:
+    RandomGraphModel(int nodes, long long edgeCount, uint64_t randomSeed,
+                     double minW = 1.0, double maxW = 100.0)
+        : nodeCount(nodes), seed(randomSeed), minWeight(minW), maxWeight(maxW) {
+        long long remaining = std::max(0LL, edgeCount - (nodes - 1));
+        extraEdges = (remaining + 1) / 2;
+        treeChunks = (nodes - 1 + NODE_CHUNK - 1) / NODE_CHUNK;
+    }
+
+    int getNodeCount() const override { return nodeCount; }
+
+    long long getChunkCount() const override {
+        return treeChunks + (extraEdges + EDGE_CHUNK - 1) / EDGE_CHUNK;
+    }
+
+    // Random coordinates for every node (for the A* heuristic)
+    void prepare(int threads) override {
+        xCoords.assign(nodeCount, 0.0);
+        yCoords.assign(nodeCount, 0.0);
+        long long chunks = (nodeCount + NODE_CHUNK - 1) / NODE_CHUNK;
+        parallelFor(chunks, threads, [&](long long chunk, int) {
+            std::mt19937_64 gen = chunkStream(seed, 0, chunk);
+            std::uniform_real_distribution<double> coordDist(0.0, 1000.0);
+            int end = (int)std::min<long long>(nodeCount, (chunk + 1) * NODE_CHUNK);
+            for (int i = chunk * NODE_CHUNK; i < end; i++) {
+                xCoords[i] = coordDist(gen);
+                yCoords[i] = coordDist(gen);
+            }
+        });
+    }
+
+    void generateChunk(long long chunk, std::vector<GeneratedEdge>& edges) const override {
+        std::uniform_real_distribution<double> weightDist(minWeight, maxWeight);
+
+        if (chunk < treeChunks) {
+            // Spanning tree edges for nodes [begin, end)
+            std::mt19937_64 gen = chunkStream(seed, 1, chunk);
+            int begin = 1 + chunk * NODE_CHUNK;
+            int end = (int)std::min<long long>(nodeCount, begin + (long long)NODE_CHUNK);
+            for (int i = begin; i < end; i++) {
+                int parent = std::uniform_int_distribution<int>(0, i - 1)(gen);
+                edges.push_back({parent, i, weightDist(gen)});
+            }
+            return;
+        }
+
+        long long extraChunk = chunk - treeChunks;
+        std::mt19937_64 gen = chunkStream(seed, 2, extraChunk);
+        std::uniform_int_distribution<int> nodeDist(0, nodeCount - 1);
+        long long count = std::min<long long>(EDGE_CHUNK, extraEdges - extraChunk * EDGE_CHUNK);
+        for (long long e = 0; e < count; e++) {
+            int from, to;
+            do {
+                from = nodeDist(gen);
+                to = nodeDist(gen);
+            } while (from == to);  // Avoid self-loops
+            edges.push_back({from, to, weightDist(gen)});
+        }
+    }
+
+    bool hasCoordinates() const override { return true; }
+    void getCoordinates(int node, double& x, double& y) const override {
+        x = xCoords[node];
+        y = yCoords[node];
+    }
+};
+
+// 4-connected grid with unit spacing of 10 (useful for testing)
+class GridGraphModel : public GraphModel {
+private:
+    int rows;
+    int cols;
+    double edgeWeight;
+
+public:
+    GridGraphModel(int gridRows, int gridCols, double weight = 1.0)
+        : rows(gridRows), cols(gridCols), edgeWeight(weight) {}
+
+    int getNodeCount() const override { return rows * cols; }
+
+    long long getChunkCount() const override {
+        long long rowsPerChunk = std::max(1, NODE_CHUNK / cols);
+        return (rows + rowsPerChunk - 1) / rowsPerChunk;
+    }
+
+    void generateChunk(long long chunk, std::vector<GeneratedEdge>& edges) const override {
+        long long rowsPerChunk = std::max(1, NODE_CHUNK / cols);
+        int rowBegin = chunk * rowsPerChunk;
+        int rowEnd = (int)std::min<long long>(rows, rowBegin + rowsPerChunk);
+        for (int r = rowBegin; r < rowEnd; r++) {
+            for (int c = 0; c < cols; c++) {
+                int nodeId = r * cols + c;
+                if (c < cols - 1) {
+                    edges.push_back({nodeId, nodeId + 1, edgeWeight});     // Right neighbor
+                }
+                if (r < rows - 1) {
+                    edges.push_back({nodeId, nodeId + cols, edgeWeight});  // Bottom neighbor
+                }
+            }
+        }
+    }
+
+    bool hasCoordinates() const override { return true; }
+    void getCoordinates(int node, double& x, double& y) const override {
+        x = (node % cols) * 10.0;
+        y = (node / cols) * 10.0;
+    }
+};
+
+// R-MAT (recursive matrix, the Graph500 Kronecker generator): 2^scale nodes
+// and edgeFactor * 2^scale edges. Each edge picks one quadrant of the
+// adjacency matrix per level with probabilities a, b, c and d = 1 - a - b - c,
+// which gives a skewed, power-law-like degree distribution. Node ids are
+// scrambled by a seeded bijection so the hubs are spread over the id range
+// (and over contiguous partitions). The graph is usually not connected.
+class RmatGraphModel : public GraphModel {
+private:
+    int scale;
+    long long edgeCount;
+    double a, b, c;
+    uint64_t seed;
+    double minWeight;
+    double maxWeight;
+    uint64_t scrambleMultiplier;
+    uint64_t scrambleOffset;
+
+    int scramble(uint64_t node) const {
+        uint64_t mask = (uint64_t(1) << scale) - 1;
+        return (int)((node * scrambleMultiplier + scrambleOffset) & mask);
+    }
+
+public:
+    RmatGraphModel(int rmatScale, int edgeFactor, uint64_t randomSeed,
+                   double pa = 0.57, double pb = 0.19, double pc = 0.19,
+                   double minW = 1.0, double maxW = 100.0)
+        : scale(rmatScale), edgeCount((long long)edgeFactor << rmatScale),
+          a(pa), b(pb), c(pc), seed(randomSeed), minWeight(minW), maxWeight(maxW) {
+        std::mt19937_64 gen = chunkStream(seed, 0, 0);
+        scrambleMultiplier = gen() | 1;  // Odd, so multiplication mod 2^scale is a bijection
+        scrambleOffset = gen();
+    }
+
+    int getNodeCount() const override { return 1 << scale; }
+
+    long long getChunkCount() const override {
+        return (edgeCount + EDGE_CHUNK - 1) / EDGE_CHUNK;
+    }
+
+    void generateChunk(long long chunk, std::vector<GeneratedEdge>& edges) const override {
+        std::mt19937_64 gen = chunkStream(seed, 1, chunk);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::uniform_real_distribution<double> weightDist(minWeight, maxWeight);
+        long long count = std::min<long long>(EDGE_CHUNK, edgeCount - chunk * EDGE_CHUNK);
+
+        for (long long e = 0; e < count; e++) {
+            uint64_t from, to;
+            do {
+                from = to = 0;
+                for (int level = 0; level < scale; level++) {
+                    double p = unit(gen);
+                    int row = (p >= a + b) ? 1 : 0;
+                    int col = (p >= a && p < a + b) || p >= a + b + c ? 1 : 0;
+                    from = (from << 1) | row;
+                    to = (to << 1) | col;
+                }
+            } while (from == to);  // Avoid self-loops
+            edges.push_back({scramble(from), scramble(to), weightDist(gen)});
+        }
+    }
+};
+
+// Road-like geometric graph: points uniform in [0, 1000]^2, each connected
+// to its k nearest neighbours. An edge weighs its Euclidean length times a
+// detour factor in [1, maxDetour), so the coordinates remain an admissible
+// A* heuristic. Mutual neighbours are connected once.
+class KnnGraphModel : public GraphModel {
+private:
+    int nodeCount;
+    int k;
+    uint64_t seed;
+    double maxDetour;
+    std::vector<double> xCoords;
+    std::vector<double> yCoords;
+
+    // Uniform grid of cells with about two points each
+    int gridSize;
+    double cellSize;
+    std::vector<int> cellStart;  // gridSize^2 + 1 entries
+    std::vector<int> cellNodes;  // Nodes sorted by cell
+
+    // The k-th nearest neighbour of every node, by (distance, id)
+    std::vector<double> kthDistance;
+    std::vector<int> kthNode;
+
+    int cellCoord(double value) const {
+        return std::min(gridSize - 1, std::max(0, (int)(value / cellSize)));
+    }
+
+    double distance(int u, int v) const {
+        return std::hypot(xCoords[u] - xCoords[v], yCoords[u] - yCoords[v]);
+    }
+
+    // k nearest neighbours of u ordered by (distance, id), searching rings
+    // of cells outwards until no unvisited cell can hold a closer point
+    void nearest(int u, std::vector<std::pair<double, int>>& best) const {
+        best.clear();
+        int cx = cellCoord(xCoords[u]);
+        int cy = cellCoord(yCoords[u]);
+
+        for (int ring = 0; ring < gridSize; ring++) {
+            for (int gy = cy - ring; gy <= cy + ring; gy++) {
+                if (gy < 0 || gy >= gridSize) {
+                    continue;
+                }
+                bool edgeRow = (gy == cy - ring || gy == cy + ring);
+                int step = edgeRow ? 1 : std::max(1, 2 * ring);
+                for (int gx = cx - ring; gx <= cx + ring; gx += step) {
+                    if (gx < 0 || gx >= gridSize) {
+                        continue;
+                    }
+                    int cell = gy * gridSize + gx;
+                    for (int i = cellStart[cell]; i < cellStart[cell + 1]; i++) {
+                        int v = cellNodes[i];
+                        if (v == u) {
+                            continue;
+                        }
+                        std::pair<double, int> candidate(distance(u, v), v);
+                        if ((int)best.size() < k) {
+                            best.push_back(candidate);
+                            std::push_heap(best.begin(), best.end());
+                        } else if (candidate < best.front()) {
+                            std::pop_heap(best.begin(), best.end());
+                            best.back() = candidate;
+                            std::push_heap(best.begin(), best.end());
+                        }
+                    }
+                }
+            }
+            // Points beyond this ring are at least ring * cellSize away
+            if ((int)best.size() == k && best.front().first <= ring * cellSize) {
+                break;
+            }
+        }
+        std::sort_heap(best.begin(), best.end());
+    }
+
+    // Deterministic detour factor of the undirected edge {u, v}
+    double detour(int u, int v) const {
+        uint64_t h = seed ^ ((uint64_t)std::min(u, v) << 32 | (uint32_t)std::max(u, v));
+        h += 0x9e3779b97f4a7c15ULL;  // splitmix64
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return 1.0 + (maxDetour - 1.0) * ((h >> 11) * (1.0 / 9007199254740992.0));
+    }
+
+public:
+    KnnGraphModel(int nodes, int neighbours, uint64_t randomSeed, double detourLimit = 1.5)
+        : nodeCount(nodes), k(std::min(neighbours, nodes - 1)), seed(randomSeed),
+          maxDetour(detourLimit), gridSize(1), cellSize(1000.0) {}
+
+    int getNodeCount() const override { return nodeCount; }
+
+    long long getChunkCount() const override {
+        return (nodeCount + NODE_CHUNK - 1) / NODE_CHUNK;
+    }
+
+    void prepare(int threads) override {
+        long long chunks = getChunkCount();
+
+        xCoords.assign(nodeCount, 0.0);
+        yCoords.assign(nodeCount, 0.0);
+        parallelFor(chunks, threads, [&](long long chunk, int) {
+            std::mt19937_64 gen = chunkStream(seed, 0, chunk);
+            std::uniform_real_distribution<double> coordDist(0.0, 1000.0);
+            int end = (int)std::min<long long>(nodeCount, (chunk + 1) * NODE_CHUNK);
+            for (int i = chunk * NODE_CHUNK; i < end; i++) {
+                xCoords[i] = coordDist(gen);
+                yCoords[i] = coordDist(gen);
+            }
+        });
+
+        // Bucket the points by cell (counting sort keeps each cell in id order)
+        gridSize = std::max(1, (int)std::sqrt(nodeCount / 2.0));
+        cellSize = 1000.0 / gridSize;
+        int cellCount = gridSize * gridSize;
+        std::vector<int> cellOf(nodeCount);
+        cellStart.assign(cellCount + 1, 0);
+        for (int u = 0; u < nodeCount; u++) {
+            cellOf[u] = cellCoord(yCoords[u]) * gridSize + cellCoord(xCoords[u]);
+            cellStart[cellOf[u] + 1]++;
+        }
+        for (int cell = 0; cell < cellCount; cell++) {
+            cellStart[cell + 1] += cellStart[cell];
+        }
+        cellNodes.assign(nodeCount, 0);
+        std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+        for (int u = 0; u < nodeCount; u++) {
+            cellNodes[fill[cellOf[u]]++] = u;
+        }
+
+        kthDistance.assign(nodeCount, 0.0);
+        kthNode.assign(nodeCount, -1);
+        if (k <= 0) {
+            return;
+        }
+        parallelFor(chunks, threads, [&](long long chunk, int) {
+            std::vector<std::pair<double, int>> best;
+            int end = (int)std::min<long long>(nodeCount, (chunk + 1) * NODE_CHUNK);
+            for (int u = chunk * NODE_CHUNK; u < end; u++) {
+                nearest(u, best);
+                kthDistance[u] = best.back().first;
+                kthNode[u] = best.back().second;
+            }
+        });
+    }
+
+    void generateChunk(long long chunk, std::vector<GeneratedEdge>& edges) const override {
+        if (k <= 0) {
+            return;
+        }
+        std::vector<std::pair<double, int>> best;
+        int end = (int)std::min<long long>(nodeCount, (chunk + 1) * NODE_CHUNK);
+        for (int u = chunk * NODE_CHUNK; u < end; u++) {
+            nearest(u, best);
+            for (const std::pair<double, int>& neighbour : best) {
+                int v = neighbour.second;
+                // If u is also among v's neighbours the edge belongs to the smaller id
+                bool mutual = std::make_pair(neighbour.first, u) <=
+                              std::make_pair(kthDistance[v], kthNode[v]);
+                if (mutual && v < u) {
+                    continue;
+                }
+                edges.push_back({u, v, neighbour.first * detour(u, v)});
+            }
+        }
+    }
+
+    bool hasCoordinates() const override { return true; }
+    void getCoordinates(int node, double& x, double& y) const override {
+        x = xCoords[node];
+        y = yCoords[node];
+    }
+};
+
+// Graph text format ("n m" then "u v w" per edge), streamed chunk by chunk.
+// The edge count is only known at the end, so the header reserves room for
+// it and is rewritten last.
+inline bool writeTextGraph(const GraphModel& model, const std::string& filename,
+                           int threads, long long& edgeCount) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot create file " << filename << std::endl;
+        return false;
+    }
+    const int HEADER_BYTES = 32;
+    file << std::string(HEADER_BYTES - 1, ' ') << "\n";
+
+    // Chunks are formatted in parallel in batches and written in order
+    long long chunkCount = model.getChunkCount();
+    long long batchSize = std::max(1, threads) * 2LL;
+    std::vector<std::string> text(batchSize);
+    std::vector<long long> counts(batchSize);
+    std::vector<std::vector<GeneratedEdge>> edges(std::max(1, threads));
+    edgeCount = 0;
+
+    for (long long first = 0; first < chunkCount; first += batchSize) {
+        long long batch = std::min(batchSize, chunkCount - first);
+        parallelFor(batch, threads, [&](long long slot, int t) {
+            std::vector<GeneratedEdge>& chunkEdges = edges[t];
+            chunkEdges.clear();
+            model.generateChunk(first + slot, chunkEdges);
+
+            std::string& out = text[slot];
+            out.clear();
+            char line[64];
+            for (const GeneratedEdge& edge : chunkEdges) {
+                out.append(line, std::snprintf(line, sizeof(line), "%d %d %g\n", edge.from, edge.to, edge.weight));
+                out.append(line, std::snprintf(line, sizeof(line), "%d %d %g\n", edge.to, edge.from, edge.weight));
+            }
+            counts[slot] = 2LL * chunkEdges.size();
+        });
+        for (long long slot = 0; slot < batch; slot++) {
+            file.write(text[slot].data(), text[slot].size());
+            edgeCount += counts[slot];
+        }
+    }
+
+    if (edgeCount > std::numeric_limits<int>::max()) {
+        std::cerr << "Error: " << edgeCount << " edges do not fit the text format's int edge count" << std::endl;
+        return false;
+    }
+    file.seekp(0);
+    file << model.getNodeCount() << " " << edgeCount;
+    if (!file) {
+        std::cerr << "Error: Failed writing " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Binary CSR format (see BinaryGraphFormat.h), written through a shared
+// mapping of the output file: one pass counts degrees, a second pass
+// regenerates the chunks and scatters each edge into its row. Rows are then
+// sorted by target so the file does not depend on thread timing. Graphs
+// with more than 2^31 - 1 edges get 64-bit offsets.
+inline bool writeBinaryGraph(const GraphModel& model, const std::string& filename,
+                             int threads, long long& edgeCount) {
+    int nodeCount = model.getNodeCount();
+    std::vector<std::vector<GeneratedEdge>> edges(std::max(1, threads));
+    long long chunkCount = model.getChunkCount();
+
+    // Pass 1: degrees
+    std::vector<std::atomic<long long>> cursor(nodeCount);
+    parallelFor(chunkCount, threads, [&](long long chunk, int t) {
+        std::vector<GeneratedEdge>& chunkEdges = edges[t];
+        chunkEdges.clear();
+        model.generateChunk(chunk, chunkEdges);
+        for (const GeneratedEdge& edge : chunkEdges) {
+            cursor[edge.from].fetch_add(1, std::memory_order_relaxed);
+            cursor[edge.to].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    edgeCount = 0;
+    for (int u = 0; u < nodeCount; u++) {
+        edgeCount += cursor[u].load(std::memory_order_relaxed);
+    }
+    bool wideOffsets = edgeCount > std::numeric_limits<int32_t>::max();
+
+    BinaryGraphHeader header;
+    header.nodeCount = nodeCount;
+    header.edgeCount = edgeCount;
+    header.setLayout(wideOffsets ? EdgeIndexType::UInt64 : EdgeIndexType::Int32, WeightType::Float64);
+    if (model.hasCoordinates()) {
+        header.flags |= BinaryGraphFormat::HAS_COORDINATES;
+    }
+    header.payloadBytes = header.expectedPayloadBytes();
+    size_t fileBytes = sizeof(BinaryGraphHeader) + header.payloadBytes;
+
+    int fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot create file " << filename << std::endl;
+        return false;
+    }
+    // A fresh file reads as zeros, which covers the section padding
+    if (ftruncate(fd, fileBytes) != 0) {
+        std::cerr << "Error: Cannot size file " << filename << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, fileBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Error: Cannot mmap file " << filename << std::endl;
+        return false;
+    }
+    unsigned char* base = static_cast<unsigned char*>(mapped);
+    int32_t* targets = reinterpret_cast<int32_t*>(base + header.targetsPos());
+    double* weights = reinterpret_cast<double*>(base + header.weightsPos());
+
+    // Offsets; the degree counters become each row's fill cursor
+    std::vector<long long> offsets(nodeCount + 1, 0);
+    for (int u = 0; u < nodeCount; u++) {
+        long long degree = cursor[u].load(std::memory_order_relaxed);
+        cursor[u].store(offsets[u], std::memory_order_relaxed);
+        offsets[u + 1] = offsets[u] + degree;
+    }
+    for (int u = 0; u <= nodeCount; u++) {
+        if (wideOffsets) {
+            reinterpret_cast<uint64_t*>(base + header.offsetsPos())[u] = offsets[u];
+        } else {
+            reinterpret_cast<int32_t*>(base + header.offsetsPos())[u] = (int32_t)offsets[u];
+        }
+    }
+
+    // Pass 2: scatter both directions of every edge
+    parallelFor(chunkCount, threads, [&](long long chunk, int t) {
+        std::vector<GeneratedEdge>& chunkEdges = edges[t];
+        chunkEdges.clear();
+        model.generateChunk(chunk, chunkEdges);
+        for (const GeneratedEdge& edge : chunkEdges) {
+            long long slot = cursor[edge.from].fetch_add(1, std::memory_order_relaxed);
+            targets[slot] = edge.to;
+            weights[slot] = edge.weight;
+            slot = cursor[edge.to].fetch_add(1, std::memory_order_relaxed);
+            targets[slot] = edge.from;
+            weights[slot] = edge.weight;
+        }
+    });
+    std::vector<std::atomic<long long>>().swap(cursor);
+
+    long long rowChunks = (nodeCount + GraphModel::NODE_CHUNK - 1) / GraphModel::NODE_CHUNK;
+    parallelFor(rowChunks, threads, [&](long long chunk, int) {
+        std::vector<std::pair<int32_t, double>> row;
+        int end = (int)std::min<long long>(nodeCount, (chunk + 1) * GraphModel::NODE_CHUNK);
+        for (int u = chunk * GraphModel::NODE_CHUNK; u < end; u++) {
+            row.clear();
+            for (long long e = offsets[u]; e < offsets[u + 1]; e++) {
+                row.emplace_back(targets[e], weights[e]);
+            }
+            std::sort(row.begin(), row.end());
+            for (size_t i = 0; i < row.size(); i++) {
+                targets[offsets[u] + i] = row[i].first;
+                weights[offsets[u] + i] = row[i].second;
+            }
+        }
+    });
+
+    if (model.hasCoordinates()) {
+        double* xCoords = reinterpret_cast<double*>(base + header.xCoordsPos());
+        double* yCoords = reinterpret_cast<double*>(base + header.yCoordsPos());
+        for (int u = 0; u < nodeCount; u++) {
+            model.getCoordinates(u, xCoords[u], yCoords[u]);
+        }
+    }
+
+    PayloadChecksum checksum;
+    checksum.update(base + sizeof(BinaryGraphHeader), header.payloadBytes);
+    header.checksum = checksum.finish();
+    std::memcpy(base, &header, sizeof(header));
+
+    bool ok = msync(mapped, fileBytes, MS_SYNC) == 0;
+    munmap(mapped, fileBytes);
+    if (!ok) {
+        std::cerr << "Error: Failed writing " << filename << std::endl;
+    }
+    return ok;
+}
+
+#endif
@@ -0,0 +1,560 @@
+#ifndef GRAPH_SHARD_H
+#define GRAPH_SHARD_H
+
+#include "CSRGraph.h"
+#include "Partitioner.h"
+#include <vector>
+#include <unordered_map>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+
+// One rank's slice of the graph in a compact local index space.
+//
+// Slots [0, ownedCount) are the nodes this rank owns, in PartitionMap local
+// index order. Slots [ownedCount, slotCount) are ghosts: remote nodes that
+// are targets of an owned node's edges. Edge targets are stored as slots,
+// so solvers index a slotCount-sized distance array directly and never see
+// global IDs in the relaxation loop. Memory is O(V/p + E/p + ghosts).
+//
+// Weight is the stored weight type, as in BasicCSRGraph; the whole graph
+// may exceed 2^31 edges, but each rank's share is indexed with int.
+template <typename WeightT>
+class BasicGraphShard {
+public:
+    using Weight = WeightT;
+
+private:
+    int globalNodeCount;
+    long long globalEdgeCount;
+    int ownedCount;
+    std::vector<int> ownedIds;     // Owned slot -> global ID
+    std::vector<int> ghostIds;     // Ghost slot - ownedCount -> global ID
+    std::vector<int> ghostOwners;  // Ghost slot - ownedCount -> owner rank
+    std::vector<int> offsets;      // ownedCount + 1 entries
+    std::vector<int> targets;      // Slot of each edge target
+    std::vector<Weight> weights;
+    std::vector<char> boundary;    // Owned slot -> has an edge to a ghost
+
+    // Lookups for edge updates, built by prepareUpdates() on first use
+    std::unordered_map<int, int> ghostLookup;  // Global ID -> ghost slot
+    std::vector<int> incomingOffsets;          // slotCount + 1 entries
+    std::vector<int> incomingSources;          // Owned slots with an edge to each slot
+    bool incomingStale = true;
+
+    // Rewrite edge targets from global IDs to slots, assigning ghost slots
+    // to remote targets in first-seen order
+    void assignSlots(const PartitionMap& partition, int myRank) {
+        // Global ID -> ghost slot, only needed while building
+        std::unordered_map<int, int> ghostSlots;
+        ghostIds.clear();
+        ghostOwners.clear();
+
+        for (int& target : targets) {
+            int v = target;
+            int owner = partition.getOwner(v);
+            if (owner == myRank) {
+                target = partition.getLocalIndex(v);
+                continue;
+            }
+
+            auto it = ghostSlots.find(v);
+            if (it == ghostSlots.end()) {
+                int ghostSlot = ownedCount + ghostIds.size();
+                it = ghostSlots.emplace(v, ghostSlot).first;
+                ghostIds.push_back(v);
+                ghostOwners.push_back(owner);
+            }
+            target = it->second;
+        }
+        markBoundary();
+    }
+
+    void markBoundary() {
+        boundary.assign(ownedCount, 0);
+        for (int u = 0; u < ownedCount; u++) {
+            markBoundaryRow(u);
+        }
+    }
+
+    void markBoundaryRow(int u) {
+        boundary[u] = 0;
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            if (targets[e] >= ownedCount) {
+                boundary[u] = 1;
+                break;
+            }
+        }
+    }
+
+    // Read exactly `bytes` bytes at `offset`
+    static bool readAt(int fd, void* buffer, size_t bytes, uint64_t offset) {
+        char* p = static_cast<char*>(buffer);
+        while (bytes > 0) {
+            ssize_t got = pread(fd, p, bytes, offset);
+            if (got <= 0) {
+                return false;
+            }
+            p += got;
+            bytes -= got;
+            offset += got;
+        }
+        return true;
+    }
+
+    // Read one rank's rows directly from a binary graph file.
+    // Row ranges of consecutive owned nodes are coalesced into reads of up
+    // to READ_CHUNK bytes, so a contiguous partition becomes a few large
+    // sequential reads and only the owned slice of every section is kept.
+    // The payload checksum is not verified because no rank reads it all;
+    // instead the owned rows' offsets and targets are range-checked, so a
+    // damaged file fails here rather than in the solver.
+    bool loadBinaryShard(const std::string& filename, const PartitionMap& partition, int myRank) {
+        const uint64_t READ_CHUNK = 4 << 20;
+
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Error: Cannot open file " << filename << std::endl;
+            return false;
+        }
+
+        BinaryGraphHeader header;
+        if (!readAt(fd, &header, sizeof(header), 0) || !header.hasMagic() ||
+            header.endianTag != BinaryGraphFormat::ENDIAN_TAG ||
+            !header.isSupportedVersion() ||
+            header.nodeCount != (uint64_t)partition.getNodeCount()) {
+            std::cerr << "Error: " << filename << " has an unsupported or mismatched header" << std::endl;
+            ::close(fd);
+            return false;
+        }
+
+        globalNodeCount = header.nodeCount;
+        globalEdgeCount = header.edgeCount;
+        ownedIds = partition.getOwnedNodes(myRank);
+        ownedCount = ownedIds.size();
+
+        // Row bounds [begin, end) of every owned node, read from the offsets
+        // section in chunks that cover runs of owned nodes
+        const size_t indexBytes = getEdgeIndexBytes(header.getEdgeIndexType());
+        const size_t weightBytes = getWeightBytes(header.getWeightType());
+        std::vector<uint64_t> rowBegin(ownedCount), rowEnd(ownedCount);
+        std::vector<uint64_t> chunk;
+        std::vector<char> raw;
+        int i = 0;
+        while (i < ownedCount) {
+            int first = ownedIds[i];
+            int last = first;
+            int j = i;
+            while (j < ownedCount &&
+                   (uint64_t)(ownedIds[j] + 1 - first) * indexBytes <= READ_CHUNK) {
+                last = ownedIds[j];
+                j++;
+            }
+            chunk.resize(last - first + 2);
+            raw.resize(chunk.size() * indexBytes);
+            if (!readAt(fd, raw.data(), raw.size(), header.offsetsPos() + (uint64_t)first * indexBytes)) {
+                std::cerr << "Error: Truncated offsets in " << filename << std::endl;
+                ::close(fd);
+                return false;
+            }
+            decodeEdgeIndices(raw.data(), header.getEdgeIndexType(), chunk.size(), chunk.data());
+            for (int k = i; k < j; k++) {
+                rowBegin[k] = chunk[ownedIds[k] - first];
+                rowEnd[k] = chunk[ownedIds[k] - first + 1];
+            }
+            i = j;
+        }
+
+        // Owned rows are in ID order, so their ranges must not overlap
+        uint64_t previousEnd = 0;
+        for (int k = 0; k < ownedCount; k++) {
+            if (rowBegin[k] < previousEnd || rowEnd[k] < rowBegin[k] || rowEnd[k] > header.edgeCount) {
+                std::cerr << "Error: " << filename << " has invalid edge offsets for node "
+                          << ownedIds[k] << std::endl;
+                ::close(fd);
+                return false;
+            }
+            previousEnd = rowEnd[k];
+        }
+
+        uint64_t localEdges = 0;
+        for (int k = 0; k < ownedCount; k++) {
+            localEdges += rowEnd[k] - rowBegin[k];
+        }
+        if (localEdges > (uint64_t)std::numeric_limits<int>::max()) {
+            std::cerr << "Error: Rank " << myRank << " would own " << localEdges
+                      << " edges of " << filename << "; use more ranks" << std::endl;
+            ::close(fd);
+            return false;
+        }
+        offsets.assign(ownedCount + 1, 0);
+        for (int k = 0; k < ownedCount; k++) {
+            offsets[k + 1] = offsets[k] + (int)(rowEnd[k] - rowBegin[k]);
+        }
+        targets.resize(offsets[ownedCount]);
+        weights.resize(offsets[ownedCount]);
+
+        // Copy owned rows of the targets and weights sections
+        std::vector<int> targetChunk;
+        std::vector<Weight> weightChunk;
+        i = 0;
+        while (i < ownedCount) {
+            uint64_t first = rowBegin[i];
+            int j = i;
+            while (j < ownedCount &&
+                   (rowEnd[j] - first) * sizeof(double) <= READ_CHUNK) {
+                j++;
+            }
+            if (j == i) {
+                j = i + 1;  // A single row larger than a chunk is read whole
+            }
+            uint64_t last = rowEnd[j - 1];
+
+            targetChunk.resize(last - first);
+            weightChunk.resize(last - first);
+            raw.resize(weightChunk.size() * weightBytes);
+            if (!readAt(fd, targetChunk.data(), targetChunk.size() * sizeof(int32_t),
+                        header.targetsPos() + first * sizeof(int32_t)) ||
+                !readAt(fd, raw.data(), raw.size(), header.weightsPos() + first * weightBytes)) {
+                std::cerr << "Error: Truncated edge data in " << filename << std::endl;
+                ::close(fd);
+                return false;
+            }
+            if (!decodeWeights(raw.data(), header.getWeightType(), weightChunk.size(), weightChunk.data())) {
+                std::cerr << "Error: " << filename << " has " << getWeightTypeName(header.getWeightType())
+                          << " weights that do not fit " << getWeightTypeName(WeightTraits<Weight>::TYPE)
+                          << std::endl;
+                ::close(fd);
+                return false;
+            }
+            for (int k = i; k < j; k++) {
+                std::copy(targetChunk.begin() + (rowBegin[k] - first),
+                          targetChunk.begin() + (rowEnd[k] - first),
+                          targets.begin() + offsets[k]);
+                std::copy(weightChunk.begin() + (rowBegin[k] - first),
+                          weightChunk.begin() + (rowEnd[k] - first),
+                          weights.begin() + offsets[k]);
+            }
+            i = j;
+        }
+
+        ::close(fd);
+        for (int k = 0; k < ownedCount; k++) {
+            for (int e = offsets[k]; e < offsets[k + 1]; e++) {
+                if (targets[e] < 0 || targets[e] >= globalNodeCount) {
+                    std::cerr << "Error: " << filename << " has edge " << ownedIds[k] << " -> "
+                              << targets[e] << " outside the graph" << std::endl;
+                    return false;
+                }
+            }
+        }
+        assignSlots(partition, myRank);
+        return true;
+    }
+
+    // Stream a text edge list and keep only edges whose source is owned.
+    // Every rank still parses the whole file, but memory stays O(E/p).
+    bool loadTextShard(const std::string& filename, const PartitionMap& partition, int myRank) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot open file " << filename << std::endl;
+            return false;
+        }
+
+        long long numNodes, numEdges;
+        if (!(file >> numNodes >> numEdges) || numNodes != partition.getNodeCount()) {
+            std::cerr << "Error: Invalid header in " << filename << std::endl;
+            return false;
+        }
+
+        globalNodeCount = numNodes;
+        globalEdgeCount = 0;
+        ownedIds = partition.getOwnedNodes(myRank);
+        ownedCount = ownedIds.size();
+
+        std::vector<int> from, to;
+        std::vector<Weight> edgeWeights;
+        for (long long i = 0; i < numEdges; i++) {
+            int u, v;
+            double weight;
+            if (!(file >> u >> v >> weight)) {
+                std::cerr << "Error: Truncated edge list in " << filename << std::endl;
+                return false;
+            }
+            if (u < 0 || u >= numNodes || v < 0 || v >= numNodes) {
+                continue;
+            }
+            globalEdgeCount++;
+            if (partition.getOwner(u) == myRank) {
+                Weight stored;
+                if (!WeightTraits<Weight>::convert(weight, stored)) {
+                    std::cerr << "Error: Weight " << weight << " of edge " << u << " -> " << v
+                              << " does not fit " << getWeightTypeName(WeightTraits<Weight>::TYPE)
+                              << " weights" << std::endl;
+                    return false;
+                }
+                from.push_back(partition.getLocalIndex(u));
+                to.push_back(v);
+                edgeWeights.push_back(stored);
+            }
+        }
+
+        // Stable counting sort by owned slot, as in CSRGraph
+        offsets.assign(ownedCount + 1, 0);
+        for (int u : from) {
+            offsets[u + 1]++;
+        }
+        for (int k = 0; k < ownedCount; k++) {
+            offsets[k + 1] += offsets[k];
+        }
+        targets.resize(from.size());
+        weights.resize(from.size());
+        std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t k = 0; k < from.size(); k++) {
+            int slot = cursor[from[k]]++;
+            targets[slot] = to[k];
+            weights[slot] = edgeWeights[k];
+        }
+
+        assignSlots(partition, myRank);
+        return true;
+    }
+
+public:
+    BasicGraphShard() : globalNodeCount(0), globalEdgeCount(0), ownedCount(0), offsets(1, 0) {}
+
+    // Extract the rows owned by myRank from a full graph of the same weight type
+    template <typename EdgeIndex>
+    static BasicGraphShard build(const BasicCSRGraph<EdgeIndex, Weight>& graph,
+                                 const PartitionMap& partition, int myRank) {
+        BasicGraphShard shard;
+        shard.globalNodeCount = graph.getNodeCount();
+        shard.globalEdgeCount = graph.getEdgeCount();
+        shard.ownedIds = partition.getOwnedNodes(myRank);
+        shard.ownedCount = shard.ownedIds.size();
+
+        // Size the edge arrays up front
+        shard.offsets.assign(shard.ownedCount + 1, 0);
+        for (int i = 0; i < shard.ownedCount; i++) {
+            shard.offsets[i + 1] = shard.offsets[i] + graph.getDegree(shard.ownedIds[i]);
+        }
+        shard.targets.resize(shard.offsets[shard.ownedCount]);
+        shard.weights.resize(shard.offsets[shard.ownedCount]);
+
+        for (int i = 0; i < shard.ownedCount; i++) {
+            int u = shard.ownedIds[i];
+            int slot = shard.offsets[i];
+            for (EdgeIndex e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++, slot++) {
+                shard.targets[slot] = graph.getTarget(e);
+                shard.weights[slot] = graph.getWeight(e);
+            }
+        }
+
+        shard.assignSlots(partition, myRank);
+        return shard;
+    }
+
+    // Load only this rank's rows from a graph file (binary or text)
+    bool loadFromFile(const std::string& filename, const PartitionMap& partition, int myRank) {
+        if (isBinaryGraphFile(filename)) {
+            return loadBinaryShard(filename, partition, myRank);
+        }
+        return loadTextShard(filename, partition, myRank);
+    }
+
+    // Read the node and edge counts from a graph file header without
+    // loading any edges, so the partition can be set up before loading
+    static bool readGraphSize(const std::string& filename, int& nodeCount, long long& edgeCount) {
+        if (isBinaryGraphFile(filename)) {
+            int fd = ::open(filename.c_str(), O_RDONLY);
+            BinaryGraphHeader header;
+            bool ok = fd >= 0 && readAt(fd, &header, sizeof(header), 0);
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            if (!ok || header.nodeCount > (uint64_t)std::numeric_limits<int>::max() ||
+                header.edgeCount > (uint64_t)std::numeric_limits<long long>::max()) {
+                std::cerr << "Error: Cannot read header of " << filename << std::endl;
+                return false;
+            }
+            nodeCount = header.nodeCount;
+            edgeCount = header.edgeCount;
+            return true;
+        }
+
+        std::ifstream file(filename);
+        if (!file.is_open() || !(file >> nodeCount >> edgeCount) || nodeCount < 0) {
+            std::cerr << "Error: Cannot read header of " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Original node IDs of a reordered binary graph (see NodeOrdering.h):
+    // originalIds[v] is the ID node v had before renumbering. Left empty
+    // for text files and graphs that were never reordered.
+    static bool readOriginalIds(const std::string& filename, std::vector<int>& originalIds) {
+        originalIds.clear();
+        if (!isBinaryGraphFile(filename)) {
+            return true;
+        }
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        BinaryGraphHeader header;
+        bool ok = fd >= 0 && readAt(fd, &header, sizeof(header), 0) &&
+                  header.nodeCount <= (uint64_t)std::numeric_limits<int>::max();
+        if (ok && (header.flags & BinaryGraphFormat::HAS_ORIGINAL_IDS)) {
+            std::vector<int32_t> ids(header.nodeCount);
+            ok = readAt(fd, ids.data(), ids.size() * sizeof(int32_t), header.originalIdsPos());
+            originalIds.assign(ids.begin(), ids.end());
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        if (!ok) {
+            std::cerr << "Error: Cannot read original node IDs of " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    int getGlobalNodeCount() const { return globalNodeCount; }
+    long long getGlobalEdgeCount() const { return globalEdgeCount; }
+    int getOwnedCount() const { return ownedCount; }
+    int getGhostCount() const { return ghostIds.size(); }
+    int getSlotCount() const { return ownedCount + ghostIds.size(); }
+    int getEdgeCount() const { return targets.size(); }
+
+    bool isOwnedSlot(int slot) const { return slot < ownedCount; }
+
+    // Own nodes with an edge to another rank; the others are interior and
+    // relaxing them never produces a message
+    bool isBoundarySlot(int slot) const { return boundary[slot] != 0; }
+
+    // Edges whose target lives on another rank
+    long long getCutEdgeCount() const {
+        long long cut = 0;
+        for (int target : targets) {
+            cut += (target >= ownedCount);
+        }
+        return cut;
+    }
+
+    // Global ID of any slot
+    int getGlobalId(int slot) const {
+        return slot < ownedCount ? ownedIds[slot] : ghostIds[slot - ownedCount];
+    }
+
+    // Owner rank of a ghost slot
+    int getGhostOwner(int slot) const {
+        return ghostOwners[slot - ownedCount];
+    }
+
+    // Edges of an owned slot
+    int edgeBegin(int slot) const { return offsets[slot]; }
+    int edgeEnd(int slot) const { return offsets[slot + 1]; }
+    int getTarget(int edgeIndex) const { return targets[edgeIndex]; }
+    Weight getWeight(int edgeIndex) const { return weights[edgeIndex]; }
+    const int* getTargets() const { return targets.data(); }
+    const Weight* getWeights() const { return weights.data(); }
+
+    // Edge updates on a loaded shard (see DynamicGraph.h for the update
+    // file). An update is applied by the owner of the edge's source. An
+    // edge to a remote node no owned edge reached before adds a ghost slot
+    // at the end, so existing slots keep their numbers.
+    //
+    // Build the global ID -> slot lookup and the incoming-edge index;
+    // cheap to call again, the index is only rebuilt after inserts/removals
+    void prepareUpdates() {
+        if (ghostLookup.size() != ghostIds.size()) {
+            ghostLookup.clear();
+            for (size_t i = 0; i < ghostIds.size(); i++) {
+                ghostLookup.emplace(ghostIds[i], ownedCount + i);
+            }
+        }
+        if (!incomingStale) {
+            return;
+        }
+        int slotCount = getSlotCount();
+        incomingOffsets.assign(slotCount + 1, 0);
+        for (int target : targets) {
+            incomingOffsets[target + 1]++;
+        }
+        for (int slot = 0; slot < slotCount; slot++) {
+            incomingOffsets[slot + 1] += incomingOffsets[slot];
+        }
+        incomingSources.resize(targets.size());
+        std::vector<int> cursor(incomingOffsets.begin(), incomingOffsets.end() - 1);
+        for (int u = 0; u < ownedCount; u++) {
+            for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+                incomingSources[cursor[targets[e]]++] = u;
+            }
+        }
+        incomingStale = false;
+    }
+
+    // Slot of a global node: its local index if owned, its ghost slot if an
+    // owned edge reaches it, otherwise -1. Needs prepareUpdates().
+    int findSlot(int globalId, const PartitionMap& partition, int myRank) const {
+        if (partition.getOwner(globalId) == myRank) {
+            return partition.getLocalIndex(globalId);
+        }
+        auto it = ghostLookup.find(globalId);
+        return it == ghostLookup.end() ? -1 : it->second;
+    }
+
+    // New ghost slot for a remote node; returns the slot
+    int addGhost(int globalId, int owner) {
+        int slot = ownedCount + ghostIds.size();
+        ghostIds.push_back(globalId);
+        ghostOwners.push_back(owner);
+        ghostLookup.emplace(globalId, slot);
+        incomingStale = true;
+        return slot;
+    }
+
+    void setWeight(int edgeIndex, Weight weight) {
+        weights[edgeIndex] = weight;
+    }
+
+    // Append an edge to the row of an owned slot
+    void insertEdge(int slot, int targetSlot, Weight weight) {
+        int position = offsets[slot + 1];
+        targets.insert(targets.begin() + position, targetSlot);
+        weights.insert(weights.begin() + position, weight);
+        for (int k = slot + 1; k <= ownedCount; k++) {
+            offsets[k]++;
+        }
+        if (targetSlot >= ownedCount) {
+            boundary[slot] = 1;
+        }
+        incomingStale = true;
+    }
+
+    // Remove one edge from the row of an owned slot
+    void removeEdge(int slot, int edgeIndex) {
+        targets.erase(targets.begin() + edgeIndex);
+        weights.erase(weights.begin() + edgeIndex);
+        for (int k = slot + 1; k <= ownedCount; k++) {
+            offsets[k]--;
+        }
+        markBoundaryRow(slot);
+        incomingStale = true;
+    }
+
+    // Owned slots with an edge to a slot (owned or ghost); needs prepareUpdates()
+    int incomingBegin(int slot) const { return incomingOffsets[slot]; }
+    int incomingEnd(int slot) const { return incomingOffsets[slot + 1]; }
+    int getIncomingSource(int index) const { return incomingSources[index]; }
+
+    // Approximate memory footprint in bytes
+    size_t getMemoryBytes() const {
+        return (ownedIds.size() + 2 * ghostIds.size() + offsets.size() + targets.size()) * sizeof(int) +
+               weights.size() * sizeof(Weight) + boundary.size();
+    }
+};
+
+using GraphShard = BasicGraphShard<double>;
+
+#endif
@@ -0,0 +1,258 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include "CSRGraph.h"
+#include "SearchSpace.h"
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+
+// ALT lower bounds (A*, Landmarks, Triangle inequality; Goldberg & Harrelson).
+//
+// For a landmark L with exact distances d(L, .) and d(., L), the triangle
+// inequality gives two lower bounds on d(v, t):
+//     d(L, t) - d(L, v)   and   d(v, L) - d(t, L)
+// The heuristic is the largest of these over all landmarks. Unlike the
+// Euclidean heuristic it holds for any edge weights, and it is consistent,
+// so A* settles each node once.
+//
+// Distances are stored node-major: the row of node v holds d(L_i, v) for
+// all landmarks followed by d(v, L_i), each padded with zeros to a multiple
+// of LANE_WIDTH. A bound reads two contiguous rows in one pass that the
+// compiler turns into packed subtract/max instructions (-fopenmp-simd).
+//
+// File layout (.lm, native endianness, checked by the tag):
+//   LandmarkFileHeader
+//   int    landmarks[landmarkCount]
+//   double rows[nodeCount][2 * stride]
+
+struct LandmarkFileHeader {
+    char magic[8];           // "LANDMARK"
+    uint32_t version;
+    uint32_t endianTag;
+    int64_t nodeCount;
+    int64_t sourceEdgeCount; // Edges of the graph the landmarks were computed on
+    uint64_t sourceHash;     // getContentHash() of that graph
+    int64_t landmarkCount;
+    int64_t stride;          // Padded landmark count per direction
+};
+
+class LandmarkSet {
+public:
+    // Row padding in doubles (one AVX register), so the bound loop has no
+    // scalar remainder
+    static const int LANE_WIDTH = 4;
+
+private:
+    static constexpr const char* MAGIC = "LANDMARK";
+    static const uint32_t VERSION = 2;
+    static const uint32_t ENDIAN_TAG = 0x01020304;
+
+    // Stands in for "unreachable". Any bound that involves it is either
+    // negative or belongs to a pair with no path at all, so it stays
+    // admissible, and unlike infinity it never produces inf - inf.
+    static constexpr double UNREACHABLE = 1e30;
+
+    int nodeCount;
+    long long sourceEdgeCount;
+    uint64_t sourceHash;
+    int stride;
+    std::vector<int> landmarks;
+    std::vector<double> rows;  // nodeCount * 2 * stride
+
+    // Exact distances from source to every node
+    static void shortestDistances(const CSRGraph& graph, SearchSpace<BinaryHeapQueue>& space,
+                                  int source, std::vector<double>& distances) {
+        int n = graph.getNodeCount();
+        space.prepare(n);
+        space.label(source, 0.0, -1);
+        space.pq.push(source, 0.0);
+
+        while (!space.pq.empty()) {
+            int node = space.pq.pop();
+            if (space.isSettled(node)) {
+                continue;
+            }
+            space.settle(node);
+
+            double distance = space.getDistance(node);
+            for (int e = graph.edgeBegin(node); e < graph.edgeEnd(node); e++) {
+                int neighbor = graph.getTarget(e);
+                double newDistance = distance + graph.getWeight(e);
+                if (newDistance < space.getDistance(neighbor)) {
+                    space.label(neighbor, newDistance, node);
+                    space.pq.push(neighbor, newDistance);
+                }
+            }
+        }
+
+        distances.resize(n);
+        for (int v = 0; v < n; v++) {
+            distances[v] = space.isSettled(v) ? space.getDistance(v) : UNREACHABLE;
+        }
+    }
+
+    const double* row(int node) const {
+        return &rows[(size_t)node * 2 * stride];
+    }
+
+public:
+    LandmarkSet() : nodeCount(0), sourceEdgeCount(0), sourceHash(0), stride(0) {}
+
+    // Pick count landmarks by farthest selection: start from a random node,
+    // then repeatedly add the reachable node whose distance to the closest
+    // landmark so far is largest. Landmarks end up spread over the edge of
+    // the graph, where they give the tightest bounds for most pairs.
+    static LandmarkSet build(const CSRGraph& graph, int count, unsigned seed) {
+        LandmarkSet set;
+        int n = graph.getNodeCount();
+        count = std::max(1, std::min(count, n));
+        set.nodeCount = n;
+        set.sourceEdgeCount = graph.getEdgeCount();
+        set.sourceHash = graph.getContentHash();
+        set.stride = (count + LANE_WIDTH - 1) / LANE_WIDTH * LANE_WIDTH;
+        set.rows.assign((size_t)n * 2 * set.stride, 0.0);
+
+        CSRGraph reverse = graph.getReverse();
+        SearchSpace<BinaryHeapQueue> space;
+        std::vector<double> fromLandmark, toLandmark;
+
+        std::mt19937 rng(seed);
+        int next = std::uniform_int_distribution<int>(0, n - 1)(rng);
+        std::vector<double> closest(n, UNREACHABLE);
+        shortestDistances(graph, space, next, closest);
+        closest[next] = 0.0;
+
+        for (int i = 0; i < count; i++) {
+            // Farthest reachable node from the current set
+            int farthest = -1;
+            for (int v = 0; v < n; v++) {
+                if (closest[v] < UNREACHABLE && (farthest == -1 || closest[v] > closest[farthest])) {
+                    farthest = v;
+                }
+            }
+            if (farthest == -1 || (i > 0 && closest[farthest] == 0.0)) {
+                break;  // Every reachable node is already a landmark
+            }
+            int landmark = farthest;
+            set.landmarks.push_back(landmark);
+
+            shortestDistances(graph, space, landmark, fromLandmark);
+            shortestDistances(reverse, space, landmark, toLandmark);
+            for (int v = 0; v < n; v++) {
+                double* r = &set.rows[(size_t)v * 2 * set.stride];
+                r[i] = fromLandmark[v];
+                r[set.stride + i] = toLandmark[v];
+                closest[v] = (i == 0) ? fromLandmark[v] : std::min(closest[v], fromLandmark[v]);
+            }
+        }
+        return set;
+    }
+
+    // Lower bound on the distance from -> to
+    double lowerBound(int from, int to) const {
+        const double* fromRow = row(from);
+        const double* toRow = row(to);
+        double best = 0.0;
+
+#pragma omp simd reduction(max:best)
+        for (int i = 0; i < stride; i++) {
+            double forward = toRow[i] - fromRow[i];                     // d(L, to) - d(L, from)
+            double backward = fromRow[stride + i] - toRow[stride + i];  // d(from, L) - d(to, L)
+            double bound = forward > backward ? forward : backward;
+            best = bound > best ? bound : best;
+        }
+        return best;
+    }
+
+    int getNodeCount() const { return nodeCount; }
+    int getLandmarkCount() const { return landmarks.size(); }
+    int getLandmark(int i) const { return landmarks[i]; }
+
+    size_t getMemoryBytes() const {
+        return landmarks.size() * sizeof(int) + rows.size() * sizeof(double);
+    }
+
+    // Landmarks only bound distances in the graph they were computed on
+    template <typename Graph>
+    bool matches(const Graph& graph) const {
+        return nodeCount == graph.getNodeCount() && sourceEdgeCount == (long long)graph.getEdgeCount() &&
+               sourceHash == graph.getContentHash();
+    }
+
+    bool saveToFile(const std::string& filename) const {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot create file " << filename << std::endl;
+            return false;
+        }
+
+        LandmarkFileHeader header;
+        std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.version = VERSION;
+        header.endianTag = ENDIAN_TAG;
+        header.nodeCount = nodeCount;
+        header.sourceEdgeCount = sourceEdgeCount;
+        header.sourceHash = sourceHash;
+        header.landmarkCount = landmarks.size();
+        header.stride = stride;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(landmarks.data()), landmarks.size() * sizeof(int));
+        file.write(reinterpret_cast<const char*>(rows.data()), rows.size() * sizeof(double));
+
+        if (!file) {
+            std::cerr << "Error: Failed writing " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool loadFromFile(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot open file " << filename << std::endl;
+            return false;
+        }
+
+        LandmarkFileHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file || std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0) {
+            std::cerr << "Error: " << filename << " is not a landmark file" << std::endl;
+            return false;
+        }
+        if (header.endianTag != ENDIAN_TAG || header.version != VERSION ||
+            header.stride % LANE_WIDTH != 0 || header.landmarkCount > header.stride) {
+            std::cerr << "Error: Unsupported landmark file version or layout in "
+                      << filename << std::endl;
+            return false;
+        }
+
+        nodeCount = header.nodeCount;
+        sourceEdgeCount = header.sourceEdgeCount;
+        sourceHash = header.sourceHash;
+        stride = header.stride;
+        landmarks.resize(header.landmarkCount);
+        rows.resize((size_t)nodeCount * 2 * stride);
+        file.read(reinterpret_cast<char*>(landmarks.data()), landmarks.size() * sizeof(int));
+        file.read(reinterpret_cast<char*>(rows.data()), rows.size() * sizeof(double));
+        if (!file) {
+            std::cerr << "Error: Truncated landmark file " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void printInfo() const {
+        std::cout << "Landmark Statistics:\n";
+        std::cout << "  Nodes: " << nodeCount << "\n";
+        std::cout << "  Landmarks: " << landmarks.size() << " (row stride " << stride << ")\n";
+        std::cout << "  Memory: " << getMemoryBytes() / 1024 << " KB\n";
+    }
+};
+
+#endif
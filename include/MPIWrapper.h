@@ -4,7 +4,12 @@
 #include <mpi.h>
 #include "Graph.h"
 #include <vector>
+#include <string>
 #include <iostream>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
 
 // MPI message tags
 namespace MPITags {
@@ -19,15 +24,30 @@ namespace MPITags {
     const int TERMINATE = 9;
 }
 
-// Structure for distance updates between processes
+// Structure for distance updates between processes. The sender is known
+// from the MPI status, so only the node and its candidate distance travel.
 struct DistanceUpdate {
     int nodeId;
     double distance;
-    int fromProcess;
     
-    DistanceUpdate() : nodeId(-1), distance(0.0), fromProcess(-1) {}
-    DistanceUpdate(int id, double dist, int from) 
-        : nodeId(id), distance(dist), fromProcess(from) {}
+    DistanceUpdate() : nodeId(-1), distance(0.0) {}
+    DistanceUpdate(int id, double dist) : nodeId(id), distance(dist) {}
+};
+
+// Traffic counters of one rank
+struct MessageCounters {
+    long long messagesSent = 0;
+    long long bytesSent = 0;        // Payload, as MPI packs it (no padding)
+    long long updatesOffered = 0;   // Updates handed to the send path
+    long long updatesSent = 0;      // Updates left after coalescing
+    long long messagesReceived = 0;
+    long long bytesReceived = 0;
+    long long sendStalls = 0;       // Flushes that had to wait for the previous send
+
+    // Offered updates per update actually sent (1 = nothing coalesced)
+    double coalescingRatio() const {
+        return updatesSent > 0 ? (double)updatesOffered / updatesSent : 1.0;
+    }
 };
 
 // MPI Wrapper class with helper functions
@@ -133,23 +153,43 @@ public:
         }
     }
     
+    // Committed datatype for DistanceUpdate: an int and a double, with the
+    // extent of the C++ struct so arrays of updates can be sent directly
+    static MPI_Datatype distanceUpdateType() {
+        static MPI_Datatype type = MPI_DATATYPE_NULL;
+        if (type == MPI_DATATYPE_NULL) {
+            int lengths[2] = {1, 1};
+            MPI_Aint offsets[2] = {offsetof(DistanceUpdate, nodeId), offsetof(DistanceUpdate, distance)};
+            MPI_Datatype types[2] = {MPI_INT, MPI_DOUBLE};
+            MPI_Datatype packed;
+            MPI_Type_create_struct(2, lengths, offsets, types, &packed);
+            MPI_Type_create_resized(packed, 0, sizeof(DistanceUpdate), &type);
+            MPI_Type_commit(&type);
+            MPI_Type_free(&packed);
+        }
+        return type;
+    }
+
+    // Bytes one DistanceUpdate puts on the wire
+    static int distanceUpdateBytes() {
+        int bytes;
+        MPI_Type_size(distanceUpdateType(), &bytes);
+        return bytes;
+    }
+
     // Send distance update to another process
     static void sendDistanceUpdate(
         int nodeId,
         double distance,
-        int destinationRank,
-        int myRank
+        int destinationRank
     ) {
-        DistanceUpdate update(nodeId, distance, myRank);
-        MPI_Send(&update, sizeof(DistanceUpdate), MPI_BYTE, 
+        DistanceUpdate update(nodeId, distance);
+        MPI_Send(&update, 1, distanceUpdateType(),
                  destinationRank, MPITags::DISTANCE_UPDATE, MPI_COMM_WORLD);
     }
     
     // Non-blocking receive of distance updates
-    static bool receiveDistanceUpdate(
-        DistanceUpdate& update,
-        MPI_Request* request = nullptr
-    ) {
+    static bool receiveDistanceUpdate(DistanceUpdate& update) {
         MPI_Status status;
         int flag;
         
@@ -158,7 +198,7 @@ public:
                    MPI_COMM_WORLD, &flag, &status);
         
         if (flag) {
-            MPI_Recv(&update, sizeof(DistanceUpdate), MPI_BYTE, 
+            MPI_Recv(&update, 1, distanceUpdateType(),
                      status.MPI_SOURCE, MPITags::DISTANCE_UPDATE, 
                      MPI_COMM_WORLD, &status);
             return true;
@@ -167,6 +207,57 @@ public:
         return false;
     }
     
+    // Sparse all-to-all exchange of distance updates.
+    // outgoing[r] holds the updates destined for rank r. Counts are
+    // exchanged first (one int per rank), then only ranks that actually
+    // have updates for each other talk, with DISTANCE_UPDATE messages.
+    static std::vector<DistanceUpdate> exchangeDistanceUpdates(
+        const std::vector<std::vector<DistanceUpdate>>& outgoing,
+        MessageCounters& counters
+    ) {
+        int worldSize = outgoing.size();
+        std::vector<int> sendCounts(worldSize), recvCounts(worldSize);
+        for (int r = 0; r < worldSize; r++) {
+            sendCounts[r] = outgoing[r].size();
+        }
+
+        MPI_Alltoall(sendCounts.data(), 1, MPI_INT,
+                     recvCounts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+        std::vector<int> recvOffsets(worldSize + 1, 0);
+        for (int r = 0; r < worldSize; r++) {
+            recvOffsets[r + 1] = recvOffsets[r] + recvCounts[r];
+        }
+
+        std::vector<DistanceUpdate> incoming(recvOffsets[worldSize]);
+        std::vector<MPI_Request> requests;
+        requests.reserve(2 * worldSize);
+
+        for (int r = 0; r < worldSize; r++) {
+            if (recvCounts[r] > 0) {
+                requests.emplace_back();
+                MPI_Irecv(&incoming[recvOffsets[r]], recvCounts[r], distanceUpdateType(),
+                          r, MPITags::DISTANCE_UPDATE, MPI_COMM_WORLD, &requests.back());
+                counters.messagesReceived++;
+                counters.bytesReceived += (long long)recvCounts[r] * distanceUpdateBytes();
+            }
+        }
+
+        for (int r = 0; r < worldSize; r++) {
+            if (sendCounts[r] > 0) {
+                requests.emplace_back();
+                MPI_Isend(outgoing[r].data(), sendCounts[r], distanceUpdateType(),
+                          r, MPITags::DISTANCE_UPDATE, MPI_COMM_WORLD, &requests.back());
+                counters.messagesSent++;
+                counters.updatesSent += sendCounts[r];
+                counters.bytesSent += (long long)sendCounts[r] * distanceUpdateBytes();
+            }
+        }
+
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+        return incoming;
+    }
+
     // Barrier synchronization
     static void barrier() {
         MPI_Barrier(MPI_COMM_WORLD);
@@ -225,7 +316,70 @@ public:
         
         return allDistances;
     }
-    
+
+    // Allgather: every rank gets the concatenation of all ranks' node lists
+    static std::vector<int> allgatherNodes(const std::vector<int>& localNodes) {
+        int worldSize;
+        MPI_Comm_size(MPI_COMM_WORLD, &worldSize);
+        int localSize = localNodes.size();
+        std::vector<int> allSizes(worldSize);
+        MPI_Allgather(&localSize, 1, MPI_INT, allSizes.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+        std::vector<int> displacements(worldSize, 0);
+        int totalSize = 0;
+        for (int r = 0; r < worldSize; r++) {
+            displacements[r] = totalSize;
+            totalSize += allSizes[r];
+        }
+
+        std::vector<int> allNodes(totalSize);
+        MPI_Allgatherv(localNodes.data(), localSize, MPI_INT,
+                       allNodes.data(), allSizes.data(), displacements.data(), MPI_INT,
+                       MPI_COMM_WORLD);
+        return allNodes;
+    }
+
+    // Collective write of one shared file: rank 0 writes `prefix` at offset
+    // 0, and every rank writes its values to element positions `indices`
+    // (ascending) of an array of `type` starting at byte `arrayOffset`.
+    // MPI-IO merges the ranks' interleaved pieces into large writes.
+    static bool writeIndexedFile(const std::string& filename, const std::vector<char>& prefix,
+                                 uint64_t arrayOffset, uint64_t totalBytes,
+                                 const void* values, const std::vector<int>& indices,
+                                 MPI_Datatype type, int myRank) {
+        MPI_File fh;
+        if (MPI_File_open(MPI_COMM_WORLD, filename.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                          MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+            if (myRank == 0) {
+                std::cerr << "Error: Cannot create file " << filename << std::endl;
+            }
+            return false;
+        }
+
+        // Drops leftovers of an older, longer file
+        bool ok = MPI_File_set_size(fh, totalBytes) == MPI_SUCCESS;
+        if (myRank == 0 && !prefix.empty()) {
+            ok &= MPI_File_write_at(fh, 0, prefix.data(), prefix.size(), MPI_BYTE,
+                                    MPI_STATUS_IGNORE) == MPI_SUCCESS;
+        }
+
+        MPI_Datatype fileType;
+        MPI_Type_create_indexed_block(indices.size(), 1, indices.data(), type, &fileType);
+        MPI_Type_commit(&fileType);
+        ok &= MPI_File_set_view(fh, arrayOffset, type, fileType, "native", MPI_INFO_NULL) == MPI_SUCCESS;
+        ok &= MPI_File_write_all(fh, values, indices.size(), type, MPI_STATUS_IGNORE) == MPI_SUCCESS;
+        MPI_Type_free(&fileType);
+        ok &= MPI_File_close(&fh) == MPI_SUCCESS;
+
+        // Succeed only if every rank did
+        int localOk = ok, allOk = 0;
+        MPI_Allreduce(&localOk, &allOk, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+        if (!allOk && myRank == 0) {
+            std::cerr << "Error: Failed writing " << filename << std::endl;
+        }
+        return allOk;
+    }
+
     // Broadcast termination signal
     static void broadcastTerminate(int rootRank) {
         int terminateSignal = 1;
@@ -253,4 +407,400 @@ public:
     }
 };
 
+// Non-blocking counterpart of MPIWrapper::exchangeDistanceUpdates() for
+// overlapping the exchange with computation. start() posts MPI_Ialltoall
+// of a {count, flag} pair per rank, so a per-rank flag (e.g. "I still had
+// work") travels with the counts and no separate reduction is needed.
+// progress() never blocks: once the counts are in it posts the update
+// messages, and it returns true when everything has arrived. Call it
+// between chunks of work so MPI can move the data along; finish() waits
+// for the rest. The outgoing buffers must stay untouched until then.
+class PipelinedExchange {
+private:
+    enum class Stage { Idle, Counts, Data, Done };
+
+    Stage stage;
+    const std::vector<std::vector<DistanceUpdate>>* outgoing;
+    MessageCounters* counters;
+    std::vector<int> sendHeader;  // {count, flag} per rank
+    std::vector<int> recvHeader;
+    std::vector<DistanceUpdate> incoming;
+    MPI_Request countsRequest;
+    std::vector<MPI_Request> requests;
+    bool anyFlag;
+
+    void postMessages() {
+        int worldSize = outgoing->size();
+        std::vector<int> recvOffsets(worldSize + 1, 0);
+        anyFlag = false;
+        for (int r = 0; r < worldSize; r++) {
+            recvOffsets[r + 1] = recvOffsets[r] + recvHeader[2 * r];
+            anyFlag = anyFlag || recvHeader[2 * r + 1] != 0;
+        }
+        incoming.resize(recvOffsets[worldSize]);
+        requests.clear();
+
+        for (int r = 0; r < worldSize; r++) {
+            int count = recvHeader[2 * r];
+            if (count > 0) {
+                requests.emplace_back();
+                MPI_Irecv(&incoming[recvOffsets[r]], count, MPIWrapper::distanceUpdateType(),
+                          r, MPITags::DISTANCE_UPDATE, MPI_COMM_WORLD, &requests.back());
+                counters->messagesReceived++;
+                counters->bytesReceived += (long long)count * MPIWrapper::distanceUpdateBytes();
+            }
+        }
+        for (int r = 0; r < worldSize; r++) {
+            int count = sendHeader[2 * r];
+            if (count > 0) {
+                requests.emplace_back();
+                MPI_Isend((*outgoing)[r].data(), count, MPIWrapper::distanceUpdateType(),
+                          r, MPITags::DISTANCE_UPDATE, MPI_COMM_WORLD, &requests.back());
+                counters->messagesSent++;
+                counters->updatesSent += count;
+                counters->bytesSent += (long long)count * MPIWrapper::distanceUpdateBytes();
+            }
+        }
+        stage = Stage::Data;
+    }
+
+public:
+    PipelinedExchange() : stage(Stage::Idle), outgoing(nullptr), counters(nullptr), anyFlag(false) {}
+
+    PipelinedExchange(const PipelinedExchange&) = delete;
+    PipelinedExchange& operator=(const PipelinedExchange&) = delete;
+
+    void start(const std::vector<std::vector<DistanceUpdate>>& outgoingUpdates, int flag,
+               MessageCounters& messageCounters) {
+        int worldSize = outgoingUpdates.size();
+        outgoing = &outgoingUpdates;
+        counters = &messageCounters;
+        sendHeader.resize(2 * worldSize);
+        recvHeader.resize(2 * worldSize);
+        for (int r = 0; r < worldSize; r++) {
+            sendHeader[2 * r] = outgoingUpdates[r].size();
+            sendHeader[2 * r + 1] = flag;
+        }
+        MPI_Ialltoall(sendHeader.data(), 2, MPI_INT, recvHeader.data(), 2, MPI_INT,
+                      MPI_COMM_WORLD, &countsRequest);
+        stage = Stage::Counts;
+    }
+
+    bool progress() {
+        if (stage == Stage::Counts) {
+            int done;
+            MPI_Test(&countsRequest, &done, MPI_STATUS_IGNORE);
+            if (!done) {
+                return false;
+            }
+            postMessages();
+        }
+        if (stage == Stage::Data) {
+            int done;
+            MPI_Testall(requests.size(), requests.data(), &done, MPI_STATUSES_IGNORE);
+            if (!done) {
+                return false;
+            }
+            stage = Stage::Done;
+        }
+        return true;
+    }
+
+    // Wait for the exchange; returns the updates sent to this rank
+    const std::vector<DistanceUpdate>& finish() {
+        if (stage == Stage::Counts) {
+            MPI_Wait(&countsRequest, MPI_STATUS_IGNORE);
+            postMessages();
+        }
+        if (stage == Stage::Data) {
+            MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+        }
+        stage = Stage::Idle;
+        return incoming;
+    }
+
+    // OR of the flags of all ranks, valid after finish()
+    bool anyRankFlagged() const {
+        return anyFlag;
+    }
+};
+
+// Coalescing send buffers for distance updates, one per destination rank.
+//
+// add() keeps at most one entry per key (a dense index chosen by the caller,
+// e.g. the ghost index of the remote node) and lowers it to the smallest
+// distance offered, so a candidate that is superseded before its buffer is
+// flushed never travels. A negative key opts out of coalescing. A
+// destination is flushed once it holds maxUpdates entries or its oldest
+// entry is maxAgeUs old (flushExpired), or by flushAll(). Each destination
+// has two buffers: one fills while the other is in flight with MPI_Isend,
+// so a flush only blocks if the previous send to the same rank has not
+// completed yet.
+class UpdateAggregator {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Channel {
+        std::vector<DistanceUpdate> filling;
+        std::vector<int> fillingKeys;
+        std::vector<DistanceUpdate> inFlight;
+        MPI_Request request = MPI_REQUEST_NULL;
+        Clock::time_point oldest;  // When the first entry of `filling` was added
+    };
+
+    std::vector<Channel> channels;
+    std::vector<int> position;  // Key -> index in its channel's filling buffer, -1 if absent
+    size_t maxUpdates;
+    double maxAgeUs;
+    MessageCounters& counters;
+    std::vector<DistanceUpdate> incoming;
+
+public:
+    UpdateAggregator(int worldSize, int keyCount, size_t flushUpdates, double flushAgeUs,
+                     MessageCounters& messageCounters)
+        : channels(worldSize), position(keyCount, -1), maxUpdates(std::max<size_t>(flushUpdates, 1)),
+          maxAgeUs(flushAgeUs), counters(messageCounters) {}
+
+    ~UpdateAggregator() {
+        waitAll();
+    }
+
+    UpdateAggregator(const UpdateAggregator&) = delete;
+    UpdateAggregator& operator=(const UpdateAggregator&) = delete;
+
+    // Make room for keys added after construction (new ghosts)
+    void resizeKeys(int keyCount) {
+        position.resize(keyCount, -1);
+    }
+
+    // Buffer a candidate for nodeId, owned by destination. Returns the
+    // number of messages this posted (a full buffer is flushed at once).
+    int add(int destination, int key, int nodeId, double distance) {
+        Channel& channel = channels[destination];
+        if (key >= 0 && position[key] != -1) {
+            DistanceUpdate& update = channel.filling[position[key]];
+            update.distance = std::min(update.distance, distance);
+            return 0;
+        }
+
+        if (channel.filling.empty()) {
+            channel.oldest = Clock::now();
+        }
+        if (key >= 0) {
+            position[key] = channel.filling.size();
+        }
+        channel.filling.emplace_back(nodeId, distance);
+        channel.fillingKeys.push_back(key);
+        return channel.filling.size() >= maxUpdates ? flush(destination) : 0;
+    }
+
+    // Post the filling buffer of one destination; returns messages posted
+    int flush(int destination) {
+        Channel& channel = channels[destination];
+        if (channel.filling.empty()) {
+            return 0;
+        }
+        if (channel.request != MPI_REQUEST_NULL) {
+            int done;
+            MPI_Test(&channel.request, &done, MPI_STATUS_IGNORE);
+            if (!done) {
+                counters.sendStalls++;
+                MPI_Wait(&channel.request, MPI_STATUS_IGNORE);
+            }
+        }
+
+        for (int key : channel.fillingKeys) {
+            if (key >= 0) {
+                position[key] = -1;
+            }
+        }
+        channel.fillingKeys.clear();
+        channel.inFlight.swap(channel.filling);
+        channel.filling.clear();
+
+        int count = channel.inFlight.size();
+        MPI_Isend(channel.inFlight.data(), count, MPIWrapper::distanceUpdateType(), destination,
+                  MPITags::DISTANCE_UPDATE, MPI_COMM_WORLD, &channel.request);
+        counters.messagesSent++;
+        counters.updatesSent += count;
+        counters.bytesSent += (long long)count * MPIWrapper::distanceUpdateBytes();
+        return 1;
+    }
+
+    // Flush every destination whose oldest entry has waited maxAgeUs
+    int flushExpired() {
+        Clock::time_point now = Clock::now();
+        int posted = 0;
+        for (size_t r = 0; r < channels.size(); r++) {
+            Channel& channel = channels[r];
+            if (!channel.filling.empty() &&
+                std::chrono::duration<double, std::micro>(now - channel.oldest).count() >= maxAgeUs) {
+                posted += flush(r);
+            }
+        }
+        return posted;
+    }
+
+    int flushAll() {
+        int posted = 0;
+        for (size_t r = 0; r < channels.size(); r++) {
+            posted += flush(r);
+        }
+        return posted;
+    }
+
+    // Block until every posted send has completed
+    void waitAll() {
+        for (Channel& channel : channels) {
+            if (channel.request != MPI_REQUEST_NULL) {
+                MPI_Wait(&channel.request, MPI_STATUS_IGNORE);
+            }
+        }
+    }
+
+    // Receive every update message that has already arrived and call
+    // onUpdate(nodeId, distance) for each entry. Returns messages received.
+    template <typename Callback>
+    int receiveAvailable(Callback onUpdate) {
+        int received = 0;
+        while (true) {
+            int flag;
+            MPI_Status status;
+            MPI_Iprobe(MPI_ANY_SOURCE, MPITags::DISTANCE_UPDATE, MPI_COMM_WORLD, &flag, &status);
+            if (!flag) {
+                break;
+            }
+            int count;
+            MPI_Get_count(&status, MPIWrapper::distanceUpdateType(), &count);
+            incoming.resize(count);
+            MPI_Recv(incoming.data(), count, MPIWrapper::distanceUpdateType(), status.MPI_SOURCE,
+                     MPITags::DISTANCE_UPDATE, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+            received++;
+            counters.messagesReceived++;
+            counters.bytesReceived += (long long)count * MPIWrapper::distanceUpdateBytes();
+            for (const DistanceUpdate& update : incoming) {
+                onUpdate(update.nodeId, update.distance);
+            }
+        }
+        return received;
+    }
+};
+
+// Which ranks share a host. MPI_Comm_split_type(SHARED) puts the ranks of
+// one shared-memory node in a host communicator (ranksPerHost narrows it
+// to runs of that many consecutive ranks, e.g. to try a multi-host layout
+// on one machine); the lowest rank of each host is its leader, and the
+// leaders get a communicator of their own, numbered by host.
+//
+// With hierarchical collectives, allreduce() first reduces within every
+// host, then only the leaders reduce across hosts and broadcast the result
+// at home, so a reduction crosses the network once per host instead of
+// once per rank. The communicators live for the whole run and are left to
+// MPI_Finalize.
+class NodeTopology {
+private:
+    MPI_Comm hostComm;
+    MPI_Comm leaderComm;   // MPI_COMM_NULL on ranks that are not leaders
+    int hostRank;
+    int hostSize;
+    int hostCount;
+    std::vector<int> rankHosts;  // Rank -> host index
+    bool hierarchical;
+
+public:
+    explicit NodeTopology(int ranksPerHost = 0) : hostCount(0), hierarchical(false) {
+        int rank, size;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &size);
+        MPI_Comm sharedComm;
+        MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &sharedComm);
+        if (ranksPerHost > 0) {
+            MPI_Comm_split(sharedComm, rank / ranksPerHost, rank, &hostComm);
+            MPI_Comm_free(&sharedComm);
+        } else {
+            hostComm = sharedComm;
+        }
+        MPI_Comm_rank(hostComm, &hostRank);
+        MPI_Comm_size(hostComm, &hostSize);
+        MPI_Comm_split(MPI_COMM_WORLD, hostRank == 0 ? 0 : MPI_UNDEFINED, rank, &leaderComm);
+
+        int hostIndex = 0;
+        if (leaderComm != MPI_COMM_NULL) {
+            MPI_Comm_rank(leaderComm, &hostIndex);
+            MPI_Comm_size(leaderComm, &hostCount);
+        }
+        MPI_Bcast(&hostIndex, 1, MPI_INT, 0, hostComm);
+        MPI_Bcast(&hostCount, 1, MPI_INT, 0, hostComm);
+        rankHosts.resize(size);
+        MPI_Allgather(&hostIndex, 1, MPI_INT, rankHosts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    }
+
+    NodeTopology(const NodeTopology&) = delete;
+    NodeTopology& operator=(const NodeTopology&) = delete;
+
+    // Hierarchical collectives only pay off with several hosts, some of
+    // them running more than one rank
+    bool benefitsFromHierarchy() const {
+        return hostCount > 1 && hostCount < (int)rankHosts.size();
+    }
+
+    void setHierarchical(bool enabled) {
+        hierarchical = enabled;
+    }
+
+    bool isHierarchical() const { return hierarchical; }
+    int getHostCount() const { return hostCount; }
+    int getHostOf(int rank) const { return rankHosts[rank]; }
+    int getHostRank() const { return hostRank; }
+    int getHostSize() const { return hostSize; }
+    bool isLeader() const { return hostRank == 0; }
+    MPI_Comm getHostComm() const { return hostComm; }
+    MPI_Comm getLeaderComm() const { return leaderComm; }
+
+    // Largest number of ranks on one host
+    int getMaxHostSize() const {
+        std::vector<int> sizes(hostCount, 0);
+        for (int host : rankHosts) {
+            sizes[host]++;
+        }
+        return *std::max_element(sizes.begin(), sizes.end());
+    }
+
+    // MPI_Allreduce over MPI_COMM_WORLD, flat or through the host leaders
+    void allreduce(const void* sendBuffer, void* receiveBuffer, int count, MPI_Datatype type, MPI_Op op) const {
+        if (!hierarchical) {
+            MPI_Allreduce(sendBuffer, receiveBuffer, count, type, op, MPI_COMM_WORLD);
+            return;
+        }
+        MPI_Reduce(sendBuffer, receiveBuffer, count, type, op, 0, hostComm);
+        if (leaderComm != MPI_COMM_NULL) {
+            MPI_Allreduce(MPI_IN_PLACE, receiveBuffer, count, type, op, leaderComm);
+        }
+        MPI_Bcast(receiveBuffer, count, type, 0, hostComm);
+    }
+
+    // Collective: count ints in a shared-memory window allocated by each
+    // host's leader and mapped by every rank of the host, so the host holds
+    // one copy. The leaders call fill(block) and may communicate over
+    // getLeaderComm() while doing so; the block is readable everywhere once
+    // this returns. The window stays mapped until MPI_Finalize.
+    template <typename Fill>
+    const int* createSharedInts(size_t count, Fill fill) const {
+        int* block = nullptr;
+        MPI_Win window;
+        MPI_Win_allocate_shared(isLeader() ? count * sizeof(int) : 0, sizeof(int), MPI_INFO_NULL,
+                                hostComm, &block, &window);
+        MPI_Aint bytes;
+        int unit;
+        MPI_Win_shared_query(window, 0, &bytes, &unit, &block);
+        MPI_Win_fence(0, window);
+        if (isLeader()) {
+            fill(block);
+        }
+        MPI_Win_fence(0, window);
+        return block;
+    }
+};
+
 #endif 
@@ -0,0 +1,259 @@
+#ifndef NODE_ORDERING_H
+#define NODE_ORDERING_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <iostream>
+
+// Node renumbering for cache locality.
+//
+// Generated node IDs carry no locality: the neighbours of a node point to
+// essentially random slots of the distance and predecessor arrays, so
+// nearly every relaxation misses cache. An ordering puts nodes that are
+// close in the graph (or in the plane) at nearby IDs:
+//   bfs      Breadth-first order, one component after another
+//   rcm      Reverse Cuthill-McKee: BFS from a pseudo-peripheral node with
+//            neighbours taken by ascending degree, then reversed. Keeps the
+//            bandwidth max |u - v| small.
+//   hilbert  Position on a Hilbert curve through the node coordinates
+// Every ordering is returned as newToOld: newToOld[i] is the current ID of
+// the node that becomes node i. BasicCSRGraph::permute applies it and keeps
+// the original IDs, so queries and paths are still given in those.
+enum class NodeOrder {
+    Identity,
+    BFS,
+    RCM,
+    Hilbert
+};
+
+inline bool parseNodeOrder(const std::string& name, NodeOrder& order) {
+    if (name == "none") {
+        order = NodeOrder::Identity;
+    } else if (name == "bfs") {
+        order = NodeOrder::BFS;
+    } else if (name == "rcm") {
+        order = NodeOrder::RCM;
+    } else if (name == "hilbert") {
+        order = NodeOrder::Hilbert;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline const char* getNodeOrderName(NodeOrder order) {
+    switch (order) {
+        case NodeOrder::BFS: return "bfs";
+        case NodeOrder::RCM: return "rcm";
+        case NodeOrder::Hilbert: return "hilbert";
+        default: return "none";
+    }
+}
+
+class NodeOrdering {
+private:
+    // BFS over out-edges from start, appending newly reached nodes to order.
+    // With byDegree the neighbours of each node are visited by ascending
+    // degree (Cuthill-McKee). Returns the number of BFS levels; lastLevel is
+    // set to the index in order where the deepest level starts.
+    template <typename Graph>
+    static int breadthFirst(const Graph& graph, int start, bool byDegree,
+                            std::vector<char>& visited, std::vector<int>& order,
+                            size_t& lastLevel) {
+        std::vector<int> neighbours;
+        size_t head = order.size();
+        size_t levelEnd = head + 1;
+        int levels = 1;
+        lastLevel = head;
+        visited[start] = 1;
+        order.push_back(start);
+
+        while (head < order.size()) {
+            if (head == levelEnd) {
+                lastLevel = levelEnd;
+                levelEnd = order.size();
+                levels++;
+            }
+            int u = order[head++];
+            neighbours.clear();
+            for (auto e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+                int v = graph.getTarget(e);
+                if (!visited[v]) {
+                    visited[v] = 1;
+                    neighbours.push_back(v);
+                }
+            }
+            if (byDegree) {
+                std::stable_sort(neighbours.begin(), neighbours.end(), [&](int a, int b) {
+                    return graph.getDegree(a) < graph.getDegree(b);
+                });
+            }
+            order.insert(order.end(), neighbours.begin(), neighbours.end());
+        }
+        return levels;
+    }
+
+    // George-Liu pseudo-peripheral node of the component containing start:
+    // restart from the lowest-degree node of the deepest BFS level for as
+    // long as that makes the BFS deeper. Nodes already numbered (visited) are
+    // never picked. scratch is all zero on entry and exit.
+    template <typename Graph>
+    static int pseudoPeripheral(const Graph& graph, int start, const std::vector<char>& visited,
+                                std::vector<char>& scratch) {
+        std::vector<int> order;
+        int best = start;
+        int bestLevels = 0;
+        for (int round = 0; round < 8; round++) {
+            order.clear();
+            size_t lastLevel;
+            int levels = breadthFirst(graph, best, false, scratch, order, lastLevel);
+            for (int node : order) {
+                scratch[node] = 0;
+            }
+            if (levels <= bestLevels) {
+                break;
+            }
+            bestLevels = levels;
+            int candidate = -1;
+            for (size_t i = lastLevel; i < order.size(); i++) {
+                if (!visited[order[i]] &&
+                    (candidate < 0 || graph.getDegree(order[i]) < graph.getDegree(candidate))) {
+                    candidate = order[i];
+                }
+            }
+            if (candidate < 0 || candidate == best) {
+                break;
+            }
+            best = candidate;
+        }
+        return best;
+    }
+
+    // Hilbert curve index of (x, y) on a 2^16 x 2^16 grid
+    static uint64_t hilbertIndex(uint32_t x, uint32_t y) {
+        const uint32_t n = 1u << 16;
+        uint64_t d = 0;
+        for (uint32_t s = n / 2; s > 0; s /= 2) {
+            uint32_t rx = (x & s) > 0;
+            uint32_t ry = (y & s) > 0;
+            d += (uint64_t)s * s * ((3 * rx) ^ ry);
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = n - 1 - x;
+                    y = n - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return d;
+    }
+
+public:
+    // Breadth-first order; components are started from their lowest ID
+    template <typename Graph>
+    static std::vector<int> bfs(const Graph& graph) {
+        int nodeCount = graph.getNodeCount();
+        std::vector<char> visited(nodeCount, 0);
+        std::vector<int> order;
+        order.reserve(nodeCount);
+        for (int v = 0; v < nodeCount; v++) {
+            if (!visited[v]) {
+                size_t lastLevel;
+                breadthFirst(graph, v, false, visited, order, lastLevel);
+            }
+        }
+        return order;
+    }
+
+    // Reverse Cuthill-McKee
+    template <typename Graph>
+    static std::vector<int> reverseCuthillMcKee(const Graph& graph) {
+        int nodeCount = graph.getNodeCount();
+        std::vector<char> visited(nodeCount, 0);
+        std::vector<char> scratch(nodeCount, 0);
+        std::vector<int> order;
+        order.reserve(nodeCount);
+        for (int v = 0; v < nodeCount; v++) {
+            if (!visited[v]) {
+                size_t lastLevel;
+                breadthFirst(graph, pseudoPeripheral(graph, v, visited, scratch), true, visited, order, lastLevel);
+            }
+        }
+        std::reverse(order.begin(), order.end());
+        return order;
+    }
+
+    // Hilbert curve order of the node coordinates; ties keep ID order
+    template <typename Graph>
+    static std::vector<int> hilbert(const Graph& graph) {
+        int nodeCount = graph.getNodeCount();
+        double minX = std::numeric_limits<double>::infinity(), maxX = -minX;
+        double minY = minX, maxY = -minX;
+        for (int v = 0; v < nodeCount; v++) {
+            minX = std::min(minX, graph.getX(v));
+            maxX = std::max(maxX, graph.getX(v));
+            minY = std::min(minY, graph.getY(v));
+            maxY = std::max(maxY, graph.getY(v));
+        }
+        double scale = 65535.0 / std::max({maxX - minX, maxY - minY, 1e-300});
+
+        std::vector<std::pair<uint64_t, int>> keyed(nodeCount);
+        for (int v = 0; v < nodeCount; v++) {
+            uint32_t x = (uint32_t)((graph.getX(v) - minX) * scale);
+            uint32_t y = (uint32_t)((graph.getY(v) - minY) * scale);
+            keyed[v] = {hilbertIndex(x, y), v};
+        }
+        std::sort(keyed.begin(), keyed.end());
+
+        std::vector<int> order(nodeCount);
+        for (int i = 0; i < nodeCount; i++) {
+            order[i] = keyed[i].second;
+        }
+        return order;
+    }
+
+    // Ordering by name; false (with a message) if it cannot be computed
+    template <typename Graph>
+    static bool compute(const Graph& graph, NodeOrder method, std::vector<int>& order) {
+        switch (method) {
+            case NodeOrder::BFS:
+                order = bfs(graph);
+                return true;
+            case NodeOrder::RCM:
+                order = reverseCuthillMcKee(graph);
+                return true;
+            case NodeOrder::Hilbert:
+                if (!graph.hasCoordinates()) {
+                    std::cerr << "Error: Hilbert order needs node coordinates" << std::endl;
+                    return false;
+                }
+                order = hilbert(graph);
+                return true;
+            default:
+                order.resize(graph.getNodeCount());
+                for (int v = 0; v < graph.getNodeCount(); v++) {
+                    order[v] = v;
+                }
+                return true;
+        }
+    }
+
+    // Mean |u - v| over all edges: how far apart in memory the endpoints of
+    // an edge are in the current numbering
+    template <typename Graph>
+    static double averageEdgeSpan(const Graph& graph) {
+        double total = 0.0;
+        for (int u = 0; u < graph.getNodeCount(); u++) {
+            for (auto e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+                total += std::abs(graph.getTarget(e) - u);
+            }
+        }
+        return graph.getEdgeCount() > 0 ? total / graph.getEdgeCount() : 0.0;
+    }
+};
+
+#endif
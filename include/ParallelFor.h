@@ -0,0 +1,38 @@
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+// Dynamically scheduled loop on std::thread workers, for the tools that do
+// not use OpenMP. Items are handed out one at a time, so they should be
+// coarse (a chunk of nodes, a whole search).
+
+// Run body(item, threadIndex) for every item in [0, count) on `threads` threads
+template<typename Body>
+void parallelFor(long long count, int threads, const Body& body) {
+    threads = (int)std::max(1LL, std::min<long long>(threads, count));
+    if (threads == 1) {
+        for (long long item = 0; item < count; item++) {
+            body(item, 0);
+        }
+        return;
+    }
+
+    std::atomic<long long> next(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for (long long item = next++; item < count; item = next++) {
+                body(item, t);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+#endif
@@ -1,15 +1,58 @@
 #ifndef PARTITIONER_H
 #define PARTITIONER_H
 
-#include "Graph.h"
+#include "CSRGraph.h"
 #include <vector>
 #include <unordered_set>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <iostream>
+
+// Communication statistics of one rank's partition
+struct BoundaryStats {
+    int ownedNodes = 0;
+    int boundaryNodes = 0;      // Owned nodes with at least one remote neighbour
+    int remoteNeighbors = 0;    // Distinct remote targets (ghost nodes)
+    long long localEdges = 0;   // Edges that stay inside the partition
+    long long cutEdges = 0;     // Edges that leave the partition
+};
+
+// Quality of a complete partitioning
+struct PartitionStats {
+    int parts = 0;
+    long long totalEdges = 0;
+    long long edgeCut = 0;      // Directed edges whose endpoints have different owners
+    int minPartSize = 0;
+    int maxPartSize = 0;
+    double imbalance = 0.0;     // maxPartSize / average part size
+    int ranksPerHost = 0;       // Hosts of consecutive ranks; 0 = not evaluated
+    long long hostCut = 0;      // Cut edges between parts on different hosts
+
+    double getCutFraction() const {
+        return totalEdges > 0 ? (double)edgeCut / totalEdges : 0.0;
+    }
+
+    void print() const {
+        std::cout << "Partition Quality:\n";
+        std::cout << "  Parts: " << parts << "\n";
+        std::cout << "  Edge cut: " << edgeCut << " of " << totalEdges
+                  << " (" << 100.0 * getCutFraction() << "%)\n";
+        std::cout << "  Part sizes: " << minPartSize << " - " << maxPartSize << "\n";
+        std::cout << "  Imbalance: " << imbalance << "\n";
+        if (ranksPerHost > 0) {
+            std::cout << "  Cross-host cut (" << ranksPerHost << " ranks per host): " << hostCut
+                      << " (" << (totalEdges > 0 ? 100.0 * hostCut / totalEdges : 0.0) << "%)\n";
+        }
+    }
+};
 
 class Partitioner {
 public:
     // Existing contiguous partitioning
     static std::vector<int> getContiguousPartition(
-        const Graph& graph,
+        const CSRGraph& graph,
         int myRank,
         int totalProcesses
     ) {
@@ -34,7 +77,7 @@ public:
     
     // NEW: Round-Robin partitioning
     static std::vector<int> getRoundRobinPartition(
-        const Graph& graph,
+        const CSRGraph& graph,
         int myRank,
         int totalProcesses
     ) {
@@ -75,28 +118,506 @@ public:
         return totalProcesses - 1;
     }
     
-    // Identify boundary nodes (nodes with edges to other partitions)
+    // Helper: Get first node owned by a rank (for contiguous)
+    static int getContiguousStart(int rank, int nodeCount, int totalProcesses) {
+        int nodesPerProcess = nodeCount / totalProcesses;
+        int remainder = nodeCount % totalProcesses;
+        return rank * nodesPerProcess + std::min(rank, remainder);
+    }
+    
+    // Helper: Index of a node within its owner's partition (for round-robin)
+    static int getLocalIndexRoundRobin(int nodeId, int totalProcesses) {
+        return nodeId / totalProcesses;
+    }
+    
+    // Helper: Index of a node within its owner's partition (for contiguous)
+    static int getLocalIndexContiguous(int nodeId, int nodeCount, int totalProcesses) {
+        int owner = getNodeOwnerContiguous(nodeId, nodeCount, totalProcesses);
+        return nodeId - getContiguousStart(owner, nodeCount, totalProcesses);
+    }
+    
+    // Identify boundary nodes (nodes with edges to other partitions).
+    // If stats is given, it is filled with cut/ghost counts for logging.
     static std::unordered_set<int> identifyBoundaryNodes(
-        const Graph& graph,
+        const CSRGraph& graph,
         const std::vector<int>& myPartition,
         int myRank,
-        int totalProcesses
+        int totalProcesses,
+        BoundaryStats* stats = nullptr
     ) {
+        (void)myRank;
+        (void)totalProcesses;
+        
         std::unordered_set<int> boundaryNodes;
         std::unordered_set<int> myNodes(myPartition.begin(), myPartition.end());
+        std::unordered_set<int> remoteNeighbors;
+        long long localEdges = 0, cutEdges = 0;
         
         for (int node : myPartition) {
-            for (const Edge& edge : graph.getAdjacencyList(node)) {
+            for (int e = graph.edgeBegin(node); e < graph.edgeEnd(node); e++) {
                 // If edge goes to node not in my partition, it's a boundary
-                if (myNodes.find(edge.destination) == myNodes.end()) {
+                if (myNodes.find(graph.getTarget(e)) == myNodes.end()) {
                     boundaryNodes.insert(node);
-                    break;
+                    if (stats == nullptr) {
+                        break;
+                    }
+                    remoteNeighbors.insert(graph.getTarget(e));
+                    cutEdges++;
+                } else {
+                    localEdges++;
                 }
             }
         }
         
+        if (stats != nullptr) {
+            stats->ownedNodes = myPartition.size();
+            stats->boundaryNodes = boundaryNodes.size();
+            stats->remoteNeighbors = remoteNeighbors.size();
+            stats->localEdges = localEdges;
+            stats->cutEdges = cutEdges;
+        }
+        
         return boundaryNodes;
     }
+    
+    // Graph-aware: BFS region growing. Each part is grown breadth-first from
+    // a pseudo-peripheral unassigned node until it holds its share of the
+    // nodes, so parts are connected regions with few edges between them.
+    // Returns the owner of every node.
+    static std::vector<int> getBFSPartition(
+        const CSRGraph& graph,
+        int totalProcesses
+    ) {
+        int nodeCount = graph.getNodeCount();
+        std::vector<int> owners(nodeCount, -1);
+        std::vector<int> queue;
+        queue.reserve(nodeCount);
+        std::vector<int> visitMark(nodeCount, -1);
+        int nextUnassigned = 0;
+        int assigned = 0;
+        
+        // Breadth-first order over unassigned nodes starting at seed
+        auto bfsOrder = [&](int seed, int mark, int limit) {
+            queue.clear();
+            queue.push_back(seed);
+            visitMark[seed] = mark;
+            for (size_t head = 0; head < queue.size() && (int)queue.size() < limit; head++) {
+                int u = queue[head];
+                for (int e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+                    int v = graph.getTarget(e);
+                    if (owners[v] == -1 && visitMark[v] != mark) {
+                        visitMark[v] = mark;
+                        queue.push_back(v);
+                        if ((int)queue.size() >= limit) {
+                            break;
+                        }
+                    }
+                }
+            }
+        };
+        
+        int mark = 0;
+        for (int part = 0; part < totalProcesses; part++) {
+            // Split what is left evenly over the remaining parts
+            int target = (nodeCount - assigned) / (totalProcesses - part);
+            
+            while (target > 0) {
+                while (nextUnassigned < nodeCount && owners[nextUnassigned] != -1) {
+                    nextUnassigned++;
+                }
+                if (nextUnassigned >= nodeCount) {
+                    break;
+                }
+                
+                // Seed at the far end of a BFS from the first free node
+                bfsOrder(nextUnassigned, mark++, nodeCount);
+                int seed = queue.back();
+                
+                // Grow the region; a disconnected remainder gets a new seed
+                bfsOrder(seed, mark++, target);
+                for (int u : queue) {
+                    owners[u] = part;
+                }
+                assigned += queue.size();
+                target -= queue.size();
+            }
+        }
+        
+        return owners;
+    }
+    
+    // Graph-aware: recursive coordinate bisection on Node x/y. Nodes are
+    // split at the weighted median of the wider axis until every part has
+    // its share. Suits spatial graphs (grids, road-like) where nearby nodes
+    // are connected; graphs without coordinates degenerate to ID order.
+    static std::vector<int> getCoordinatePartition(
+        const CSRGraph& graph,
+        int totalProcesses
+    ) {
+        int nodeCount = graph.getNodeCount();
+        std::vector<int> owners(nodeCount, 0);
+        std::vector<int> nodes(nodeCount);
+        for (int i = 0; i < nodeCount; i++) {
+            nodes[i] = i;
+        }
+        
+        struct Range { int begin, end, firstPart, parts; };
+        std::vector<Range> stack = {{0, nodeCount, 0, totalProcesses}};
+        
+        while (!stack.empty()) {
+            Range r = stack.back();
+            stack.pop_back();
+            
+            if (r.parts <= 1) {
+                for (int i = r.begin; i < r.end; i++) {
+                    owners[nodes[i]] = r.firstPart;
+                }
+                continue;
+            }
+            
+            double minX = 1e300, maxX = -1e300, minY = 1e300, maxY = -1e300;
+            for (int i = r.begin; i < r.end; i++) {
+                minX = std::min(minX, graph.getX(nodes[i]));
+                maxX = std::max(maxX, graph.getX(nodes[i]));
+                minY = std::min(minY, graph.getY(nodes[i]));
+                maxY = std::max(maxY, graph.getY(nodes[i]));
+            }
+            bool splitX = (maxX - minX) >= (maxY - minY);
+            
+            int leftParts = r.parts / 2;
+            int mid = r.begin + (int)((long long)(r.end - r.begin) * leftParts / r.parts);
+            std::nth_element(nodes.begin() + r.begin, nodes.begin() + mid, nodes.begin() + r.end,
+                [&](int a, int b) {
+                    double ka = splitX ? graph.getX(a) : graph.getY(a);
+                    double kb = splitX ? graph.getX(b) : graph.getY(b);
+                    return ka < kb || (ka == kb && a < b);
+                });
+            
+            stack.push_back({r.begin, mid, r.firstPart, leftParts});
+            stack.push_back({mid, r.end, r.firstPart + leftParts, r.parts - leftParts});
+        }
+        
+        return owners;
+    }
+    
+    // Edge cut and balance of a complete owner assignment; with
+    // ranksPerHost, also the cut between hosts of that many consecutive ranks
+    static PartitionStats computePartitionStats(
+        const CSRGraph& graph,
+        const std::vector<int>& owners,
+        int totalProcesses,
+        int ranksPerHost = 0
+    ) {
+        PartitionStats stats;
+        stats.parts = totalProcesses;
+        stats.totalEdges = graph.getEdgeCount();
+        stats.ranksPerHost = ranksPerHost;
+        
+        std::vector<int> sizes(totalProcesses, 0);
+        for (int u = 0; u < graph.getNodeCount(); u++) {
+            sizes[owners[u]]++;
+            for (int e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+                int owner = owners[graph.getTarget(e)];
+                if (owner != owners[u]) {
+                    stats.edgeCut++;
+                    if (ranksPerHost > 0 && owner / ranksPerHost != owners[u] / ranksPerHost) {
+                        stats.hostCut++;
+                    }
+                }
+            }
+        }
+        
+        stats.minPartSize = *std::min_element(sizes.begin(), sizes.end());
+        stats.maxPartSize = *std::max_element(sizes.begin(), sizes.end());
+        double average = (double)graph.getNodeCount() / totalProcesses;
+        stats.imbalance = average > 0 ? stats.maxPartSize / average : 1.0;
+        return stats;
+    }
+    
+    // Renumber the parts of an owner assignment so that each run of
+    // ranksPerHost consecutive ranks, which mpirun places on one host when
+    // it fills the hosts slot by slot, gets parts with heavy traffic between
+    // them. Greedy on the part-to-part cut: a host starts with the unplaced
+    // part that has the most cut edges and keeps adding the unplaced part
+    // with the most edges to the parts it already holds. Part sizes and the
+    // total cut do not change, only which cut edges cross hosts.
+    static std::vector<int> groupPartsByHost(
+        const CSRGraph& graph,
+        const std::vector<int>& owners,
+        int totalProcesses,
+        int ranksPerHost
+    ) {
+        // Cut edges between every pair of parts, both directions together
+        std::vector<long long> cut((size_t)totalProcesses * totalProcesses, 0);
+        for (int u = 0; u < graph.getNodeCount(); u++) {
+            for (int e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+                int a = owners[u], b = owners[graph.getTarget(e)];
+                if (a != b) {
+                    cut[(size_t)a * totalProcesses + b]++;
+                    cut[(size_t)b * totalProcesses + a]++;
+                }
+            }
+        }
+
+        std::vector<int> newRank(totalProcesses, -1);
+        std::vector<long long> towardHost(totalProcesses);
+        int nextRank = 0;
+        while (nextRank < totalProcesses) {
+            int seed = -1;
+            long long seedCut = -1;
+            for (int p = 0; p < totalProcesses; p++) {
+                long long total = 0;
+                for (int q = 0; q < totalProcesses; q++) {
+                    total += cut[(size_t)p * totalProcesses + q];
+                }
+                if (newRank[p] < 0 && total > seedCut) {
+                    seed = p;
+                    seedCut = total;
+                }
+            }
+
+            std::fill(towardHost.begin(), towardHost.end(), 0);
+            int hostEnd = std::min(nextRank + ranksPerHost, totalProcesses);
+            for (int p = seed; p >= 0 && nextRank < hostEnd; ) {
+                newRank[p] = nextRank++;
+                for (int q = 0; q < totalProcesses; q++) {
+                    towardHost[q] += cut[(size_t)p * totalProcesses + q];
+                }
+                p = -1;
+                for (int q = 0; q < totalProcesses; q++) {
+                    if (newRank[q] < 0 && (p < 0 || towardHost[q] > towardHost[p])) {
+                        p = q;
+                    }
+                }
+            }
+        }
+
+        std::vector<int> grouped(owners.size());
+        for (size_t u = 0; u < owners.size(); u++) {
+            grouped[u] = newRank[owners[u]];
+        }
+        return grouped;
+    }
+
+    // Save an owner assignment
+    // File format:
+    // Line 1: numNodes numParts
+    // Following lines: owner of node i
+    static bool savePartition(
+        const std::string& filename,
+        const std::vector<int>& owners,
+        int totalProcesses
+    ) {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot create file " << filename << std::endl;
+            return false;
+        }
+        file << owners.size() << " " << totalProcesses << "\n";
+        for (int owner : owners) {
+            file << owner << "\n";
+        }
+        return file.good();
+    }
+    
+    // Load an owner assignment written by savePartition
+    static bool loadPartition(
+        const std::string& filename,
+        std::vector<int>& owners,
+        int expectedNodes,
+        int expectedParts
+    ) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot open file " << filename << std::endl;
+            return false;
+        }
+        int numNodes, numParts;
+        if (!(file >> numNodes >> numParts) ||
+            numNodes != expectedNodes || numParts != expectedParts) {
+            std::cerr << "Error: " << filename << " does not match " << expectedNodes
+                      << " nodes / " << expectedParts << " parts" << std::endl;
+            return false;
+        }
+        owners.resize(numNodes);
+        for (int i = 0; i < numNodes; i++) {
+            if (!(file >> owners[i]) || owners[i] < 0 || owners[i] >= numParts) {
+                std::cerr << "Error: Invalid owner list in " << filename << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Partitioning scheme selectable at runtime
+enum class PartitionScheme {
+    RoundRobin,
+    Contiguous,
+    Explicit     // Per-node owner table (e.g. from getBFSPartition)
+};
+
+// Node ownership for one scheme and process count. Maps global node IDs to
+// (owner rank, local index) and back. The round-robin and contiguous
+// schemes are pure arithmetic and cost O(1) memory on every rank; an
+// explicit owner table costs three ints per node, shared between copies.
+// The table is one block of ints (see getOwnerTableInts), so it can also
+// live in memory the map does not own, such as a shared-memory window
+// that all ranks of a host read.
+class PartitionMap {
+private:
+    PartitionScheme scheme;
+    int nodeCount;
+    int totalProcesses;
+
+    // Explicit scheme only: views into one block of ints laid out as
+    // owners | localIndices | partOffsets | members
+    struct OwnerTable {
+        const int* owners;        // Node -> owner rank
+        const int* localIndices;  // Node -> index within its owner
+        const int* partOffsets;   // Rank -> first entry in members
+        const int* members;       // Nodes grouped by owner, in ID order
+        std::vector<int> storage; // The block, unless it is external
+    };
+    std::shared_ptr<const OwnerTable> table;
+
+    void bindTable(std::shared_ptr<OwnerTable> t, const int* block) {
+        t->owners = block;
+        t->localIndices = block + nodeCount;
+        t->partOffsets = block + 2 * (size_t)nodeCount;
+        t->members = block + 2 * (size_t)nodeCount + totalProcesses + 1;
+        table = t;
+    }
+
+public:
+    PartitionMap(PartitionScheme partitionScheme, int numNodes, int numProcesses)
+        : scheme(partitionScheme), nodeCount(numNodes), totalProcesses(numProcesses) {}
+
+    // Explicit ownership from an owner-per-node array
+    PartitionMap(const std::vector<int>& owners, int numProcesses)
+        : scheme(PartitionScheme::Explicit), nodeCount(owners.size()),
+          totalProcesses(numProcesses) {
+        auto t = std::make_shared<OwnerTable>();
+        t->storage.resize(getOwnerTableInts(nodeCount, numProcesses));
+        std::copy(owners.begin(), owners.end(), t->storage.begin());
+        buildOwnerTable(t->storage.data(), nodeCount, numProcesses);
+        bindTable(t, t->storage.data());
+    }
+
+    // Explicit ownership from a block filled by buildOwnerTable; the caller
+    // keeps the block alive and unchanged for as long as the map is used
+    PartitionMap(const int* block, int numNodes, int numProcesses)
+        : scheme(PartitionScheme::Explicit), nodeCount(numNodes), totalProcesses(numProcesses) {
+        bindTable(std::make_shared<OwnerTable>(), block);
+    }
+
+    // Size of an owner table block
+    static size_t getOwnerTableInts(int numNodes, int numProcesses) {
+        return 3 * (size_t)numNodes + numProcesses + 1;
+    }
+
+    // Fill in the index sections of a block whose first numNodes entries
+    // hold the owner of every node
+    static void buildOwnerTable(int* block, int numNodes, int numProcesses) {
+        const int* owners = block;
+        int* localIndices = block + numNodes;
+        int* partOffsets = block + 2 * (size_t)numNodes;
+        int* members = partOffsets + numProcesses + 1;
+        std::fill(partOffsets, partOffsets + numProcesses + 1, 0);
+        for (int u = 0; u < numNodes; u++) {
+            partOffsets[owners[u] + 1]++;
+        }
+        for (int r = 0; r < numProcesses; r++) {
+            partOffsets[r + 1] += partOffsets[r];
+        }
+        std::vector<int> cursor(partOffsets, partOffsets + numProcesses);
+        for (int u = 0; u < numNodes; u++) {
+            int r = owners[u];
+            localIndices[u] = cursor[r] - partOffsets[r];
+            members[cursor[r]++] = u;
+        }
+    }
+
+    PartitionScheme getScheme() const { return scheme; }
+    int getNodeCount() const { return nodeCount; }
+    int getProcessCount() const { return totalProcesses; }
+
+    // Memory of the explicit owner table, wherever it lives
+    size_t getOwnerTableBytes() const {
+        return scheme == PartitionScheme::Explicit ? getOwnerTableInts(nodeCount, totalProcesses) * sizeof(int) : 0;
+    }
+
+    const char* getSchemeName() const {
+        switch (scheme) {
+            case PartitionScheme::RoundRobin: return "Round-Robin";
+            case PartitionScheme::Contiguous: return "Contiguous";
+            default: return "Explicit";
+        }
+    }
+
+    // Rank that owns a node
+    int getOwner(int nodeId) const {
+        if (scheme == PartitionScheme::RoundRobin) {
+            return Partitioner::getNodeOwnerRoundRobin(nodeId, totalProcesses);
+        }
+        if (scheme == PartitionScheme::Contiguous) {
+            return Partitioner::getNodeOwnerContiguous(nodeId, nodeCount, totalProcesses);
+        }
+        return table->owners[nodeId];
+    }
+
+    // Position of a node within its owner's partition
+    int getLocalIndex(int nodeId) const {
+        if (scheme == PartitionScheme::RoundRobin) {
+            return Partitioner::getLocalIndexRoundRobin(nodeId, totalProcesses);
+        }
+        if (scheme == PartitionScheme::Contiguous) {
+            return Partitioner::getLocalIndexContiguous(nodeId, nodeCount, totalProcesses);
+        }
+        return table->localIndices[nodeId];
+    }
+
+    // Global ID of the localIndex-th node owned by rank
+    int getGlobalId(int rank, int localIndex) const {
+        if (scheme == PartitionScheme::RoundRobin) {
+            return localIndex * totalProcesses + rank;
+        }
+        if (scheme == PartitionScheme::Contiguous) {
+            return Partitioner::getContiguousStart(rank, nodeCount, totalProcesses) + localIndex;
+        }
+        return table->members[table->partOffsets[rank] + localIndex];
+    }
+
+    // Number of nodes owned by rank
+    int getOwnedCount(int rank) const {
+        if (scheme == PartitionScheme::Explicit) {
+            return table->partOffsets[rank + 1] - table->partOffsets[rank];
+        }
+        int nodesPerProcess = nodeCount / totalProcesses;
+        int remainder = nodeCount % totalProcesses;
+        return nodesPerProcess + (rank < remainder ? 1 : 0);
+    }
+
+    // Nodes owned by rank, in local index order
+    std::vector<int> getOwnedNodes(int rank) const {
+        std::vector<int> nodes(getOwnedCount(rank));
+        for (size_t i = 0; i < nodes.size(); i++) {
+            nodes[i] = getGlobalId(rank, i);
+        }
+        return nodes;
+    }
+
+    // Owner of every node, e.g. for Partitioner::computePartitionStats
+    std::vector<int> getOwnerArray() const {
+        if (scheme == PartitionScheme::Explicit) {
+            return std::vector<int>(table->owners, table->owners + nodeCount);
+        }
+        std::vector<int> owners(nodeCount);
+        for (int u = 0; u < nodeCount; u++) {
+            owners[u] = getOwner(u);
+        }
+        return owners;
+    }
 };
 
 #endif
@@ -0,0 +1,163 @@
+#ifndef PATH_TREE_CACHE_H
+#define PATH_TREE_CACHE_H
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <iostream>
+
+// Shortest-path tree of one source: the predecessor of every node, -1 for
+// the source and for unreachable nodes. Distances are not stored; walking
+// the tree and adding the edge weights from the source on gives exactly
+// the distance Dijkstra computed, so a tree costs 4 bytes per node.
+struct PathTree {
+    int source;
+    std::vector<int> predecessors;
+};
+
+// Counters of a PathTreeCache
+struct PathTreeCacheStats {
+    long long hits = 0;
+    long long misses = 0;
+    long long treesBuilt = 0;     // Misses that were admitted
+    long long evictions = 0;
+    long long invalidations = 0;
+    size_t trees = 0;
+    size_t bytes = 0;
+
+    double hitRate() const {
+        long long lookups = hits + misses;
+        return lookups > 0 ? (double)hits / lookups : 0.0;
+    }
+
+    // Printed to stderr next to the batch summary
+    void print() const {
+        std::cerr << "Tree cache:\n";
+        std::cerr << "  Lookups: " << hits + misses << " (" << hits << " hits, " << misses
+                  << " misses, hit rate " << hitRate() * 100.0 << "%)\n";
+        std::cerr << "  Trees built: " << treesBuilt << ", evicted: " << evictions
+                  << ", invalidations: " << invalidations << "\n";
+        std::cerr << "  Resident: " << trees << " trees (" << bytes / 1024 << " KB)\n";
+        std::cerr << "-------------------------------------------\n";
+    }
+};
+
+// Bounded LRU cache of shortest-path trees keyed by source, shared by all
+// solvers of a query stream (all methods lock one mutex).
+//
+// A tree costs a full one-to-all search, so a source is only admitted on
+// its second miss among the last `capacity` missed sources; until then the
+// query is answered by the usual point-to-point search. With a skewed
+// stream the hubs get trees after one extra search, and a stream without
+// repeated sources pays nothing but the lookup.
+//
+// Trees are only valid for the graph they were built on: whoever changes
+// the graph calls invalidate(), which moves to a new version and drops all
+// trees. A solver notes getVersion() before building a tree, so a tree
+// whose search straddled an invalidation is discarded on insert.
+class PathTreeCache {
+private:
+    size_t capacity;
+    uint64_t version;
+    std::list<std::shared_ptr<const PathTree>> entries;  // Most recently used first
+    std::unordered_map<int, std::list<std::shared_ptr<const PathTree>>::iterator> index;
+    std::list<int> missed;     // Recently missed sources, most recent first
+    std::unordered_map<int, std::list<int>::iterator> missedIndex;
+    PathTreeCacheStats stats;
+    mutable std::mutex mutex;
+
+    void evictLeastRecent() {
+        index.erase(entries.back()->source);
+        stats.bytes -= entries.back()->predecessors.size() * sizeof(int);
+        entries.pop_back();
+        stats.evictions++;
+    }
+
+public:
+    explicit PathTreeCache(size_t maxTrees) : capacity(maxTrees), version(0) {}
+
+    PathTreeCache(const PathTreeCache&) = delete;
+    PathTreeCache& operator=(const PathTreeCache&) = delete;
+
+    // The tree of source, or null on a miss. admit tells the caller on a
+    // miss whether to build the tree and insert() it.
+    std::shared_ptr<const PathTree> find(int source, bool& admit) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(source);
+        if (it != index.end()) {
+            entries.splice(entries.begin(), entries, it->second);
+            stats.hits++;
+            admit = false;
+            return entries.front();
+        }
+
+        stats.misses++;
+        auto seen = missedIndex.find(source);
+        admit = (seen != missedIndex.end());
+        if (admit) {
+            missed.erase(seen->second);
+            missedIndex.erase(seen);
+        } else {
+            missed.push_front(source);
+            missedIndex[source] = missed.begin();
+            if (missed.size() > capacity) {
+                missedIndex.erase(missed.back());
+                missed.pop_back();
+            }
+        }
+        return nullptr;
+    }
+
+    // Add the tree built after find() admitted its source; treeVersion is
+    // getVersion() from before the search
+    void insert(std::shared_ptr<const PathTree> tree, uint64_t treeVersion) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (treeVersion != version) {
+            return;
+        }
+        stats.treesBuilt++;
+        // Another solver may have built the same tree meanwhile
+        if (index.count(tree->source)) {
+            return;
+        }
+        entries.push_front(tree);
+        index[tree->source] = entries.begin();
+        stats.bytes += tree->predecessors.size() * sizeof(int);
+        while (entries.size() > capacity) {
+            evictLeastRecent();
+        }
+    }
+
+    // The graph changed: drop every tree and every pending admission
+    void invalidate() {
+        std::lock_guard<std::mutex> lock(mutex);
+        version++;
+        entries.clear();
+        index.clear();
+        missed.clear();
+        missedIndex.clear();
+        stats.bytes = 0;
+        stats.invalidations++;
+    }
+
+    uint64_t getVersion() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return version;
+    }
+
+    size_t getCapacity() const {
+        return capacity;
+    }
+
+    PathTreeCacheStats getStats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        PathTreeCacheStats current = stats;
+        current.trees = entries.size();
+        return current;
+    }
+};
+
+#endif
@@ -0,0 +1,281 @@
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+
+#include "Graph.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <algorithm>
+
+// Priority-queue policies for the sequential solvers.
+//
+// Every policy has the same interface:
+//   init(nodeCount)          - prepare for a search over nodeCount nodes;
+//                              storage is kept between searches, so a
+//                              repeated init costs only what the previous
+//                              search left behind
+//   push(node, key)          - insert, or lower the key of a queued node;
+//                              returns true if a new entry was created
+//   pop()                    - remove and return the node with minimum key
+//   minKey()                 - smallest key in the queue (may belong to a
+//                              stale entry in the lazy policies)
+//   empty(), size()
+//
+// Lazy policies (binary, radix) never lower keys in place: push always adds
+// a new entry and the solver skips the stale ones when they surface. The
+// indexed d-ary heap keeps one entry per node and decreases its key, so the
+// heap never grows beyond the number of discovered nodes.
+
+enum class QueuePolicy {
+    Binary,   // std::priority_queue with lazy deletion (original behaviour)
+    DaryHeap, // Indexed 4-ary heap with decrease-key
+    Radix     // Radix heap over non-negative keys (monotone searches only)
+};
+
+inline const char* getQueuePolicyName(QueuePolicy policy) {
+    switch (policy) {
+        case QueuePolicy::Binary: return "binary";
+        case QueuePolicy::DaryHeap: return "dary";
+        default: return "radix";
+    }
+}
+
+inline bool parseQueuePolicy(const std::string& name, QueuePolicy& policy) {
+    if (name == "binary") {
+        policy = QueuePolicy::Binary;
+    } else if (name == "dary") {
+        policy = QueuePolicy::DaryHeap;
+    } else if (name == "radix") {
+        policy = QueuePolicy::Radix;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Lazy binary heap on PQElement. Same ordering as
+// std::priority_queue<PQElement, ..., std::greater<PQElement>>, but on a
+// plain vector so its capacity survives init().
+class BinaryHeapQueue {
+private:
+    std::vector<PQElement> heap;
+
+public:
+    void init(int nodeCount) {
+        (void)nodeCount;
+        heap.clear();
+    }
+
+    bool push(int nodeId, double key) {
+        heap.push_back(PQElement(nodeId, key));
+        std::push_heap(heap.begin(), heap.end(), std::greater<PQElement>());
+        return true;
+    }
+
+    int pop() {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<PQElement>());
+        int nodeId = heap.back().nodeId;
+        heap.pop_back();
+        return nodeId;
+    }
+
+    double minKey() const { return heap.front().key; }
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+};
+
+// Indexed d-ary min-heap with decrease-key.
+// A 4-ary heap halves the depth of a binary heap, and the four children of
+// a node share a cache line, which makes sift-down cheaper in practice.
+template <int D = 4>
+class DaryHeapQueue {
+private:
+    std::vector<int> heapNodes;     // Heap order
+    std::vector<double> heapKeys;   // Key of heapNodes[i]
+    std::vector<int> position;      // Node -> index in heap, -1 if absent
+
+    void place(int index, int nodeId, double key) {
+        heapNodes[index] = nodeId;
+        heapKeys[index] = key;
+        position[nodeId] = index;
+    }
+
+    void siftUp(int index, int nodeId, double key) {
+        while (index > 0) {
+            int parent = (index - 1) / D;
+            if (heapKeys[parent] <= key) {
+                break;
+            }
+            place(index, heapNodes[parent], heapKeys[parent]);
+            index = parent;
+        }
+        place(index, nodeId, key);
+    }
+
+    void siftDown(int index, int nodeId, double key) {
+        int count = heapNodes.size();
+        while (true) {
+            int first = index * D + 1;
+            if (first >= count) {
+                break;
+            }
+            int last = std::min(first + D, count);
+            int best = first;
+            for (int c = first + 1; c < last; c++) {
+                if (heapKeys[c] < heapKeys[best]) {
+                    best = c;
+                }
+            }
+            if (heapKeys[best] >= key) {
+                break;
+            }
+            place(index, heapNodes[best], heapKeys[best]);
+            index = best;
+        }
+        place(index, nodeId, key);
+    }
+
+public:
+    void init(int nodeCount) {
+        if ((int)position.size() != nodeCount) {
+            position.assign(nodeCount, -1);
+        } else {
+            // Only nodes left over from an early-terminated search are marked
+            for (int nodeId : heapNodes) {
+                position[nodeId] = -1;
+            }
+        }
+        heapNodes.clear();
+        heapKeys.clear();
+    }
+
+    bool push(int nodeId, double key) {
+        int index = position[nodeId];
+        if (index >= 0) {
+            if (key < heapKeys[index]) {
+                siftUp(index, nodeId, key);
+            }
+            return false;
+        }
+        heapNodes.push_back(nodeId);
+        heapKeys.push_back(key);
+        siftUp(heapNodes.size() - 1, nodeId, key);
+        return true;
+    }
+
+    int pop() {
+        int top = heapNodes[0];
+        position[top] = -1;
+
+        int lastNode = heapNodes.back();
+        double lastKey = heapKeys.back();
+        heapNodes.pop_back();
+        heapKeys.pop_back();
+        if (!heapNodes.empty()) {
+            siftDown(0, lastNode, lastKey);
+        }
+        return top;
+    }
+
+    double minKey() const { return heapKeys[0]; }
+
+    bool empty() const { return heapNodes.empty(); }
+    size_t size() const { return heapNodes.size(); }
+};
+
+// Radix heap (Ahuja, Mehlhorn, Orlin, Tarjan) for monotone searches.
+// Non-negative IEEE doubles order the same way as their bit patterns read
+// as uint64, so keys are bucketed by the highest bit in which they differ
+// from the last extracted key. Each entry moves down at most 64 times,
+// giving O(1) amortised push and O(log C) pop. Keys must never drop below
+// the last popped key, which holds for Dijkstra but not for A* with an
+// inconsistent heuristic; such keys are clamped to keep the heap valid.
+class RadixHeapQueue {
+private:
+    struct Entry {
+        uint64_t key;
+        int nodeId;
+    };
+
+    std::vector<Entry> buckets[65];
+    uint64_t lastKey;
+    size_t count;
+
+    static uint64_t toBits(double key) {
+        uint64_t bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        return bits;
+    }
+
+    int bucketFor(uint64_t key) const {
+        uint64_t diff = key ^ lastKey;
+        return diff == 0 ? 0 : 64 - __builtin_clzll(diff);
+    }
+
+    // Redistribute the lowest non-empty bucket around its minimum so that
+    // bucket 0 holds the entries with the smallest key
+    void refill() {
+        if (!buckets[0].empty()) {
+            return;
+        }
+        int i = 1;
+        while (buckets[i].empty()) {
+            i++;
+        }
+        uint64_t smallest = buckets[i][0].key;
+        for (const Entry& entry : buckets[i]) {
+            smallest = std::min(smallest, entry.key);
+        }
+        lastKey = smallest;
+        for (const Entry& entry : buckets[i]) {
+            buckets[bucketFor(entry.key)].push_back(entry);
+        }
+        buckets[i].clear();
+    }
+
+public:
+    RadixHeapQueue() : lastKey(0), count(0) {}
+
+    void init(int nodeCount) {
+        (void)nodeCount;
+        for (auto& bucket : buckets) {
+            bucket.clear();
+        }
+        lastKey = 0;
+        count = 0;
+    }
+
+    bool push(int nodeId, double key) {
+        uint64_t bits = toBits(key > 0.0 ? key : 0.0);
+        if (bits < lastKey) {
+            bits = lastKey;
+        }
+        buckets[bucketFor(bits)].push_back({bits, nodeId});
+        count++;
+        return true;
+    }
+
+    int pop() {
+        refill();
+        int nodeId = buckets[0].back().nodeId;
+        buckets[0].pop_back();
+        count--;
+        return nodeId;
+    }
+
+    // Not const: finding the minimum may redistribute a bucket
+    double minKey() {
+        refill();
+        double key;
+        std::memcpy(&key, &lastKey, sizeof(key));
+        return key;
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+};
+
+#endif
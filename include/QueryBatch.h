@@ -0,0 +1,268 @@
+#ifndef QUERY_BATCH_H
+#define QUERY_BATCH_H
+
+#include <vector>
+#include <string>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <unistd.h>
+
+// Batch query support shared by the sequential and distributed binaries.
+//
+// Query stream format (file or stdin), one pair per line:
+//   <source> <destination>
+// Blank lines and lines starting with '#' are ignored. Queries are read
+// one at a time, so results can be streamed while input is still arriving.
+
+// A single point-to-point query
+struct Query {
+    int source;
+    int destination;
+
+    Query() : source(-1), destination(-1) {}
+    Query(int s, int t) : source(s), destination(t) {}
+};
+
+// Reads queries from a file, or from stdin when the name is "-"
+class QueryReader {
+private:
+    std::ifstream file;
+    std::istream* input;
+    int lineNumber;
+
+public:
+    QueryReader() : input(nullptr), lineNumber(0) {}
+
+    bool open(const std::string& filename) {
+        if (filename == "-") {
+            input = &std::cin;
+            return true;
+        }
+        file.open(filename);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot open query file " << filename << std::endl;
+            return false;
+        }
+        input = &file;
+        return true;
+    }
+
+    // Next query; returns false at end of input. Malformed lines are
+    // reported and skipped.
+    bool next(Query& query) {
+        std::string line;
+        while (std::getline(*input, line)) {
+            lineNumber++;
+            size_t start = line.find_first_not_of(" \t\r");
+            if (start == std::string::npos || line[start] == '#') {
+                continue;
+            }
+            std::istringstream iss(line);
+            if (iss >> query.source >> query.destination) {
+                return true;
+            }
+            std::cerr << "Warning: Skipping malformed query on line " << lineNumber << std::endl;
+        }
+        return false;
+    }
+};
+
+// Uniform random pairs from a fixed seed, so benchmark runs on different
+// builds and binaries answer the same queries
+inline std::vector<Query> makeRandomQueries(int nodeCount, int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> pick(0, nodeCount - 1);
+    std::vector<Query> queries;
+    queries.reserve(count);
+    for (int i = 0; i < count; i++) {
+        int source = pick(rng);
+        queries.emplace_back(source, pick(rng));
+    }
+    return queries;
+}
+
+// Write queries in the format QueryReader accepts
+inline bool saveQueries(const std::vector<Query>& queries, const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot create query file " << filename << std::endl;
+        return false;
+    }
+    for (const Query& query : queries) {
+        file << query.source << " " << query.destination << "\n";
+    }
+    return (bool)file;
+}
+
+enum class ResultFormat {
+    CSV,
+    JSONL
+};
+
+inline bool parseResultFormat(const std::string& name, ResultFormat& format) {
+    if (name == "csv") {
+        format = ResultFormat::CSV;
+    } else if (name == "jsonl" || name == "json") {
+        format = ResultFormat::JSONL;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Writes one result per query as CSV rows or JSON lines, to a file or
+// stdout when the name is "-"
+class QueryResultWriter {
+private:
+    std::ofstream file;
+    std::ostream* output;
+    ResultFormat format;
+
+public:
+    QueryResultWriter() : output(&std::cout), format(ResultFormat::CSV) {}
+
+    bool open(const std::string& filename, ResultFormat resultFormat) {
+        format = resultFormat;
+        if (filename != "-") {
+            file.open(filename);
+            if (!file.is_open()) {
+                std::cerr << "Error: Cannot create result file " << filename << std::endl;
+                return false;
+            }
+            output = &file;
+        }
+        if (format == ResultFormat::CSV) {
+            *output << "query,source,destination,found,distance,hops,latency_us\n";
+        }
+        return true;
+    }
+
+    // Continue the result file of an interrupted run after its first kept
+    // results: any later lines (answers the resumed run computes again) are
+    // cut off and new results are appended. Fails if the file holds fewer
+    // than kept complete results. Standard output, or a run that kept
+    // nothing, simply opens the file afresh.
+    bool resume(const std::string& filename, ResultFormat resultFormat, int kept) {
+        if (filename == "-" || kept == 0) {
+            return open(filename, resultFormat);
+        }
+        format = resultFormat;
+        int lines = kept + (format == ResultFormat::CSV ? 1 : 0);
+        std::ifstream existing(filename, std::ios::binary);
+        std::string line;
+        std::streamoff end = 0;
+        int complete = 0;
+        while (complete < lines && std::getline(existing, line) && !existing.eof()) {
+            complete++;
+            end = existing.tellg();
+        }
+        existing.close();
+        if (complete < lines) {
+            std::cerr << "Error: " << filename << " holds fewer than the " << kept
+                      << " results answered before the checkpoint" << std::endl;
+            return false;
+        }
+        if (::truncate(filename.c_str(), end) != 0) {
+            std::cerr << "Error: Cannot truncate result file " << filename << std::endl;
+            return false;
+        }
+        file.open(filename, std::ios::app);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot append to result file " << filename << std::endl;
+            return false;
+        }
+        output = &file;
+        return true;
+    }
+
+    // hops is the number of path edges, or -1 if the solver has no path
+    void write(int index, const Query& query, double distance, int hops, double latencyUs) {
+        bool found = distance != std::numeric_limits<double>::infinity();
+        std::ostream& out = *output;
+        if (format == ResultFormat::CSV) {
+            out << index << "," << query.source << "," << query.destination << ","
+                << (found ? 1 : 0) << ",";
+            if (found) {
+                out << distance;
+            }
+            out << "," << hops << "," << latencyUs << "\n";
+        } else {
+            out << "{\"query\":" << index << ",\"source\":" << query.source
+                << ",\"destination\":" << query.destination
+                << ",\"found\":" << (found ? "true" : "false") << ",\"distance\":";
+            if (found) {
+                out << distance;
+            } else {
+                out << "null";
+            }
+            out << ",\"hops\":" << hops << ",\"latency_us\":" << latencyUs << "}\n";
+        }
+    }
+
+    void flush() {
+        output->flush();
+    }
+};
+
+// Throughput and latency percentiles of a batch
+struct LatencySummary {
+    long long queries = 0;
+    double wallMs = 0.0;
+    double queriesPerSecond = 0.0;
+    double meanUs = 0.0;
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+
+    // Nearest-rank percentile of an ascending sample
+    static double percentile(const std::vector<double>& sorted, double fraction) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        size_t rank = (size_t)std::ceil(fraction * sorted.size());
+        return sorted[std::min(std::max(rank, (size_t)1), sorted.size()) - 1];
+    }
+
+    static LatencySummary compute(std::vector<double> latenciesUs, double wallMs) {
+        LatencySummary summary;
+        summary.queries = latenciesUs.size();
+        summary.wallMs = wallMs;
+        if (latenciesUs.empty()) {
+            return summary;
+        }
+        std::sort(latenciesUs.begin(), latenciesUs.end());
+        double total = 0.0;
+        for (double latency : latenciesUs) {
+            total += latency;
+        }
+        summary.meanUs = total / latenciesUs.size();
+        summary.p50Us = percentile(latenciesUs, 0.50);
+        summary.p99Us = percentile(latenciesUs, 0.99);
+        summary.maxUs = latenciesUs.back();
+        if (wallMs > 0.0) {
+            summary.queriesPerSecond = summary.queries * 1000.0 / wallMs;
+        }
+        return summary;
+    }
+
+    // Printed to stderr so it never mixes with results streamed to stdout
+    void print() const {
+        std::cerr << "-------------------------------------------\n";
+        std::cerr << "Batch summary:\n";
+        std::cerr << "  Queries: " << queries << "\n";
+        std::cerr << "  Wall time: " << wallMs << " ms\n";
+        std::cerr << "  Throughput: " << queriesPerSecond << " queries/sec\n";
+        std::cerr << "  Latency mean: " << meanUs << " us\n";
+        std::cerr << "  Latency p50: " << p50Us << " us\n";
+        std::cerr << "  Latency p99: " << p99Us << " us\n";
+        std::cerr << "  Latency max: " << maxUs << " us\n";
+        std::cerr << "-------------------------------------------\n";
+    }
+};
+
+#endif
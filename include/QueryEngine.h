@@ -0,0 +1,143 @@
+#ifndef QUERY_ENGINE_H
+#define QUERY_ENGINE_H
+
+#include "Dijkstra.h"
+#include "QueryBatch.h"
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+
+// Thread-pool query engine over one shared, read-only graph.
+//
+// Each worker owns a QuerySolver, so its epoch-stamped search state is
+// private to the thread and allocated (first touched) by it; the graph and
+// reverse graph are only ever read. Queries are handed out from a bounded
+// queue: submit() blocks while the queue is full, which lets a producer
+// stream queries from stdin without buffering the whole input.
+//
+// The result handler runs on the worker thread that solved the query, so
+// handlers that share state (e.g. an output stream) must synchronise it.
+template <typename Queue>
+class QueryEngine {
+public:
+    using ResultHandler = std::function<void(int index, const Query& query,
+                                             const PathResult& result, double latencyUs)>;
+
+    // Per-worker counters, valid after wait()
+    struct WorkerStats {
+        long long queries = 0;
+        double busyMs = 0.0;
+    };
+
+private:
+    struct Job {
+        int index;
+        Query query;
+    };
+
+    const CSRGraph& graph;
+    const CSRGraph* reverse;
+    SearchOptions options;
+    ResultHandler handler;
+    size_t capacity;
+
+    std::vector<std::thread> workers;
+    std::vector<WorkerStats> workerStats;
+    std::deque<Job> jobs;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;  // Workers wait for jobs
+    std::condition_variable spaceAvailable; // submit() waits for room
+    std::condition_variable allDone;       // wait() waits for completion
+    long long inFlight;                    // Submitted but not finished
+    bool stopping;
+
+    void workerLoop(int id) {
+        QuerySolver<Queue> solver(graph, reverse, options);
+        WorkerStats local;
+
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (jobs.empty()) {
+                    break;
+                }
+                job = jobs.front();
+                jobs.pop_front();
+            }
+            spaceAvailable.notify_one();
+
+            auto start = std::chrono::high_resolution_clock::now();
+            PathResult result = solver.solve(job.query.source, job.query.destination);
+            double latencyUs = std::chrono::duration<double, std::micro>(
+                std::chrono::high_resolution_clock::now() - start).count();
+
+            local.queries++;
+            local.busyMs += latencyUs / 1000.0;
+            handler(job.index, job.query, result, latencyUs);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            workerStats[id] = local;
+            if (--inFlight == 0) {
+                allDone.notify_all();
+            }
+        }
+    }
+
+public:
+    QueryEngine(const CSRGraph& g, const CSRGraph* reverseGraph, const SearchOptions& searchOptions,
+                int threadCount, ResultHandler resultHandler, size_t queueCapacity = 1024)
+        : graph(g), reverse(reverseGraph), options(searchOptions), handler(resultHandler),
+          capacity(queueCapacity), workerStats(threadCount), inFlight(0), stopping(false) {
+        for (int i = 0; i < threadCount; i++) {
+            workers.emplace_back(&QueryEngine::workerLoop, this, i);
+        }
+    }
+
+    ~QueryEngine() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        jobAvailable.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    QueryEngine(const QueryEngine&) = delete;
+    QueryEngine& operator=(const QueryEngine&) = delete;
+
+    // Queue a query for any idle worker
+    void submit(int index, const Query& query) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            spaceAvailable.wait(lock, [this] { return jobs.size() < capacity; });
+            jobs.push_back({index, query});
+            inFlight++;
+        }
+        jobAvailable.notify_one();
+    }
+
+    // Block until every submitted query has been answered
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        allDone.wait(lock, [this] { return inFlight == 0; });
+    }
+
+    int getThreadCount() const {
+        return workers.size();
+    }
+
+    std::vector<WorkerStats> getWorkerStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return workerStats;
+    }
+};
+
+#endif
@@ -0,0 +1,238 @@
+#ifndef RELAX_KERNEL_H
+#define RELAX_KERNEL_H
+
+#include <string>
+#include <limits>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RELAX_KERNEL_X86 1
+#endif
+
+// SIMD kernels for the bulk relaxation pass of the distributed solvers.
+//
+// A shard stores each row as parallel target and weight arrays, so the
+// edges of a node can be scanned a vector at a time: broadcast dist(u), add
+// 4 (AVX2) or 8 (AVX-512) weights, gather the targets' distances and
+// compare. Most candidates do not improve anything, so the kernel only
+// filters: it returns the edges whose candidate beats the current distance
+// and the caller offers those one by one. That scalar commit re-checks
+// every candidate, so two lanes with the same target (parallel edges) need
+// no conflict detection and the results equal the plain loop's.
+//
+// The kernels are compiled with target attributes and picked at runtime
+// from the CPU features, so the binary still runs on machines without AVX.
+enum class SimdLevel {
+    Scalar,
+    AVX2,
+    AVX512
+};
+
+inline bool isSimdLevelSupported(SimdLevel level) {
+#ifdef RELAX_KERNEL_X86
+    switch (level) {
+        case SimdLevel::AVX512: return __builtin_cpu_supports("avx512f");
+        case SimdLevel::AVX2: return __builtin_cpu_supports("avx2");
+        default: return true;
+    }
+#else
+    return level == SimdLevel::Scalar;
+#endif
+}
+
+// Widest level this CPU runs
+inline SimdLevel detectSimdLevel() {
+    if (isSimdLevelSupported(SimdLevel::AVX512)) {
+        return SimdLevel::AVX512;
+    }
+    if (isSimdLevelSupported(SimdLevel::AVX2)) {
+        return SimdLevel::AVX2;
+    }
+    return SimdLevel::Scalar;
+}
+
+// "auto" picks detectSimdLevel()
+inline bool parseSimdLevel(const std::string& name, SimdLevel& level) {
+    if (name == "auto") {
+        level = detectSimdLevel();
+    } else if (name == "scalar") {
+        level = SimdLevel::Scalar;
+    } else if (name == "avx2") {
+        level = SimdLevel::AVX2;
+    } else if (name == "avx512") {
+        level = SimdLevel::AVX512;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+inline const char* getSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+// Doubles per vector
+inline int getSimdLevelLanes(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return 4;
+        case SimdLevel::AVX512: return 8;
+        default: return 1;
+    }
+}
+
+// Weights a relaxation pass takes: lo < w <= hi. Delta-stepping relaxes
+// light (w <= delta) and heavy (w > delta) edges in separate passes.
+struct WeightRange {
+    double lo;
+    double hi;
+
+    static WeightRange all() {
+        return WeightRange{-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+    }
+    static WeightRange upTo(double limit) {
+        return WeightRange{-std::numeric_limits<double>::infinity(), limit};
+    }
+    static WeightRange above(double limit) {
+        return WeightRange{limit, std::numeric_limits<double>::infinity()};
+    }
+
+    bool operator()(double w) const {
+        return w > lo && w <= hi;
+    }
+};
+
+// Scan the count edges of one node: writes the index of every edge in range
+// whose candidate distU + weight beats distances[target] to improving and
+// returns how many there are; kept is set to the number of edges in range
+template <typename Weight>
+using RelaxFilter = int (*)(const int* targets, const Weight* weights, int count, double distU,
+                            const double* distances, WeightRange range, int* improving, int& kept);
+
+template <typename Weight>
+int relaxFilterScalar(const int* targets, const Weight* weights, int count, double distU,
+                      const double* distances, WeightRange range, int* improving, int& kept) {
+    int found = 0;
+    kept = 0;
+    for (int i = 0; i < count; i++) {
+        double w = weights[i];
+        if (!range(w)) {
+            continue;
+        }
+        kept++;
+        if (distU + w < distances[targets[i]]) {
+            improving[found++] = i;
+        }
+    }
+    return found;
+}
+
+#ifdef RELAX_KERNEL_X86
+// Four weights as doubles; uint32 is converted through signed int32 with
+// the top bit flipped, since AVX2 has no unsigned conversion
+__attribute__((target("avx2"))) inline __m256d loadWeights4(const double* w) {
+    return _mm256_loadu_pd(w);
+}
+__attribute__((target("avx2"))) inline __m256d loadWeights4(const float* w) {
+    return _mm256_cvtps_pd(_mm_loadu_ps(w));
+}
+__attribute__((target("avx2"))) inline __m256d loadWeights4(const uint32_t* w) {
+    __m128i flipped = _mm_xor_si128(_mm_loadu_si128((const __m128i*)w), _mm_set1_epi32((int)0x80000000u));
+    return _mm256_add_pd(_mm256_cvtepi32_pd(flipped), _mm256_set1_pd(2147483648.0));
+}
+
+template <typename Weight>
+__attribute__((target("avx2")))
+int relaxFilterAvx2(const int* targets, const Weight* weights, int count, double distU,
+                    const double* distances, WeightRange range, int* improving, int& kept) {
+    const __m256d base = _mm256_set1_pd(distU);
+    const __m256d lo = _mm256_set1_pd(range.lo);
+    const __m256d hi = _mm256_set1_pd(range.hi);
+    int found = 0;
+    int inRange = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d w = loadWeights4(weights + i);
+        __m256d keep = _mm256_and_pd(_mm256_cmp_pd(w, lo, _CMP_GT_OQ), _mm256_cmp_pd(w, hi, _CMP_LE_OQ));
+        __m128i index = _mm_loadu_si128((const __m128i*)(targets + i));
+        // Lanes outside the range are not even gathered
+        __m256d current = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), distances, index, keep, 8);
+        __m256d better = _mm256_and_pd(keep, _mm256_cmp_pd(_mm256_add_pd(base, w), current, _CMP_LT_OQ));
+        inRange += __builtin_popcount(_mm256_movemask_pd(keep));
+        for (int mask = _mm256_movemask_pd(better); mask != 0; mask &= mask - 1) {
+            improving[found++] = i + __builtin_ctz(mask);
+        }
+    }
+    int tailKept;
+    int tailFound = relaxFilterScalar(targets + i, weights + i, count - i, distU, distances, range,
+                                      improving + found, tailKept);
+    for (int k = found; k < found + tailFound; k++) {
+        improving[k] += i;
+    }
+    kept = inRange + tailKept;
+    return found + tailFound;
+}
+
+// Eight weights as doubles
+__attribute__((target("avx512f"))) inline __m512d loadWeights8(const double* w) {
+    return _mm512_loadu_pd(w);
+}
+__attribute__((target("avx512f"))) inline __m512d loadWeights8(const float* w) {
+    return _mm512_maskz_cvtps_pd(0xFF, _mm256_loadu_ps(w));
+}
+__attribute__((target("avx512f"))) inline __m512d loadWeights8(const uint32_t* w) {
+    return _mm512_maskz_cvtepu32_pd(0xFF, _mm256_loadu_si256((const __m256i*)w));
+}
+
+template <typename Weight>
+__attribute__((target("avx512f")))
+int relaxFilterAvx512(const int* targets, const Weight* weights, int count, double distU,
+                      const double* distances, WeightRange range, int* improving, int& kept) {
+    const __m512d base = _mm512_set1_pd(distU);
+    const __m512d lo = _mm512_set1_pd(range.lo);
+    const __m512d hi = _mm512_set1_pd(range.hi);
+    int found = 0;
+    int inRange = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512d w = loadWeights8(weights + i);
+        __mmask8 keep = _mm512_cmp_pd_mask(w, lo, _CMP_GT_OQ) & _mm512_cmp_pd_mask(w, hi, _CMP_LE_OQ);
+        __m256i index = _mm256_loadu_si256((const __m256i*)(targets + i));
+        // Lanes outside the range are not even gathered
+        __m512d current = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), keep, index, distances, 8);
+        __mmask8 better = _mm512_mask_cmp_pd_mask(keep, _mm512_add_pd(base, w), current, _CMP_LT_OQ);
+        inRange += __builtin_popcount(keep);
+        for (unsigned mask = better; mask != 0; mask &= mask - 1) {
+            improving[found++] = i + __builtin_ctz(mask);
+        }
+    }
+    int tailKept;
+    int tailFound = relaxFilterScalar(targets + i, weights + i, count - i, distU, distances, range,
+                                      improving + found, tailKept);
+    for (int k = found; k < found + tailFound; k++) {
+        improving[k] += i;
+    }
+    kept = inRange + tailKept;
+    return found + tailFound;
+}
+#endif
+
+// Kernel for a level; unsupported levels fall back to the next narrower one
+template <typename Weight>
+RelaxFilter<Weight> selectRelaxFilter(SimdLevel level) {
+#ifdef RELAX_KERNEL_X86
+    if (level == SimdLevel::AVX512 && isSimdLevelSupported(SimdLevel::AVX512)) {
+        return &relaxFilterAvx512<Weight>;
+    }
+    if (level != SimdLevel::Scalar && isSimdLevelSupported(SimdLevel::AVX2)) {
+        return &relaxFilterAvx2<Weight>;
+    }
+#endif
+    (void)level;
+    return &relaxFilterScalar<Weight>;
+}
+
+#endif
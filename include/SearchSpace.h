@@ -0,0 +1,88 @@
+#ifndef SEARCH_SPACE_H
+#define SEARCH_SPACE_H
+
+#include "Graph.h"
+#include "PriorityQueue.h"
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+// Per-search labels, kept alive across queries.
+// Instead of resetting every node before each query, a label is only valid
+// if its epoch matches the current search; prepare() just advances the
+// epoch, so a query costs what it touches rather than O(V). Distance,
+// predecessor and epoch share one 16-byte entry so a relaxation touches a
+// single cache line per node.
+template <typename Queue>
+class SearchSpace {
+private:
+    struct Label {
+        double distance;
+        int predecessor;
+        unsigned epoch;
+    };
+
+    std::vector<Label> labels;
+    std::vector<unsigned> settledEpoch;
+    unsigned epoch;
+
+public:
+    Queue pq;
+
+    SearchSpace() : epoch(0) {}
+
+    // Start a new search over nodeCount nodes
+    void prepare(int nodeCount) {
+        if ((int)labels.size() != nodeCount) {
+            labels.assign(nodeCount, Label{0.0, -1, 0});
+            settledEpoch.assign(nodeCount, 0);
+            epoch = 0;
+        }
+        epoch++;
+        if (epoch == 0) {
+            // Counter wrapped: stamps from 2^32 searches ago would look current
+            std::fill(labels.begin(), labels.end(), Label{0.0, -1, 0});
+            std::fill(settledEpoch.begin(), settledEpoch.end(), 0);
+            epoch = 1;
+        }
+        pq.init(nodeCount);
+    }
+
+    double getDistance(int node) const {
+        const Label& label = labels[node];
+        return label.epoch == epoch ? label.distance : std::numeric_limits<double>::infinity();
+    }
+
+    int getPredecessor(int node) const {
+        const Label& label = labels[node];
+        return label.epoch == epoch ? label.predecessor : -1;
+    }
+
+    // Record a better distance for a node
+    void label(int node, double distance, int predecessor) {
+        labels[node] = Label{distance, predecessor, epoch};
+    }
+
+    bool isSettled(int node) const {
+        return settledEpoch[node] == epoch;
+    }
+
+    void settle(int node) {
+        settledEpoch[node] = epoch;
+    }
+
+    // Path from the search root to node by following predecessors
+    void buildPath(PathResult& result, int node) const {
+        std::vector<int> reversePath;
+        for (int current = node; current != -1; current = getPredecessor(current)) {
+            reversePath.push_back(current);
+        }
+        result.path.assign(reversePath.rbegin(), reversePath.rend());
+    }
+
+    size_t getMemoryBytes() const {
+        return labels.capacity() * sizeof(Label) + settledEpoch.capacity() * sizeof(unsigned);
+    }
+};
+
+#endif
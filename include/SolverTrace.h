@@ -0,0 +1,176 @@
+#ifndef SOLVER_TRACE_H
+#define SOLVER_TRACE_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+
+// Per-rank timeline of the distributed solver.
+//
+// Every rank always sums the time it spends in each phase, which costs one
+// clock read per phase. With recording enabled it also keeps one event per
+// phase instance (per superstep or round), so a run can be opened in
+// chrome://tracing or https://ui.perfetto.dev with one row per rank, or
+// loaded from CSV. Events are plain structs so the ranks can gather them as
+// bytes.
+//
+// CSV layout, one event per line:
+//   rank,phase,iteration,start_us,duration_us,frontier,bytes
+
+enum class TracePhase {
+    Compute,      // Relaxing edges
+    Exchange,     // Sending and applying distance updates
+    Allreduce,    // Other global reductions (delta-stepping bucket selection)
+    Convergence,  // Convergence checks (BSP) and termination detection (async)
+    Wait,         // Async: blocked with nothing to do
+    Count
+};
+
+enum class TraceFormat {
+    Chrome,
+    CSV
+};
+
+inline bool parseTraceFormat(const std::string& name, TraceFormat& format) {
+    if (name == "chrome" || name == "json") {
+        format = TraceFormat::Chrome;
+    } else if (name == "csv") {
+        format = TraceFormat::CSV;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+struct TraceEvent {
+    int32_t rank;
+    int32_t phase;
+    int64_t iteration;  // Superstep, phase or round the event belongs to
+    double startUs;     // Since the rank's origin
+    double durationUs;
+    int64_t frontier;   // Compute: nodes relaxed
+    int64_t bytes;      // Exchange: bytes this rank sent
+};
+
+class SolverTrace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    static const int PHASE_COUNT = (int)TracePhase::Count;
+
+    int rank;
+    bool recording;
+    Clock::time_point origin;
+    double totalsMs[PHASE_COUNT];
+    std::vector<TraceEvent> events;
+
+public:
+    static const char* phaseName(int phase) {
+        static const char* names[PHASE_COUNT] = {"compute", "exchange", "allreduce", "convergence", "wait"};
+        return names[phase];
+    }
+
+    SolverTrace(int rankId, bool recordEvents)
+        : rank(rankId), recording(recordEvents), origin(Clock::now()) {
+        for (double& total : totalsMs) {
+            total = 0.0;
+        }
+    }
+
+    // Timestamps are relative to this point; call it right after the
+    // barrier that starts the run so the ranks line up
+    void start() {
+        origin = Clock::now();
+    }
+
+    // Forget everything recorded so far
+    void clear() {
+        for (double& total : totalsMs) {
+            total = 0.0;
+        }
+        events.clear();
+    }
+
+    static Clock::time_point now() {
+        return Clock::now();
+    }
+
+    // Close a phase that began at `begin`
+    void record(TracePhase phase, Clock::time_point begin, long long iteration,
+                long long frontier = 0, long long bytes = 0) {
+        Clock::time_point end = Clock::now();
+        double durationUs = std::chrono::duration<double, std::micro>(end - begin).count();
+        totalsMs[(int)phase] += durationUs / 1000.0;
+        if (recording) {
+            double startUs = std::chrono::duration<double, std::micro>(begin - origin).count();
+            events.push_back(TraceEvent{rank, (int32_t)phase, iteration, startUs, durationUs,
+                                        frontier, bytes});
+        }
+    }
+
+    // Count a phase instance in the totals only, for frequent polls that
+    // would flood the timeline without showing anything
+    void accumulate(TracePhase phase, Clock::time_point begin) {
+        totalsMs[(int)phase] += std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+
+    double getTotalMs(TracePhase phase) const {
+        return totalsMs[(int)phase];
+    }
+
+    bool isRecording() const { return recording; }
+    const std::vector<TraceEvent>& getEvents() const { return events; }
+
+    // Write the events of all ranks
+    static bool write(const std::string& filename, TraceFormat format,
+                      const std::vector<TraceEvent>& allEvents, int rankCount) {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot create trace file " << filename << std::endl;
+            return false;
+        }
+        // Nanosecond resolution however long the run; the default precision
+        // rounds timestamps past ~10 s to tens of microseconds
+        file << std::fixed << std::setprecision(3);
+
+        if (format == TraceFormat::CSV) {
+            file << "rank,phase,iteration,start_us,duration_us,frontier,bytes\n";
+            for (const TraceEvent& event : allEvents) {
+                file << event.rank << ',' << phaseName(event.phase) << ',' << event.iteration << ','
+                     << event.startUs << ',' << event.durationUs << ','
+                     << event.frontier << ',' << event.bytes << '\n';
+            }
+        } else {
+            // Trace Event Format: complete ("X") events, one process per rank
+            file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+            const char* separator = "\n";
+            for (int r = 0; r < rankCount; r++) {
+                file << separator << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << r
+                     << ",\"tid\":0,\"args\":{\"name\":\"rank " << r << "\"}}";
+                separator = ",\n";
+            }
+            for (const TraceEvent& event : allEvents) {
+                file << separator << "{\"name\":\"" << phaseName(event.phase) << "\",\"ph\":\"X\",\"pid\":"
+                     << event.rank << ",\"tid\":0,\"ts\":" << event.startUs
+                     << ",\"dur\":" << event.durationUs << ",\"args\":{\"iteration\":"
+                     << event.iteration << ",\"frontier\":" << event.frontier
+                     << ",\"bytes\":" << event.bytes << "}}";
+                separator = ",\n";
+            }
+            file << "\n]}\n";
+        }
+
+        if (!file) {
+            std::cerr << "Error: Failed writing " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+#endif
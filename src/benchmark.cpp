@@ -0,0 +1,328 @@
+#include "../include/Dijkstra.h"
+#include "../include/QueryBatch.h"
+#include "../include/BenchmarkReport.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+
+using namespace std;
+using namespace std::chrono;
+
+// One point-to-point configuration to measure
+struct Method {
+    string name;  // As given to --methods
+    SearchOptions options;
+};
+
+// Method names and the solver options they select. ALT and CH methods
+// are filled in with the preprocessed data once it is loaded.
+bool parseMethod(const string& name, Method& method) {
+    method.name = name;
+    method.options = SearchOptions();
+    SearchOptions& options = method.options;
+    if (name == "dijkstra") {
+    } else if (name == "dary") {
+        options.policy = QueuePolicy::DaryHeap;
+    } else if (name == "radix") {
+        options.policy = QueuePolicy::Radix;
+    } else if (name == "astar") {
+        options.useAStar = true;
+    } else if (name == "bidir") {
+        options.bidirectional = true;
+    } else if (name == "bidir-astar") {
+        options.bidirectional = true;
+        options.useAStar = true;
+    } else if (name == "alt") {
+        options.useAStar = true;
+    } else if (name == "alt-bidir") {
+        options.useAStar = true;
+        options.bidirectional = true;
+    } else if (name == "ch") {
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool usesLandmarks(const Method& method) {
+    return method.name == "alt" || method.name == "alt-bidir";
+}
+
+// Add the queue counters of one search to a running total
+void addSearchStats(SearchStats& total, const SearchStats& search) {
+    total.nodesSettled += search.nodesSettled;
+    total.edgesRelaxed += search.edgesRelaxed;
+    total.heapPushes += search.heapPushes;
+    total.decreaseKeys += search.decreaseKeys;
+    total.stalePops += search.stalePops;
+}
+
+// Answer the query set warmup + repeat times with one solver; every
+// measured repetition is one sample. Distances are checked on every pass.
+template <typename Queue>
+BenchmarkResult measure(const Method& method, const CSRGraph& graph, const CSRGraph* reverse,
+                        const vector<Query>& queries, const vector<double>& expected,
+                        int warmup, int repeat) {
+    QuerySolver<Queue> solver(graph, reverse, method.options);
+    vector<double> samples;
+    SearchStats totals;
+    long long wrong = 0;
+
+    for (int pass = 0; pass < warmup + repeat; pass++) {
+        bool measured = pass >= warmup;
+        SearchStats passStats;
+        auto start = steady_clock::now();
+        for (size_t q = 0; q < queries.size(); q++) {
+            PathResult result = solver.solve(queries[q].source, queries[q].destination);
+            addSearchStats(passStats, result.stats);
+            if (!sameDistance(expected[q], result.totalDistance)) {
+                wrong++;
+            }
+        }
+        double elapsedUs = duration<double, micro>(steady_clock::now() - start).count();
+        if (measured) {
+            samples.push_back(elapsedUs);
+            addSearchStats(totals, passStats);
+        }
+    }
+
+    BenchmarkResult result;
+    result.implementation = (method.name == "dijkstra") ? "Sequential" : "Sequential-" + method.name;
+    result.timeUs = SampleStats::compute(samples);
+    double perQuery = (double)repeat * max((size_t)1, queries.size());
+    result.addMetric("per_query_us", result.timeUs.median / max((size_t)1, queries.size()));
+    result.addMetric("nodes_settled", totals.nodesSettled / perQuery);
+    result.addMetric("edges_relaxed", totals.edgesRelaxed / perQuery);
+    result.addMetric("heap_pushes", totals.heapPushes / perQuery);
+    result.addMetric("decrease_keys", totals.decreaseKeys / perQuery);
+    result.addMetric("stale_pops", totals.stalePops / perQuery);
+    result.addMetric("wrong_distances", (double)wrong);
+    return result;
+}
+
+void printUsage(const char* programName) {
+    cout << "Benchmark - Repeated, seeded point-to-point measurements\n\n";
+    cout << "Usage:\n";
+    cout << "  " << programName << " <graph_file> [options]\n";
+    cout << "\nOptions:\n";
+    cout << "  --queries <n>       - Random query pairs (default: 100)\n";
+    cout << "  --seed <s>          - Seed for the query pairs (default: 1)\n";
+    cout << "  --query-file <f>    - Use the pairs in f instead of random ones\n";
+    cout << "  --save-queries <f>  - Write the query set, e.g. for distributed --batch\n";
+    cout << "  --warmup <n>        - Untimed passes over the query set (default: 1)\n";
+    cout << "  --repeat <n>        - Timed passes over the query set (default: 5)\n";
+    cout << "  --methods <list>    - Comma-separated, from dijkstra, dary, radix, astar,\n";
+    cout << "                        bidir, bidir-astar, alt, alt-bidir, ch\n";
+    cout << "                        (default: dijkstra,dary,astar,bidir)\n";
+    cout << "  --landmarks <f>     - Landmark file for alt and alt-bidir\n";
+    cout << "  --ch <f>            - Hierarchy file for ch\n";
+    cout << "  --label <name>      - Run label stored in the JSON (e.g. a build or commit)\n";
+    cout << "  --json <f>          - Write results as JSON for visualize.py\n";
+    cout << "\nExample:\n";
+    cout << "  " << programName << " data/graph_15000.txt --queries 200 --repeat 10 --json results/seq_15000.json\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || string(argv[1]) == "--help") {
+        printUsage(argv[0]);
+        return argc < 2 ? 1 : 0;
+    }
+
+    string graphFile = argv[1];
+    int queryCount = 100;
+    unsigned seed = 1;
+    string queryFile;
+    string saveFile;
+    int warmup = 1;
+    int repeat = 5;
+    string methodList = "dijkstra,dary,astar,bidir";
+    string landmarkFile;
+    string hierarchyFile;
+    string label;
+    string jsonFile;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--queries" && i + 1 < argc) {
+            queryCount = atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--query-file" && i + 1 < argc) {
+            queryFile = argv[++i];
+        } else if (arg == "--save-queries" && i + 1 < argc) {
+            saveFile = argv[++i];
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            warmup = atoi(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+        } else if (arg == "--methods" && i + 1 < argc) {
+            methodList = argv[++i];
+        } else if (arg == "--landmarks" && i + 1 < argc) {
+            landmarkFile = argv[++i];
+        } else if (arg == "--ch" && i + 1 < argc) {
+            hierarchyFile = argv[++i];
+        } else if (arg == "--label" && i + 1 < argc) {
+            label = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonFile = argv[++i];
+        } else {
+            cerr << "Error: Unknown option " << arg << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (queryCount <= 0 || warmup < 0 || repeat <= 0) {
+        cerr << "Error: --queries and --repeat must be positive, --warmup non-negative\n";
+        return 1;
+    }
+
+    vector<Method> methods;
+    stringstream names(methodList);
+    string name;
+    while (getline(names, name, ',')) {
+        Method method;
+        if (!parseMethod(name, method)) {
+            cerr << "Error: Unknown method " << name << "\n";
+            return 1;
+        }
+        if (usesLandmarks(method) && landmarkFile.empty()) {
+            cerr << "Error: Method " << name << " needs --landmarks\n";
+            return 1;
+        }
+        if (name == "ch" && hierarchyFile.empty()) {
+            cerr << "Error: Method ch needs --ch\n";
+            return 1;
+        }
+        methods.push_back(method);
+    }
+
+    CSRGraph graph;
+    if (!graph.loadFromFile(graphFile)) {
+        cerr << "Error: Failed to load graph file\n";
+        return 1;
+    }
+    int nodeCount = graph.getNodeCount();
+
+    vector<Query> queries;
+    if (queryFile.empty()) {
+        queries = makeRandomQueries(nodeCount, queryCount, seed);
+    } else {
+        QueryReader reader;
+        if (!reader.open(queryFile)) {
+            return 1;
+        }
+        Query query;
+        while (reader.next(query)) {
+            if (query.source >= 0 && query.source < nodeCount &&
+                query.destination >= 0 && query.destination < nodeCount) {
+                queries.push_back(query);
+            }
+        }
+        if (queries.empty()) {
+            cerr << "Error: No valid queries in " << queryFile << "\n";
+            return 1;
+        }
+    }
+    if (!saveFile.empty() && !saveQueries(queries, saveFile)) {
+        return 1;
+    }
+
+    LandmarkSet landmarks;
+    if (!landmarkFile.empty()) {
+        if (!landmarks.loadFromFile(landmarkFile)) {
+            return 1;
+        }
+        if (!landmarks.matches(graph)) {
+            cerr << "Error: " << landmarkFile << " was computed for a different graph\n";
+            return 1;
+        }
+    }
+    ContractionHierarchy hierarchy;
+    if (!hierarchyFile.empty()) {
+        if (!hierarchy.loadFromFile(hierarchyFile)) {
+            return 1;
+        }
+        if (!hierarchy.matches(graph)) {
+            cerr << "Error: " << hierarchyFile << " was built for a different graph\n";
+            return 1;
+        }
+    }
+    CSRGraph reverse = graph.getReverse();
+
+    // Reference distances, untimed
+    vector<double> expected;
+    expected.reserve(queries.size());
+    SearchSpace<BinaryHeapQueue> space;
+    for (const Query& query : queries) {
+        expected.push_back(sequentialDijkstra(graph, space, query.source, query.destination).totalDistance);
+    }
+
+    cout << "===========================================\n";
+    cout << "Point-to-Point Benchmark\n";
+    cout << "===========================================\n";
+    cout << "Graph: " << graphFile << " (" << nodeCount << " nodes, " << graph.getEdgeCount() << " edges)\n";
+    cout << "Queries: " << queries.size();
+    if (queryFile.empty()) {
+        cout << " (seed " << seed << ")";
+    } else {
+        cout << " (" << queryFile << ")";
+    }
+    cout << "\nPasses: " << warmup << " warm-up, " << repeat << " measured\n";
+    cout << "-------------------------------------------\n";
+    cout << left << setw(22) << "Method" << right << setw(12) << "Median ms" << setw(12) << "Min ms"
+         << setw(12) << "Stddev ms" << setw(12) << "us/query" << setw(12) << "Settled" << setw(12) << "Pushes"
+         << setw(12) << "Stale pops" << setw(8) << "Wrong" << "\n";
+
+    BenchmarkReport report(label, graphFile, nodeCount, graph.getEdgeCount(), queries.size(),
+                           queryFile.empty() ? (long long)seed : -1, warmup, repeat);
+    bool allCorrect = true;
+    for (Method& method : methods) {
+        if (usesLandmarks(method)) {
+            method.options.landmarks = &landmarks;
+        }
+        if (method.name == "ch") {
+            method.options.hierarchy = &hierarchy;
+        }
+        const CSRGraph* reverseGraph = method.options.bidirectional ? &reverse : nullptr;
+
+        BenchmarkResult result;
+        switch (method.options.policy) {
+            case QueuePolicy::DaryHeap:
+                result = measure<DaryHeapQueue<4>>(method, graph, reverseGraph, queries, expected, warmup, repeat);
+                break;
+            case QueuePolicy::Radix:
+                result = measure<RadixHeapQueue>(method, graph, reverseGraph, queries, expected, warmup, repeat);
+                break;
+            default:
+                result = measure<BinaryHeapQueue>(method, graph, reverseGraph, queries, expected, warmup, repeat);
+        }
+        report.add(result);
+
+        double wrong = result.metrics.back().second;
+        allCorrect = allCorrect && wrong == 0;
+        cout << left << setw(22) << result.implementation << right << fixed << setprecision(3)
+             << setw(12) << result.timeUs.median / 1000.0 << setw(12) << result.timeUs.min / 1000.0
+             << setw(12) << result.timeUs.stddev / 1000.0 << setprecision(1)
+             << setw(12) << result.metrics[0].second << setw(12) << result.metrics[1].second
+             << setw(12) << result.metrics[3].second << setw(12) << result.metrics[5].second
+             << setw(8) << (long long)wrong << "\n";
+        cout.unsetf(ios::floatfield);
+        cout << setprecision(6);
+    }
+    cout << "===========================================\n";
+
+    if (!jsonFile.empty()) {
+        if (!report.write(jsonFile)) {
+            return 1;
+        }
+        cout << "✓ Results written to " << jsonFile << "\n";
+    }
+    if (!allCorrect) {
+        cerr << "Error: Some methods returned wrong distances\n";
+        return 1;
+    }
+    return 0;
+}
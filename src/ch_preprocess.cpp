@@ -0,0 +1,138 @@
+#include "../include/Dijkstra.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+
+using namespace std;
+
+// Compare CH queries against plain Dijkstra on random pairs
+bool verifyHierarchy(const CSRGraph& graph, const ContractionHierarchy& hierarchy, int queryCount) {
+    mt19937 rng(7);
+    uniform_int_distribution<int> pick(0, graph.getNodeCount() - 1);
+
+    SearchSpace<BinaryHeapQueue> dijkstraSpace, forward, backward;
+    double dijkstraMs = 0.0, chMs = 0.0;
+    long long dijkstraSettled = 0, chSettled = 0;
+    int mismatches = 0;
+
+    for (int i = 0; i < queryCount; i++) {
+        int source = pick(rng);
+        int destination = pick(rng);
+
+        auto start = chrono::high_resolution_clock::now();
+        PathResult expected = sequentialDijkstra(graph, dijkstraSpace, source, destination);
+        auto middle = chrono::high_resolution_clock::now();
+        PathResult actual = hierarchy.query(forward, backward, source, destination);
+        auto end = chrono::high_resolution_clock::now();
+
+        dijkstraMs += chrono::duration<double, milli>(middle - start).count();
+        chMs += chrono::duration<double, milli>(end - middle).count();
+        dijkstraSettled += expected.stats.nodesSettled;
+        chSettled += actual.stats.nodesSettled;
+
+        bool same = expected.found == actual.found &&
+                    (!expected.found || sameDistance(expected.totalDistance, actual.totalDistance));
+        if (!same) {
+            if (mismatches < 5) {
+                cerr << "Mismatch " << source << " -> " << destination << ": Dijkstra "
+                     << expected.totalDistance << ", CH " << actual.totalDistance << "\n";
+            }
+            mismatches++;
+        }
+    }
+
+    cout << "-------------------------------------------\n";
+    cout << "Verification (" << queryCount << " random queries):\n";
+    cout << "  Mismatches: " << mismatches << "\n";
+    cout << "  Dijkstra: " << dijkstraMs / queryCount << " ms/query, "
+         << dijkstraSettled / queryCount << " nodes settled\n";
+    cout << "  CH:       " << chMs / queryCount << " ms/query, "
+         << chSettled / queryCount << " nodes settled\n";
+    if (chMs > 0.0) {
+        cout << "  Speedup:  " << dijkstraMs / chMs << "x\n";
+    }
+    return mismatches == 0;
+}
+
+void printUsage(const char* programName) {
+    cout << "CH Preprocess - Build a contraction hierarchy for fast queries\n\n";
+    cout << "Usage:\n";
+    cout << "  " << programName << " <graph_file> <output_file> [options]\n";
+    cout << "\nArguments:\n";
+    cout << "  graph_file    - Path to graph data file (text or binary)\n";
+    cout << "  output_file   - Hierarchy file for sequential/query_server --ch\n";
+    cout << "  --verify <n>  - Check n random queries against Dijkstra\n";
+    cout << "  --core-degree <d>\n";
+    cout << "                - Leave an uncontracted core once the remaining graph\n";
+    cout << "                  averages more than d arcs per node (default: " << CHBuildOptions().coreDegree << ")\n";
+    cout << "  --witness-limit <n>\n";
+    cout << "                - Nodes settled per witness search (default: " << CHBuildOptions().witnessSettleLimit << ")\n";
+    cout << "\nExample:\n";
+    cout << "  " << programName << " data/graph_15000.txt data/graph_15000.ch --core-degree 20 --verify 200\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    string graphFile = argv[1];
+    string outputFile = argv[2];
+    int verifyCount = 0;
+    CHBuildOptions options;
+    for (int i = 3; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--verify" && i + 1 < argc) {
+            verifyCount = atoi(argv[++i]);
+        } else if (arg == "--core-degree" && i + 1 < argc) {
+            options.coreDegree = atof(argv[++i]);
+        } else if (arg == "--witness-limit" && i + 1 < argc) {
+            options.witnessSettleLimit = max(1, atoi(argv[++i]));
+        } else {
+            cerr << "Error: Unknown option " << arg << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    CSRGraph graph;
+    if (!graph.loadFromFile(graphFile)) {
+        cerr << "Error: Failed to load graph file\n";
+        return 1;
+    }
+
+    cout << "===========================================\n";
+    cout << "Contraction Hierarchy Preprocessing\n";
+    cout << "===========================================\n";
+    graph.printInfo();
+
+    CHBuildStats stats;
+    auto start = chrono::high_resolution_clock::now();
+    ContractionHierarchy hierarchy = ContractionHierarchy::build(graph, options, stats);
+    stats.buildMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+
+    cout << "-------------------------------------------\n";
+    hierarchy.printInfo();
+    cout << "  Shortcuts added: " << stats.shortcuts << "\n";
+    cout << "  Core nodes: " << stats.coreNodes << "\n";
+    cout << "  Witness searches: " << stats.witnessSearches << "\n";
+    cout << "  Lazy priority updates: " << stats.lazyUpdates << "\n";
+    cout << "  Build time: " << stats.buildMs << " ms\n";
+
+    if (!hierarchy.saveToFile(outputFile)) {
+        return 1;
+    }
+    cout << "✓ Hierarchy written to " << outputFile << "\n";
+
+    bool ok = true;
+    if (verifyCount > 0) {
+        ok = verifyHierarchy(graph, hierarchy, verifyCount);
+    }
+    cout << "===========================================\n";
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+#include "../include/DistanceMatrix.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <cmath>
+
+using namespace std;
+
+// Compare random cells of the table against point-to-point Dijkstra
+bool verifyMatrix(const CSRGraph& graph, const vector<int>& sources, const vector<int>& targets,
+                  const vector<double>& sample, const vector<pair<int, int>>& cells) {
+    SearchSpace<DaryHeapQueue<4>> space;
+    int mismatches = 0;
+    for (size_t i = 0; i < cells.size(); i++) {
+        PathResult expected = sequentialDijkstra(graph, space, sources[cells[i].first], targets[cells[i].second]);
+        double want = expected.found ? expected.totalDistance : numeric_limits<double>::infinity();
+        double got = sample[i];
+        bool same = sameDistance(want, got);
+        if (!same) {
+            if (mismatches < 5) {
+                cerr << "  Mismatch " << graph.getOriginalId(sources[cells[i].first]) << " -> "
+                     << graph.getOriginalId(targets[cells[i].second])
+                     << ": table " << got << ", Dijkstra " << want << "\n";
+            }
+            mismatches++;
+        }
+    }
+    cout << "Verified " << cells.size() << " cells: " << mismatches << " mismatches\n";
+    return mismatches == 0;
+}
+
+void printUsage(const char* programName) {
+    cout << "Distance Matrix - Many-to-many shortest path distances in one pass\n\n";
+    cout << "Usage:\n";
+    cout << "  " << programName << " <graph_file> --sources <list> [--targets <list>] [options]\n";
+    cout << "\nArguments:\n";
+    cout << "  graph_file    - Path to graph data file (text or binary)\n";
+    cout << "  --sources     - Row nodes: \"s1,s2,...\" or \"@file\" (one ID per line)\n";
+    cout << "  --targets     - Column nodes, same syntax (default: the sources)\n";
+    cout << "  --output      - Matrix file (binary, see DistanceMatrix.h)\n";
+    cout << "  --ch          - Bucket-based search over a hierarchy from ch_preprocess;\n";
+    cout << "                  without it every source runs one Dijkstra\n";
+    cout << "  --threads     - Worker threads (default: hardware threads)\n";
+    cout << "  --distance-format double|float|fixed\n";
+    cout << "                - Stored values: double (default), float or 32-bit fixed point\n";
+    cout << "  --fixed-scale - Fixed point units per distance unit (required with fixed)\n";
+    cout << "  --verify <n>  - Check n random cells against point-to-point Dijkstra\n";
+    cout << "\nExample:\n";
+    cout << "  " << programName << " data/graph_15000.txt --sources @depots.txt --targets @customers.txt \\\n";
+    cout << "      --ch data/graph_15000.ch --threads 8 --output table.bin --distance-format float\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    string graphFile = argv[1];
+    string sourceSpec, targetSpec, outputFile, hierarchyFile;
+    int threads = max(1u, thread::hardware_concurrency());
+    DistanceEncoding encoding = DistanceEncoding::Float64;
+    double fixedScale = 0.0;
+    int verifyCount = 0;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--sources" && i + 1 < argc) {
+            sourceSpec = argv[++i];
+        } else if (arg == "--targets" && i + 1 < argc) {
+            targetSpec = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (arg == "--ch" && i + 1 < argc) {
+            hierarchyFile = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+            if (threads <= 0) {
+                cerr << "Error: --threads must be positive\n";
+                return 1;
+            }
+        } else if (arg == "--distance-format" && i + 1 < argc) {
+            if (!parseDistanceEncoding(argv[++i], encoding)) {
+                cerr << "Error: Unknown distance format " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--fixed-scale" && i + 1 < argc) {
+            fixedScale = atof(argv[++i]);
+            if (fixedScale <= 0.0) {
+                cerr << "Error: --fixed-scale must be positive\n";
+                return 1;
+            }
+        } else if (arg == "--verify" && i + 1 < argc) {
+            verifyCount = atoi(argv[++i]);
+        } else {
+            cerr << "Error: Unknown option " << arg << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    vector<int> sources, targets;
+    if (sourceSpec.empty()) {
+        cerr << "Error: --sources is required\n";
+        return 1;
+    }
+    if (!parseSourceList(sourceSpec, sources) ||
+        !parseSourceList(targetSpec.empty() ? sourceSpec : targetSpec, targets)) {
+        return 1;
+    }
+    // Rows are written as they are computed, so the largest distance is not
+    // known in time to pick a scale
+    if (encoding == DistanceEncoding::Fixed32 && fixedScale == 0.0) {
+        cerr << "Error: --distance-format fixed needs --fixed-scale\n";
+        return 1;
+    }
+
+    cout << "===========================================\n";
+    cout << "Many-to-Many Distance Matrix\n";
+    cout << "===========================================\n";
+    cout << "Loading graph from: " << graphFile << "\n";
+    CSRGraph graph;
+    if (!graph.loadFromFile(graphFile)) {
+        cerr << "Error: Failed to load graph file\n";
+        return 1;
+    }
+    graph.printInfo();
+
+    for (const vector<int>* list : {&sources, &targets}) {
+        for (int node : *list) {
+            if (node < 0 || node >= graph.getNodeCount()) {
+                cerr << "Error: Invalid node " << node << "\n";
+                return 1;
+            }
+        }
+    }
+    // The lists (and the file) keep original IDs; the searches run on the
+    // graph's own numbering, which differs for a reordered file
+    vector<int> sourceNodes, targetNodes;
+    for (int node : sources) {
+        sourceNodes.push_back(graph.getInternalId(node));
+    }
+    for (int node : targets) {
+        targetNodes.push_back(graph.getInternalId(node));
+    }
+
+    ContractionHierarchy hierarchy;
+    if (!hierarchyFile.empty()) {
+        if (!hierarchy.loadFromFile(hierarchyFile)) {
+            return 1;
+        }
+        if (!hierarchy.matches(graph)) {
+            cerr << "Error: " << hierarchyFile << " was built for a different graph\n";
+            return 1;
+        }
+    }
+
+    cout << "Table:       " << sources.size() << " x " << targets.size() << "\n";
+    cout << "Method:      " << (hierarchyFile.empty() ? "Dijkstra per source" : "CH buckets") << "\n";
+    cout << "Threads:     " << threads << "\n";
+
+    DistanceMatrixWriter writer;
+    if (!outputFile.empty() && !writer.open(outputFile, encoding, sources, targets, fixedScale)) {
+        return 1;
+    }
+
+    // Cells to verify are picked up front and copied out as their rows pass
+    vector<pair<int, int>> cells;
+    mt19937 gen(12345);
+    for (int i = 0; i < verifyCount; i++) {
+        cells.emplace_back(uniform_int_distribution<int>(0, sources.size() - 1)(gen),
+                           uniform_int_distribution<int>(0, targets.size() - 1)(gen));
+    }
+    vector<double> sample(cells.size());
+
+    long long reachable = 0;
+    size_t cols = targets.size();
+    DistanceMatrixEngine engine(graph, hierarchyFile.empty() ? nullptr : &hierarchy, threads);
+    auto start = chrono::high_resolution_clock::now();
+    MatrixStats stats = engine.compute(sourceNodes, targetNodes, [&](size_t firstRow, size_t rows, const double* values) {
+        for (size_t i = 0; i < rows * cols; i++) {
+            reachable += values[i] < numeric_limits<double>::infinity();
+        }
+        for (size_t c = 0; c < cells.size(); c++) {
+            if ((size_t)cells[c].first >= firstRow && (size_t)cells[c].first < firstRow + rows) {
+                sample[c] = values[(cells[c].first - firstRow) * cols + cells[c].second];
+            }
+        }
+        if (!outputFile.empty()) {
+            writer.writeRows(rows, values);
+        }
+    });
+    double totalMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+
+    if (!outputFile.empty() && !writer.close()) {
+        return 1;
+    }
+
+    long long cellCount = (long long)sources.size() * cols;
+    cout << "-------------------------------------------\n";
+    cout << "Results:\n";
+    cout << "  Cells: " << cellCount << " (" << reachable << " reachable)\n";
+    if (!hierarchyFile.empty()) {
+        cout << "  Bucket phase: " << stats.bucketMs << " ms (" << stats.bucketEntries << " entries, "
+             << engine.getBucketBytes() / 1024 << " KB)\n";
+        cout << "  Table phase: " << stats.tableMs << " ms (" << stats.bucketScans << " bucket scans)\n";
+        cout << "  Nodes settled: " << stats.backwardSettled << " backward, "
+             << stats.forwardSettled << " forward\n";
+    } else {
+        cout << "  Nodes settled: " << stats.forwardSettled << "\n";
+    }
+    cout << "  Total time: " << totalMs << " ms (" << totalMs * 1000.0 / max(cellCount, 1LL) << " us/cell)\n";
+    if (!outputFile.empty()) {
+        cout << "  Matrix: " << outputFile << " (" << getDistanceEncodingName(encoding) << ", "
+             << cellCount * (long long)getDistanceEncodingBytes(encoding) / 1024 << " KB)\n";
+        if (writer.getSaturatedCount() > 0) {
+            cerr << "Warning: " << writer.getSaturatedCount()
+                 << " distances exceed the fixed-point range and were clamped\n";
+        }
+    }
+
+    bool ok = true;
+    if (!cells.empty()) {
+        ok = verifyMatrix(graph, sourceNodes, targetNodes, sample, cells);
+    }
+    cout << "===========================================\n";
+    return ok ? 0 : 1;
+}
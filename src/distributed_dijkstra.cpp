@@ -1,148 +1,2677 @@
-#include "../include/Graph.h"
+#include "../include/CSRGraph.h"
 #include "../include/Partitioner.h"
+#include "../include/MPIWrapper.h"
+#include "../include/GraphShard.h"
+#include "../include/QueryBatch.h"
+#include "../include/PriorityQueue.h"
+#include "../include/SolverTrace.h"
+#include "../include/BenchmarkReport.h"
+#include "../include/DistanceField.h"
+#include "../include/DynamicGraph.h"
+#include "../include/RelaxKernel.h"
+#include "../include/Checkpoint.h"
 #include <mpi.h>
 #include <vector>
 #include <limits>
 #include <iostream>
 #include <chrono>
-#include <unordered_set>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <list>
+#include <iomanip>
+#include <sys/resource.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 using namespace std::chrono;
 
-int main(int argc, char* argv[]) {
-    MPI_Init(&argc, &argv);
-    
-    int rank, size;
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &size);
-    
+const double INF = numeric_limits<double>::infinity();
+
+enum class SolverMode {
+    BSP,        // Frontier Bellman-Ford supersteps
+    Pipelined,  // BSP with the exchange overlapping interior relaxation
+    Delta,      // Delta-stepping
+    Async       // No supersteps, token-based termination
+};
+
+// How a one-to-all run writes its distance field
+enum class DistanceIO {
+    Parallel,  // Every rank writes its own nodes through MPI-IO
+    Gather     // Rank 0 gathers all distances and writes the file
+};
+
+// Per-rank solver statistics. Work counters are 64-bit: a batch on a large
+// graph relaxes far more than 2^31 edges.
+struct SolverStats {
+    int iterations = 0;          // BSP supersteps (Bellman-Ford), phases (delta-stepping)
+                                 // or relaxation rounds (async)
+    int buckets = 0;             // Buckets processed (delta-stepping only)
+    long long edgesRelaxed = 0;
+    long long localUpdates = 0;
+    int tokenRounds = 0;         // Termination token circulations (async only)
+    int stealRequests = 0;       // Work requests sent (async with --steal only)
+    long long verticesStolen = 0; // Frontier nodes taken from other ranks
+    long long verticesGiven = 0;  // Frontier nodes handed to other ranks
+    double solveMs = 0.0;        // Time inside the solver; SolverTrace splits it up
+};
+
+// Routes distance improvements to the rank that owns each node.
+// It is created once per process and reused by every query: the per-ghost
+// queues are left empty after each exchange.
+// `distances` is indexed by shard slot. Owned slots are authoritative; a
+// ghost slot caches the best candidate this rank has produced for that
+// remote node, so a candidate that is no better is never sent twice, and
+// each improved ghost is queued at most once per superstep no matter how
+// many edges reach it.
+template <typename Shard>
+class FrontierExchange {
+private:
+    const Shard& shard;
+    const PartitionMap& partition;
+    const NodeTopology& topology;
+    int myRank;
+    int worldSize;
+    vector<double>& distances;
+    vector<vector<int>> queuedNodes;  // Ghost slots per destination rank
+    vector<char> queued;              // Per ghost
+    MessageCounters counters;
+    UpdateAggregator aggregator;      // Asynchronous sends, keyed by ghost index
+    vector<vector<DistanceUpdate>> pipelinedOutgoing;  // In flight during a pipelined exchange
+    PipelinedExchange pipeline;
+    SimdLevel simdLevel;
+    RelaxFilter<typename Shard::Weight> relaxFilter;
+
+    // Apply one received update; returns true if it improved an own node
+    bool apply(int nodeId, double distance, int& slot) {
+        slot = partition.getLocalIndex(nodeId);
+        if (distance < distances[slot]) {
+            distances[slot] = distance;
+            return true;
+        }
+        return false;
+    }
+
+public:
+    // flushUpdates / flushAgeUs bound how long the asynchronous solver may
+    // hold an update back to coalesce it with later ones
+    FrontierExchange(const Shard& graphShard, const PartitionMap& partitionMap, const NodeTopology& nodeTopology,
+                     vector<double>& dist, int rank, int size,
+                     size_t flushUpdates, double flushAgeUs)
+        : shard(graphShard), partition(partitionMap), topology(nodeTopology), myRank(rank), worldSize(size),
+          distances(dist), queuedNodes(size), queued(graphShard.getGhostCount(), 0),
+          aggregator(size, graphShard.getGhostCount(), flushUpdates, flushAgeUs, counters),
+          simdLevel(SimdLevel::Scalar), relaxFilter(selectRelaxFilter<typename Shard::Weight>(simdLevel)) {}
+
+    MessageCounters& getCounters() {
+        return counters;
+    }
+
+    // The reductions of every superstep, flat or per host (NodeTopology)
+    void allreduce(const void* sendBuffer, void* receiveBuffer, int count, MPI_Datatype type, MPI_Op op) const {
+        topology.allreduce(sendBuffer, receiveBuffer, count, type, op);
+    }
+
+    // Make room for ghost slots the shard gained since construction; their
+    // distances start at infinity
+    void growGhosts() {
+        queued.resize(shard.getGhostCount(), 0);
+        aggregator.resizeKeys(shard.getGhostCount());
+        distances.resize(shard.getSlotCount(), INF);
+    }
+
+    bool isOwned(int slot) const {
+        return shard.isOwnedSlot(slot);
+    }
+
+    // Kernel that picks the improving edges of a node (see RelaxKernel.h)
+    void setSimdLevel(SimdLevel level) {
+        simdLevel = level;
+        relaxFilter = selectRelaxFilter<typename Shard::Weight>(level);
+    }
+
+    // Indices (from edgeBegin(u)) of the edges of u in range whose
+    // candidate beats the current distance; kept counts those in range
+    int findImproving(int u, double distU, WeightRange range, int* improving, int& kept) const {
+        int begin = shard.edgeBegin(u);
+        return relaxFilter(shard.getTargets() + begin, shard.getWeights() + begin, shard.edgeEnd(u) - begin,
+                           distU, distances.data(), range, improving, kept);
+    }
+
+    // Current distance of a slot; with Concurrent it is safe to call while
+    // other threads call offer()
+    template <bool Concurrent>
+    double getDistance(int slot) const {
+        if (!Concurrent) {
+            return distances[slot];
+        }
+        double dist;
+        __atomic_load(&distances[slot], &dist, __ATOMIC_RELAXED);
+        return dist;
+    }
+
+    // Offer a candidate distance; returns true if it improved this rank's
+    // view. With Concurrent, several threads may offer at once: the distance
+    // is lowered with a compare-and-swap loop, so concurrent candidates for
+    // the same slot can never overwrite a smaller one, and a ghost is
+    // claimed by whichever thread flips its queued flag first. Claimed
+    // ghosts are handed back with queueClaimed() once the threads are done.
+    template <bool Concurrent>
+    bool offer(int slot, double dist, vector<int>& claimedGhosts) {
+        if (!Concurrent) {
+            if (dist >= distances[slot]) {
+                return false;
+            }
+            distances[slot] = dist;
+        } else {
+            double current = getDistance<true>(slot);
+            do {
+                if (dist >= current) {
+                    return false;
+                }
+            } while (!__atomic_compare_exchange(&distances[slot], &current, &dist, true,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+        }
+        if (!isOwned(slot)) {
+            int ghost = slot - shard.getOwnedCount();
+            char wasQueued;
+            if (Concurrent) {
+                wasQueued = __atomic_exchange_n(&queued[ghost], 1, __ATOMIC_RELAXED);
+            } else {
+                wasQueued = queued[ghost];
+                queued[ghost] = 1;
+            }
+            if (!wasQueued) {
+                claimedGhosts.push_back(slot);
+            }
+        }
+        return true;
+    }
+
+    // Queue ghosts claimed by offer() for the next exchange
+    void queueClaimed(const vector<int>& claimedGhosts) {
+        for (int slot : claimedGhosts) {
+            queuedNodes[shard.getGhostOwner(slot)].push_back(slot);
+        }
+    }
+
+    // Ship queued candidates to their owners and apply what arrives.
+    // onImproved(u) is called for every own node a received update improved.
+    template <typename Callback>
+    void exchange(Callback onImproved) {
+        vector<vector<DistanceUpdate>> outgoing(worldSize);
+        for (int r = 0; r < worldSize; r++) {
+            outgoing[r].reserve(queuedNodes[r].size());
+            for (int slot : queuedNodes[r]) {
+                outgoing[r].emplace_back(shard.getGlobalId(slot), distances[slot]);
+                queued[slot - shard.getOwnedCount()] = 0;
+            }
+            queuedNodes[r].clear();
+        }
+
+        int slot;
+        for (const DistanceUpdate& update : MPIWrapper::exchangeDistanceUpdates(outgoing, counters)) {
+            if (apply(update.nodeId, update.distance, slot)) {
+                onImproved(slot);
+            }
+        }
+    }
+
+    // Non-blocking exchange(): ship the queued candidates and return at
+    // once; flag is OR-reduced over all ranks along with the counts.
+    // Poll with progressPipelined() while working, then finishPipelined()
+    // applies what arrived like exchange() and returns the reduced flag.
+    void startPipelined(int flag) {
+        pipelinedOutgoing.resize(worldSize);
+        for (int r = 0; r < worldSize; r++) {
+            pipelinedOutgoing[r].clear();
+            for (int slot : queuedNodes[r]) {
+                pipelinedOutgoing[r].emplace_back(shard.getGlobalId(slot), distances[slot]);
+                queued[slot - shard.getOwnedCount()] = 0;
+            }
+            queuedNodes[r].clear();
+        }
+        pipeline.start(pipelinedOutgoing, flag, counters);
+    }
+
+    bool progressPipelined() {
+        return pipeline.progress();
+    }
+
+    template <typename Callback>
+    bool finishPipelined(Callback onImproved) {
+        int slot;
+        for (const DistanceUpdate& update : pipeline.finish()) {
+            if (apply(update.nodeId, update.distance, slot)) {
+                onImproved(slot);
+            }
+        }
+        return pipeline.anyRankFlagged();
+    }
+
+    // Asynchronous counterpart of exchange(): move queued candidates into
+    // the coalescing buffers and post those that are full or old enough.
+    // With flush, post everything. Returns the number of messages posted.
+    int post(bool flush) {
+        int posted = 0;
+        int ownedCount = shard.getOwnedCount();
+        for (int r = 0; r < worldSize; r++) {
+            for (int slot : queuedNodes[r]) {
+                posted += aggregator.add(r, slot - ownedCount, shard.getGlobalId(slot), distances[slot]);
+                queued[slot - ownedCount] = 0;
+            }
+            queuedNodes[r].clear();
+        }
+        return posted + (flush ? aggregator.flushAll() : aggregator.flushExpired());
+    }
+
+    // Block until every posted update has left this rank
+    void completeSends() {
+        aggregator.waitAll();
+    }
+
+    // Send a candidate for a node this rank has no slot for (an edge of a
+    // stolen node); it is not coalesced. Returns the number of messages posted.
+    int route(int owner, int nodeId, double distance) {
+        counters.updatesOffered++;
+        return aggregator.add(owner, -1, nodeId, distance);
+    }
+
+    // Apply every update message that has already arrived. onImproved(u)
+    // is called for every own node an update improved. Returns the number
+    // of messages received.
+    template <typename Callback>
+    int receiveAvailable(Callback onImproved) {
+        int slot;
+        return aggregator.receiveAvailable([&](int nodeId, double distance) {
+            if (apply(nodeId, distance, slot)) {
+                onImproved(slot);
+            }
+        });
+    }
+};
+
+// Safra's termination detection for the asynchronous solver.
+// Every rank counts update messages sent minus received and turns black
+// when it receives one. A token travels the ring 0 -> 1 -> ... -> 0, and
+// each rank forwards it only while passive (nothing to relax), adding its
+// count and colour. Rank 0 declares termination when the token comes back
+// white with a total count of zero and rank 0 itself stayed white: then no
+// rank was reactivated during the round and no message is still in flight.
+// Both the token and the final announcement use MPITags::TERMINATE.
+class TerminationDetector {
+private:
+    struct Token {
+        long long messageCount;
+        int black;
+        int done;  // Termination announcement rather than a token
+    };
+
+    int myRank;
+    int worldSize;
+    long long messageBalance;  // Messages sent minus received by this rank
+    bool black;
+    bool holdingToken;
+    bool roundStarted;         // Rank 0: the token is on its way round
+    Token token;
+
+    void send(int destination, const Token& message) {
+        MPI_Send(&message, sizeof(Token), MPI_BYTE, destination, MPITags::TERMINATE, MPI_COMM_WORLD);
+    }
+
+public:
+    TerminationDetector(int rank, int size) : myRank(rank), worldSize(size) {
+        reset();
+    }
+
+    // Start detection for a new query
+    void reset() {
+        messageBalance = 0;
+        black = false;
+        holdingToken = (myRank == 0);
+        roundStarted = false;
+        token = Token{0, 0, 0};
+    }
+
+    void onSent(int messages) {
+        messageBalance += messages;
+    }
+
+    void onReceived(int messages) {
+        if (messages > 0) {
+            messageBalance -= messages;
+            black = true;
+        }
+    }
+
+    // Take the token if it has arrived; returns true on the termination
+    // announcement
+    bool receive() {
+        int flag;
+        MPI_Status status;
+        MPI_Iprobe(MPI_ANY_SOURCE, MPITags::TERMINATE, MPI_COMM_WORLD, &flag, &status);
+        if (!flag) {
+            return false;
+        }
+        MPI_Recv(&token, sizeof(Token), MPI_BYTE, status.MPI_SOURCE,
+                 MPITags::TERMINATE, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        holdingToken = true;
+        return token.done != 0;
+    }
+
+    // Called whenever this rank is passive. Passes the token on if it is
+    // here; returns true on rank 0 once global termination is detected.
+    bool passive(SolverStats& stats) {
+        if (worldSize == 1) {
+            return true;
+        }
+        if (!holdingToken) {
+            return false;
+        }
+        holdingToken = false;
+
+        if (myRank == 0) {
+            if (roundStarted && !token.black && !black && token.messageCount + messageBalance == 0) {
+                for (int r = 1; r < worldSize; r++) {
+                    send(r, Token{0, 0, 1});
+                }
+                return true;
+            }
+            // Start a (new) round
+            stats.tokenRounds++;
+            roundStarted = true;
+            black = false;
+            send(1, Token{0, 0, 0});
+        } else {
+            token.messageCount += messageBalance;
+            token.black = token.black || black;
+            black = false;
+            send((myRank + 1) % worldSize, token);
+        }
+        return false;
+    }
+};
+
+// Work stealing for the asynchronous solver.
+// A rank that runs out of work asks the other ranks in turn
+// (WORK_STEAL_REQUEST) for part of their frontier. A victim holding more
+// queued nodes than it relaxes in one round pops the closest ones and
+// ships each with its adjacency (WORK_STEAL_RESPONSE); the thief relaxes
+// those edges as if the nodes were its own, keeping improvements of its own
+// nodes and routing the rest to their owners. A response is a run of
+// DistanceUpdate records: per stolen node a header {edge count, distance}
+// followed by one {target global ID, weight} record per edge.
+//
+// A response that carries work is a basic message for termination
+// detection (counted, and the thief turns black); requests and empty
+// replies never activate anyone and are not counted. A rank does not report
+// itself passive while one of its requests is unanswered, and after a full
+// circle of refusals it stops asking until it has work again, so an idle
+// rank never keeps the token from going round.
+template <typename Shard>
+class WorkStealer {
+private:
+    struct PendingResponse {
+        vector<DistanceUpdate> records;
+        MPI_Request request;
+    };
+
+    const Shard& shard;
+    int myRank;
+    int worldSize;
+    int roundSize;
+    int nextVictim;
+    int refusals;
+    bool requestOutstanding;
+    list<PendingResponse> pending;  // Responses still being sent
+    vector<DistanceUpdate> incoming;
+
+    void reap() {
+        for (auto it = pending.begin(); it != pending.end();) {
+            int done;
+            MPI_Test(&it->request, &done, MPI_STATUS_IGNORE);
+            it = done ? pending.erase(it) : next(it);
+        }
+    }
+
+public:
+    WorkStealer(const Shard& graphShard, int rank, int size, int nodesPerRound)
+        : shard(graphShard), myRank(rank), worldSize(size), roundSize(nodesPerRound),
+          nextVictim((rank + 1) % size) {
+        reset();
+    }
+
+    // Start a new query
+    void reset() {
+        refusals = 0;
+        requestOutstanding = false;
+    }
+
+    // This rank has work again, so it may ask again once it runs out
+    void onActive() {
+        refusals = 0;
+    }
+
+    // Answer pending requests from the frontier in `heap`. Returns the
+    // number of responses that carry work.
+    int serve(DaryHeapQueue<4>& heap, const vector<double>& distances, SolverStats& stats) {
+        int given = 0;
+        while (true) {
+            int flag;
+            MPI_Status status;
+            MPI_Iprobe(MPI_ANY_SOURCE, MPITags::WORK_STEAL_REQUEST, MPI_COMM_WORLD, &flag, &status);
+            if (!flag) {
+                break;
+            }
+            int thief = status.MPI_SOURCE;
+            MPI_Recv(nullptr, 0, MPI_INT, thief, MPITags::WORK_STEAL_REQUEST,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+            int nodeCount = 0;
+            if ((int)heap.size() > roundSize) {
+                nodeCount = min((int)heap.size() / 2, roundSize);
+            }
+            if (nodeCount == 0) {
+                MPI_Send(nullptr, 0, MPIWrapper::distanceUpdateType(), thief,
+                         MPITags::WORK_STEAL_RESPONSE, MPI_COMM_WORLD);
+                continue;
+            }
+
+            pending.emplace_back();
+            vector<DistanceUpdate>& records = pending.back().records;
+            for (int i = 0; i < nodeCount; i++) {
+                int u = heap.pop();
+                records.emplace_back(shard.edgeEnd(u) - shard.edgeBegin(u), distances[u]);
+                for (int e = shard.edgeBegin(u); e < shard.edgeEnd(u); e++) {
+                    records.emplace_back(shard.getGlobalId(shard.getTarget(e)), shard.getWeight(e));
+                }
+            }
+            MPI_Isend(records.data(), records.size(), MPIWrapper::distanceUpdateType(), thief,
+                      MPITags::WORK_STEAL_RESPONSE, MPI_COMM_WORLD, &pending.back().request);
+            stats.verticesGiven += nodeCount;
+            given++;
+        }
+        reap();
+        return given;
+    }
+
+    // Take the reply to this rank's request if it has arrived.
+    // relaxEdge(targetId, candidate) is called for every stolen edge.
+    // Returns true if the reply carried work.
+    template <typename Callback>
+    bool receive(Callback relaxEdge, SolverStats& stats) {
+        if (!requestOutstanding) {
+            return false;
+        }
+        int flag;
+        MPI_Status status;
+        MPI_Iprobe(MPI_ANY_SOURCE, MPITags::WORK_STEAL_RESPONSE, MPI_COMM_WORLD, &flag, &status);
+        if (!flag) {
+            return false;
+        }
+        int count;
+        MPI_Get_count(&status, MPIWrapper::distanceUpdateType(), &count);
+        incoming.resize(count);
+        MPI_Recv(incoming.data(), count, MPIWrapper::distanceUpdateType(), status.MPI_SOURCE,
+                 MPITags::WORK_STEAL_RESPONSE, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        requestOutstanding = false;
+
+        if (count == 0) {
+            refusals++;
+            return false;
+        }
+        refusals = 0;
+        for (int i = 0; i < count;) {
+            int edgeCount = incoming[i].nodeId;
+            double distance = incoming[i].distance;
+            i++;
+            for (int end = i + edgeCount; i < end; i++) {
+                relaxEdge(incoming[i].nodeId, distance + incoming[i].distance);
+            }
+            stats.verticesStolen++;
+        }
+        return true;
+    }
+
+    // Ask the next rank for work. Returns true while a request is waiting
+    // for its reply, false once every other rank has refused.
+    bool request(SolverStats& stats) {
+        if (requestOutstanding) {
+            return true;
+        }
+        if (worldSize == 1 || refusals >= worldSize - 1) {
+            return false;
+        }
+        MPI_Send(nullptr, 0, MPI_INT, nextVictim, MPITags::WORK_STEAL_REQUEST, MPI_COMM_WORLD);
+        nextVictim = (nextVictim + 1) % worldSize;
+        if (nextVictim == myRank) {
+            nextVictim = (nextVictim + 1) % worldSize;
+        }
+        requestOutstanding = true;
+        stats.stealRequests++;
+        return true;
+    }
+
+    // Block until every response has left this rank
+    void completeSends() {
+        for (PendingResponse& response : pending) {
+            MPI_Wait(&response.request, MPI_STATUS_IGNORE);
+        }
+        pending.clear();
+    }
+};
+
+// What one thread produced during a threaded relaxation pass
+struct RelaxBuffer {
+    vector<int> improvedOwned;  // Own slots whose distance dropped
+    vector<int> claimedGhosts;  // Ghost slots queued by this thread
+    long long edgesRelaxed = 0;
+    long long localUpdates = 0;
+    long long ghostUpdates = 0; // Improvements of remote nodes, before coalescing
+    vector<int> improving;      // Scratch for the relaxation kernel
+};
+
+// Relax the edges of one node with weights in `range`. The SIMD kernel
+// picks the edges whose candidate improves on the distance read before
+// the scan; each is then offered, which re-checks it, so with Concurrent
+// another thread lowering a target in between is harmless.
+template <bool Concurrent, typename Shard>
+inline void relaxNode(
+    const Shard& shard,
+    FrontierExchange<Shard>& exchange,
+    int u,
+    RelaxBuffer& buffer,
+    WeightRange range
+) {
+    double distU = exchange.template getDistance<Concurrent>(u);
+
+    int begin = shard.edgeBegin(u);
+    if ((int)buffer.improving.size() < shard.edgeEnd(u) - begin) {
+        buffer.improving.resize(shard.edgeEnd(u) - begin);
+    }
+    int kept;
+    int found = exchange.findImproving(u, distU, range, buffer.improving.data(), kept);
+    buffer.edgesRelaxed += kept;
+
+    for (int k = 0; k < found; k++) {
+        int e = begin + buffer.improving[k];
+        int v = shard.getTarget(e);
+        double w = shard.getWeight(e);
+        if (exchange.template offer<Concurrent>(v, distU + w, buffer.claimedGhosts)) {
+            buffer.localUpdates++;
+            if (exchange.isOwned(v)) {
+                buffer.improvedOwned.push_back(v);
+            } else {
+                buffer.ghostUpdates++;
+            }
+        }
+    }
+}
+
+// Relax the edges of `nodes` with weights in `range` on every thread of
+// the rank. Threads share the shard and the distance array (improvements
+// are atomic mins) and collect their results in private buffers, which are
+// merged serially afterwards: onOwnImproved(u) runs once per recorded
+// improvement on the calling thread, so callers need no locking. With one
+// thread the plain, non-atomic path is used.
+template <typename Shard, typename Callback>
+void relaxInParallel(
+    const Shard& shard,
+    FrontierExchange<Shard>& exchange,
+    const vector<int>& nodes,
+    vector<RelaxBuffer>& buffers,
+    SolverStats& stats,
+    SolverTrace& trace,
+    WeightRange range,
+    Callback onOwnImproved
+) {
+    auto start = SolverTrace::now();
+    int threadCount = buffers.size();
+    int nodeCount = nodes.size();
+    for (RelaxBuffer& buffer : buffers) {
+        buffer.improvedOwned.clear();
+        buffer.claimedGhosts.clear();
+        buffer.edgesRelaxed = 0;
+        buffer.localUpdates = 0;
+        buffer.ghostUpdates = 0;
+    }
+
+    if (threadCount == 1) {
+        for (int u : nodes) {
+            relaxNode<false>(shard, exchange, u, buffers[0], range);
+        }
+    } else {
+        #pragma omp parallel num_threads(threadCount)
+        {
+#ifdef _OPENMP
+            RelaxBuffer& buffer = buffers[omp_get_thread_num()];
+#else
+            RelaxBuffer& buffer = buffers[0];
+#endif
+            #pragma omp for schedule(dynamic, 64)
+            for (int i = 0; i < nodeCount; i++) {
+                relaxNode<true>(shard, exchange, nodes[i], buffer, range);
+            }
+        }
+    }
+
+    for (const RelaxBuffer& buffer : buffers) {
+        stats.edgesRelaxed += buffer.edgesRelaxed;
+        stats.localUpdates += buffer.localUpdates;
+        exchange.getCounters().updatesOffered += buffer.ghostUpdates;
+        exchange.queueClaimed(buffer.claimedGhosts);
+        for (int v : buffer.improvedOwned) {
+            onOwnImproved(v);
+        }
+    }
+    trace.record(TracePhase::Compute, start, stats.iterations, nodeCount);
+}
+
+// FrontierExchange::exchange() as an Exchange event carrying the bytes sent
+template <typename Shard, typename Callback>
+void tracedExchange(FrontierExchange<Shard>& exchange, SolverTrace& trace, const SolverStats& stats,
+                    Callback onImproved) {
+    auto begin = SolverTrace::now();
+    long long bytesBefore = exchange.getCounters().bytesSent;
+    exchange.exchange(onImproved);
+    trace.record(TracePhase::Exchange, begin, stats.iterations, 0,
+                 exchange.getCounters().bytesSent - bytesBefore);
+}
+
+// Periodic checkpoints of the superstep solvers (see Checkpoint.h). A
+// solver calls due() wherever no update is in flight, and save() with the
+// own nodes it still has to relax when it is; a checkpoint is due every
+// `interval` supersteps. Every rank runs the same supersteps, so all of
+// them save at the same points. The distances are copied and written in
+// the background.
+class SolverCheckpoint {
+private:
+    CheckpointWriter& writer;
+    const vector<double>& distances;
+    int ownedCount;
+    int interval;
+    int nextIteration;
+    uint64_t runHash;
+    uint64_t partitionHash;
+    int myRank;
+    int worldSize;
+    CheckpointState state;  // Reuses the buffers of the checkpoint before last
+
+public:
+    int query = 0;           // Batch position of the query being solved
+    uint64_t queryHash = 0;  // Hash of the batch's queries up to it
+
+    SolverCheckpoint(CheckpointWriter& checkpointWriter, const vector<double>& dist, int owned,
+                     int supersteps, uint64_t runKey, uint64_t partitionKey, int rank, int size)
+        : writer(checkpointWriter), distances(dist), ownedCount(owned), interval(supersteps),
+          nextIteration(supersteps), runHash(runKey), partitionHash(partitionKey), myRank(rank), worldSize(size) {}
+
+    bool due(const SolverStats& stats) const {
+        return stats.iterations >= nextIteration;
+    }
+
+    void save(const SolverStats& stats, const vector<int>& frontier) {
+        state.runHash = runHash;
+        state.partitionHash = partitionHash;
+        state.rank = myRank;
+        state.worldSize = worldSize;
+        state.query = query;
+        state.queryHash = queryHash;
+        state.iterations = stats.iterations;
+        state.buckets = stats.buckets;
+        state.edgesRelaxed = stats.edgesRelaxed;
+        state.localUpdates = stats.localUpdates;
+        state.distances.assign(distances.begin(), distances.begin() + ownedCount);
+        state.frontier = frontier;
+        writer.save(state);
+        nextIteration = stats.iterations + interval;
+    }
+
+    // Continue from a loaded checkpoint: its counters and its schedule
+    void resume(const CheckpointState& loaded, SolverStats& stats) {
+        query = loaded.query;
+        stats.iterations = loaded.iterations;
+        stats.buckets = loaded.buckets;
+        stats.edgesRelaxed = loaded.edgesRelaxed;
+        stats.localUpdates = loaded.localUpdates;
+        nextIteration = loaded.iterations + interval;
+    }
+};
+
+// Frontier-based Bellman-Ford BSP: each superstep, own nodes whose distance
+// improved in the previous superstep relax all of their edges, then only
+// the improved (nodeId, distance) pairs are exchanged with their owners.
+// The first superstep relaxes every reached own node, or only `seeds` when
+// given (repairing distances after edge updates, see repairDistances, or
+// resuming from a checkpoint).
+template <typename Shard>
+void runBellmanFord(
+    const Shard& shard,
+    FrontierExchange<Shard>& exchange,
+    vector<double>& distances,
+    vector<RelaxBuffer>& buffers,
+    SolverStats& stats,
+    SolverTrace& trace,
+    const vector<int>* seeds = nullptr,
+    SolverCheckpoint* checkpoint = nullptr
+) {
+    int ownedCount = shard.getOwnedCount();
+
+    vector<int> frontier, nextFrontier;
+    vector<char> active(ownedCount, 0);
+    auto activate = [&](int u) {
+        if (!active[u]) {
+            active[u] = 1;
+            nextFrontier.push_back(u);
+        }
+    };
+
+    if (seeds) {
+        for (int u : *seeds) {
+            activate(u);
+        }
+    } else {
+        for (int u = 0; u < ownedCount; u++) {
+            if (distances[u] != INF) {
+                activate(u);
+            }
+        }
+    }
+    frontier.swap(nextFrontier);
+
+    int maxIterations = shard.getGlobalNodeCount();
+
+    for (int iteration = 0; iteration < maxIterations; iteration++) {
+        stats.iterations++;
+
+        // Each process relaxes edges from its active nodes
+        for (int u : frontier) {
+            active[u] = 0;
+        }
+        relaxInParallel(shard, exchange, frontier, buffers, stats, trace,
+                        WeightRange::all(), activate);
+
+        // Send improved distances to their owners
+        tracedExchange(exchange, trace, stats, activate);
+        frontier.clear();
+        frontier.swap(nextFrontier);
+
+        // Check global convergence
+        auto checkStart = SolverTrace::now();
+        int localFlag = frontier.empty() ? 0 : 1;
+        int globalFlag = 0;
+        exchange.allreduce(&localFlag, &globalFlag, 1, MPI_INT, MPI_MAX);
+        trace.record(TracePhase::Convergence, checkStart, stats.iterations);
+
+        if (globalFlag == 0) {
+            break;
+        }
+        if (checkpoint && checkpoint->due(stats)) {
+            checkpoint->save(stats, frontier);
+        }
+    }
+}
+
+// Interior nodes the pipelined solver relaxes between polls of the exchange
+const int PIPELINE_CHUNK_NODES_PER_THREAD = 256;
+
+// Bellman-Ford BSP with the exchange overlapped by computation. Each
+// superstep relaxes the boundary nodes of the frontier first (the only
+// ones whose edges reach other ranks), starts the exchange of their
+// updates without blocking, and relaxes the interior nodes in chunks while
+// it is in flight, polling it in between. Whether a rank had a frontier
+// travels with the exchange counts, so there is no separate convergence
+// reduction: once no rank had one, nothing was sent and the solver stops.
+// That costs one trailing superstep whose exchange carries no updates.
+template <typename Shard>
+void runPipelinedBellmanFord(
+    const Shard& shard,
+    FrontierExchange<Shard>& exchange,
+    vector<double>& distances,
+    vector<RelaxBuffer>& buffers,
+    SolverStats& stats,
+    SolverTrace& trace,
+    const vector<int>* seeds = nullptr,
+    SolverCheckpoint* checkpoint = nullptr
+) {
+    int ownedCount = shard.getOwnedCount();
+
+    vector<int> frontier, nextFrontier, boundary, interior, chunk;
+    vector<char> active(ownedCount, 0);
+    auto activate = [&](int u) {
+        if (!active[u]) {
+            active[u] = 1;
+            nextFrontier.push_back(u);
+        }
+    };
+
+    if (seeds) {
+        for (int u : *seeds) {
+            activate(u);
+        }
+    } else {
+        for (int u = 0; u < ownedCount; u++) {
+            if (distances[u] != INF) {
+                activate(u);
+            }
+        }
+    }
+    frontier.swap(nextFrontier);
+
+    int chunkSize = PIPELINE_CHUNK_NODES_PER_THREAD * buffers.size();
+    int maxIterations = shard.getGlobalNodeCount() + 1;
+
+    for (int iteration = 0; iteration < maxIterations; iteration++) {
+        stats.iterations++;
+
+        boundary.clear();
+        interior.clear();
+        for (int u : frontier) {
+            active[u] = 0;
+            (shard.isBoundarySlot(u) ? boundary : interior).push_back(u);
+        }
+        relaxInParallel(shard, exchange, boundary, buffers, stats, trace, WeightRange::all(), activate);
+
+        auto begin = SolverTrace::now();
+        long long bytesBefore = exchange.getCounters().bytesSent;
+        exchange.startPipelined(frontier.empty() ? 0 : 1);
+        trace.accumulate(TracePhase::Exchange, begin);
+
+        bool arrived = false;
+        for (size_t i = 0; i < interior.size(); i += chunkSize) {
+            chunk.assign(interior.begin() + i, interior.begin() + min(interior.size(), i + chunkSize));
+            relaxInParallel(shard, exchange, chunk, buffers, stats, trace, WeightRange::all(), activate);
+            if (!arrived) {
+                begin = SolverTrace::now();
+                arrived = exchange.progressPipelined();
+                trace.accumulate(TracePhase::Exchange, begin);
+            }
+        }
+
+        begin = SolverTrace::now();
+        bool anyFrontier = exchange.finishPipelined(activate);
+        trace.record(TracePhase::Exchange, begin, stats.iterations, 0,
+                     exchange.getCounters().bytesSent - bytesBefore);
+        frontier.clear();
+        frontier.swap(nextFrontier);
+
+        if (!anyFrontier) {
+            break;
+        }
+        if (checkpoint && checkpoint->due(stats)) {
+            checkpoint->save(stats, frontier);
+        }
+    }
+}
+
+// Default bucket width: roughly the largest weight divided by the average
+// degree (Meyer & Sanders), never narrower than the lightest edge so each
+// bucket can settle at least one hop. For the generator's default [1, 100]
+// weights and ~7 edges per node this gives a width of about 14. Every rank
+// only sees its own shard, so the weight range is reduced across ranks.
+template <typename Shard>
+double computeAutoDelta(const Shard& shard) {
+    double localMin = INF, localMax = 0.0;
+    for (int e = 0; e < shard.getEdgeCount(); e++) {
+        localMin = min(localMin, (double)shard.getWeight(e));
+        localMax = max(localMax, (double)shard.getWeight(e));
+    }
+    long long localEdges = shard.getEdgeCount(), edgeCount = 0;
+
+    double minWeight, maxWeight;
+    MPI_Allreduce(&localMin, &minWeight, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+    MPI_Allreduce(&localMax, &maxWeight, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Allreduce(&localEdges, &edgeCount, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    if (edgeCount == 0) {
+        return 1.0;
+    }
+
+    double avgDegree = (double)edgeCount / shard.getGlobalNodeCount();
+
+    double delta = maxWeight / max(avgDegree, 1.0);
+    delta = max(delta, minWeight);
+    return delta > 0.0 ? delta : 1.0;
+}
+
+// Delta-stepping: own nodes are kept in buckets of width delta. All ranks
+// work on the globally smallest non-empty bucket; light edges (w <= delta)
+// are relaxed repeatedly until the bucket stops refilling, then the heavy
+// edges of every node settled in that bucket are relaxed exactly once.
+// With `seeds`, only those own nodes start in the buckets. Checkpoints are
+// taken between buckets: the nodes still to relax are then exactly the
+// reached ones in the current bucket or beyond.
+template <typename Shard>
+void runDeltaStepping(
+    const Shard& shard,
+    FrontierExchange<Shard>& exchange,
+    vector<double>& distances,
+    double delta,
+    vector<RelaxBuffer>& buffers,
+    SolverStats& stats,
+    SolverTrace& trace,
+    const vector<int>* seeds = nullptr,
+    SolverCheckpoint* checkpoint = nullptr
+) {
+    int ownedCount = shard.getOwnedCount();
+
+    // Bucket bookkeeping only exists for owned slots
+    vector<vector<int>> buckets;
+    vector<double> placedDist(ownedCount, INF);   // Distance at last bucket insertion
+    vector<double> relaxedDist(ownedCount, INF);  // Distance at last light relaxation
+    vector<char> inSettled(ownedCount, 0);
+
+    auto bucketIndex = [delta](double dist) {
+        return (size_t)floor(dist / delta);
+    };
+
+    // Place an own node whose distance improved into its bucket
+    auto placeInBucket = [&](int u) {
+        if (distances[u] < placedDist[u]) {
+            placedDist[u] = distances[u];
+            size_t b = bucketIndex(distances[u]);
+            if (b >= buckets.size()) {
+                buckets.resize(b + 1);
+            }
+            buckets[b].push_back(u);
+        }
+    };
+
+    // A bucket entry is live if the node still belongs to the bucket and its
+    // light edges have not been relaxed at this distance yet
+    auto isLive = [&](int u, size_t b) {
+        return bucketIndex(distances[u]) == b && distances[u] < relaxedDist[u];
+    };
+
+    // Relax edges of the given nodes in one weight class
+    WeightRange light = WeightRange::upTo(delta);
+    WeightRange heavy = WeightRange::above(delta);
+
+    if (seeds) {
+        for (int u : *seeds) {
+            placeInBucket(u);
+        }
+    } else {
+        for (int u = 0; u < ownedCount; u++) {
+            if (distances[u] != INF) {
+                placeInBucket(u);
+            }
+        }
+    }
+    size_t current = 0;
+
+    while (true) {
+        // Find the smallest non-empty bucket across all ranks
+        auto reduceStart = SolverTrace::now();
+        long long localMin = numeric_limits<long long>::max();
+        for (size_t b = current; b < buckets.size(); b++) {
+            vector<int>& bucket = buckets[b];
+            bucket.erase(remove_if(bucket.begin(), bucket.end(),
+                                   [&](int u) { return !isLive(u, b); }),
+                         bucket.end());
+            if (!bucket.empty()) {
+                localMin = b;
+                break;
+            }
+        }
+        long long globalMin;
+        exchange.allreduce(&localMin, &globalMin, 1, MPI_LONG_LONG, MPI_MIN);
+        trace.record(TracePhase::Allreduce, reduceStart, stats.iterations);
+        if (globalMin == numeric_limits<long long>::max()) {
+            break;
+        }
+        current = (size_t)globalMin;
+        stats.buckets++;
+
+        vector<int> settled;
+
+        // Light phases: relax light edges until the bucket is empty everywhere
+        while (true) {
+            stats.iterations++;
+            vector<int> frontier;
+            if (current < buckets.size()) {
+                frontier.swap(buckets[current]);
+            }
+
+            vector<int> live;
+            for (int u : frontier) {
+                if (!isLive(u, current)) {
+                    continue;
+                }
+                relaxedDist[u] = distances[u];
+                if (!inSettled[u]) {
+                    inSettled[u] = 1;
+                    settled.push_back(u);
+                }
+                live.push_back(u);
+            }
+            relaxInParallel(shard, exchange, live, buffers, stats, trace, light, placeInBucket);
+
+            tracedExchange(exchange, trace, stats, placeInBucket);
+
+            auto checkStart = SolverTrace::now();
+            int localFlag = 0;
+            if (current < buckets.size()) {
+                for (int u : buckets[current]) {
+                    if (isLive(u, current)) {
+                        localFlag = 1;
+                        break;
+                    }
+                }
+            }
+            int globalFlag = 0;
+            exchange.allreduce(&localFlag, &globalFlag, 1, MPI_INT, MPI_MAX);
+            trace.record(TracePhase::Convergence, checkStart, stats.iterations);
+            if (globalFlag == 0) {
+                break;
+            }
+        }
+
+        // Heavy phase: settled distances are final, relax heavy edges once
+        stats.iterations++;
+        for (int u : settled) {
+            inSettled[u] = 0;
+        }
+        relaxInParallel(shard, exchange, settled, buffers, stats, trace, heavy, placeInBucket);
+        tracedExchange(exchange, trace, stats, placeInBucket);
+        current++;
+
+        if (checkpoint && checkpoint->due(stats)) {
+            vector<int> pending;
+            for (int u = 0; u < ownedCount; u++) {
+                if (distances[u] != INF && bucketIndex(distances[u]) >= current) {
+                    pending.push_back(u);
+                }
+            }
+            checkpoint->save(stats, pending);
+        }
+    }
+}
+
+// Nodes the asynchronous solver relaxes per round between polls for
+// incoming messages
+const int ASYNC_ROUND_NODES_PER_THREAD = 64;
+
+// Asynchronous label-correcting search without supersteps. Each rank keeps
+// its improved own nodes in an indexed heap, relaxes them in small rounds
+// (smallest distance first) and posts ghost improvements to their owners
+// straight away; updates from other ranks are applied as they arrive.
+// There is no collective call until TerminationDetector has established
+// that every rank is passive and no update is in flight, so a slow rank
+// only delays the ranks that are waiting for its updates. With a
+// WorkStealer, idle ranks take part of the frontier of busy ones. With
+// `seeds`, only those own nodes start in the heap.
+template <typename Shard>
+void runAsync(
+    const Shard& shard,
+    const PartitionMap& partition,
+    int myRank,
+    FrontierExchange<Shard>& exchange,
+    vector<double>& distances,
+    TerminationDetector& termination,
+    WorkStealer<Shard>* stealer,
+    vector<RelaxBuffer>& buffers,
+    SolverStats& stats,
+    SolverTrace& trace,
+    const vector<int>* seeds = nullptr
+) {
+    int ownedCount = shard.getOwnedCount();
+    int roundSize = ASYNC_ROUND_NODES_PER_THREAD * buffers.size();
+
+    DaryHeapQueue<4> heap;
+    heap.init(ownedCount);
+    auto activate = [&](int u) {
+        heap.push(u, distances[u]);
+    };
+    if (seeds) {
+        for (int u : *seeds) {
+            activate(u);
+        }
+    } else {
+        for (int u = 0; u < ownedCount; u++) {
+            if (distances[u] != INF) {
+                activate(u);
+            }
+        }
+    }
+    termination.reset();
+    if (stealer) {
+        stealer->reset();
+    }
+
+    // Edges of stolen nodes: own targets are relaxed here, the rest is
+    // routed to the owner
+    auto relaxStolenEdge = [&](int nodeId, double candidate) {
+        stats.edgesRelaxed++;
+        int owner = partition.getOwner(nodeId);
+        if (owner != myRank) {
+            termination.onSent(exchange.route(owner, nodeId, candidate));
+            return;
+        }
+        int u = partition.getLocalIndex(nodeId);
+        if (candidate < distances[u]) {
+            distances[u] = candidate;
+            stats.localUpdates++;
+            activate(u);
+        }
+    };
+
+    // Update traffic: the timeline only shows polls that moved messages
+    auto traceExchange = [&](SolverTrace::Clock::time_point begin, int messages, long long bytesBefore) {
+        if (messages > 0) {
+            trace.record(TracePhase::Exchange, begin, stats.iterations, 0,
+                         exchange.getCounters().bytesSent - bytesBefore);
+        } else {
+            trace.accumulate(TracePhase::Exchange, begin);
+        }
+    };
+
+    vector<int> round;
+    while (true) {
+        auto begin = SolverTrace::now();
+        int received = exchange.receiveAvailable(activate);
+        termination.onReceived(received);
+        traceExchange(begin, received, exchange.getCounters().bytesSent);
+
+        begin = SolverTrace::now();
+        bool done = termination.receive();
+        trace.accumulate(TracePhase::Convergence, begin);
+        if (done) {
+            break;
+        }
+        if (stealer) {
+            begin = SolverTrace::now();
+            int given = stealer->serve(heap, distances, stats);
+            termination.onSent(given);
+            traceExchange(begin, given, exchange.getCounters().bytesSent);
+
+            begin = SolverTrace::now();
+            long long stolenBefore = stats.verticesStolen;
+            if (stealer->receive(relaxStolenEdge, stats)) {
+                termination.onReceived(1);
+                termination.onSent(exchange.post(false));
+                trace.record(TracePhase::Compute, begin, stats.iterations,
+                             stats.verticesStolen - stolenBefore);
+            }
+        }
+
+        if (!heap.empty()) {
+            if (stealer) {
+                stealer->onActive();
+            }
+            stats.iterations++;
+            round.clear();
+            while (!heap.empty() && (int)round.size() < roundSize) {
+                round.push_back(heap.pop());
+            }
+            relaxInParallel(shard, exchange, round, buffers, stats, trace,
+                            WeightRange::all(), activate);
+
+            begin = SolverTrace::now();
+            long long bytesBefore = exchange.getCounters().bytesSent;
+            int posted = exchange.post(false);
+            termination.onSent(posted);
+            traceExchange(begin, posted, bytesBefore);
+            continue;
+        }
+
+        // Going passive: nothing may stay buffered, or termination could
+        // be declared while this rank still holds updates
+        begin = SolverTrace::now();
+        long long bytesBefore = exchange.getCounters().bytesSent;
+        int posted = exchange.post(true);
+        termination.onSent(posted);
+        traceExchange(begin, posted, bytesBefore);
+
+        begin = SolverTrace::now();
+        bool waitingForWork = stealer && stealer->request(stats);
+        bool terminated = !waitingForWork && termination.passive(stats);
+        trace.record(TracePhase::Convergence, begin, stats.iterations);
+        if (terminated) {
+            break;
+        }
+        // Nothing to relax: sleep until an update, a steal message or the
+        // token arrives
+        begin = SolverTrace::now();
+        MPI_Status status;
+        MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+        trace.record(TracePhase::Wait, begin, stats.iterations);
+    }
+
+    // Every update has been received, so the remaining sends are done
+    exchange.completeSends();
+    if (stealer) {
+        stealer->completeSends();
+    }
+}
+
+// Build node ownership for the chosen scheme. Graph-aware schemes need the
+// full graph, so rank 0 computes (or reads) the owner table once and
+// broadcasts it to the host leaders; each host keeps one copy of the table
+// in shared memory, and every rank then loads only its shard as usual.
+PartitionMap buildPartitionMap(
+    const string& schemeName,
+    const string& partitionFile,
+    const string& graphFile,
+    int nodeCount,
+    int rank,
+    int size,
+    const NodeTopology& topology
+) {
+    if (partitionFile.empty() && schemeName == "roundrobin") {
+        return PartitionMap(PartitionScheme::RoundRobin, nodeCount, size);
+    }
+    if (partitionFile.empty() && schemeName == "contiguous") {
+        return PartitionMap(PartitionScheme::Contiguous, nodeCount, size);
+    }
+
+    vector<int> owners(nodeCount);
+    int ok = 1;
+    if (rank == 0) {
+        if (!partitionFile.empty()) {
+            ok = Partitioner::loadPartition(partitionFile, owners, nodeCount, size);
+        } else {
+            CSRGraph graph;
+            ok = graph.loadFromFile(graphFile);
+            if (ok) {
+                owners = (schemeName == "bfs")
+                    ? Partitioner::getBFSPartition(graph, size)
+                    : Partitioner::getCoordinatePartition(graph, size);
+            }
+        }
+    }
+
+    MPI_Bcast(&ok, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (!ok) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    const int* block = topology.createSharedInts(PartitionMap::getOwnerTableInts(nodeCount, size), [&](int* table) {
+        if (rank == 0) {
+            copy(owners.begin(), owners.end(), table);
+        }
+        MPI_Bcast(table, nodeCount, MPI_INT, 0, topology.getLeaderComm());
+        PartitionMap::buildOwnerTable(table, nodeCount, size);
+    });
+    return PartitionMap(block, nodeCount, size);
+}
+
+// Write the owned distances of all ranks as one distance field file, in
+// original node order when the graph was reordered (originalIds non-empty).
+// Returns the number of fixed-point values that saturated, or -1 on error.
+template <typename Shard>
+long long writeDistanceField(const string& filename, DistanceEncoding encoding, double scale,
+                             DistanceIO io, const Shard& shard, const PartitionMap& partition,
+                             const vector<double>& distances, const vector<int>& sources,
+                             const vector<int>& originalIds, int rank, int size) {
+    int nodeCount = shard.getGlobalNodeCount();
+    int ownedCount = shard.getOwnedCount();
+
+    if (io == DistanceIO::Gather) {
+        vector<double> owned(distances.begin(), distances.begin() + ownedCount);
+        vector<double> all = MPIWrapper::gatherDistances(owned, 0, rank);
+
+        long long saturated = 0;
+        if (rank == 0) {
+            // Rank r's owned nodes arrive in local index order at rankStart[r]
+            vector<int> rankStart(size + 1, 0);
+            for (int v = 0; v < nodeCount; v++) {
+                rankStart[partition.getOwner(v) + 1]++;
+            }
+            for (int r = 0; r < size; r++) {
+                rankStart[r + 1] += rankStart[r];
+            }
+
+            vector<double> field(nodeCount);
+            for (int v = 0; v < nodeCount; v++) {
+                int original = originalIds.empty() ? v : originalIds[v];
+                field[original] = all[rankStart[partition.getOwner(v)] + partition.getLocalIndex(v)];
+            }
+
+            DistanceFieldWriter writer;
+            bool ok = writer.open(filename, encoding, nodeCount, sources, scale);
+            if (ok) {
+                writer.append(field.data(), field.size());
+                ok = writer.close();
+            }
+            saturated = ok ? writer.getSaturatedCount() : -1;
+        }
+        MPI_Bcast(&saturated, 1, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+        return saturated;
+    }
+
+    // MPI-IO file views need ascending positions. Owned slots are in
+    // ascending global ID order, but a reordered graph writes by original ID.
+    vector<int> order(ownedCount);
+    vector<int> positions(ownedCount);
+    for (int slot = 0; slot < ownedCount; slot++) {
+        order[slot] = slot;
+        positions[slot] = originalIds.empty() ? shard.getGlobalId(slot) : originalIds[shard.getGlobalId(slot)];
+    }
+    if (!originalIds.empty()) {
+        sort(order.begin(), order.end(), [&](int a, int b) { return positions[a] < positions[b]; });
+    }
+    vector<int> globalIds(ownedCount);
+    vector<double> values(ownedCount);
+    for (int i = 0; i < ownedCount; i++) {
+        globalIds[i] = positions[order[i]];
+        values[i] = distances[order[i]];
+    }
+    size_t width = getDistanceEncodingBytes(encoding);
+    vector<char> encoded(ownedCount * width);
+    long long localSaturated = encodeDistances(values.data(), ownedCount, encoding, scale, encoded.data());
+
+    DistanceFieldHeader header;
+    vector<char> prefix = buildDistanceFieldPrefix(header, encoding, nodeCount, sources, scale);
+    MPI_Datatype type = (encoding == DistanceEncoding::Float64) ? MPI_DOUBLE
+                      : (encoding == DistanceEncoding::Float32) ? MPI_FLOAT : MPI_UINT32_T;
+    bool ok = MPIWrapper::writeIndexedFile(filename, prefix, header.valuesPos(),
+                                           header.valuesPos() + (uint64_t)nodeCount * width,
+                                           encoded.data(), globalIds, type, rank);
+
+    long long saturated = 0;
+    MPI_Allreduce(&localSaturated, &saturated, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    return ok ? saturated : -1;
+}
+
+// Work of one distributed repair, summed over ranks
+struct RepairReport {
+    long long edgesChanged = 0;
+    long long affected = 0;      // Nodes whose distance was recomputed
+    long long seeds = 0;         // Nodes the re-relaxation started from
+    long long edgesRelaxed = 0;
+    int rounds = 0;              // Invalidation supersteps
+    double repairMs = 0.0;
+};
+
+// Apply one batch of edge updates (internal IDs, see DynamicGraph.h) to the
+// shard and repair the one-to-all distances in place. The owner of an
+// edge's source applies and checks it. A rank cannot cheaply tell whether a
+// remote node keeps another tight parent, so the invalidation is the
+// conservative half of Ramalingam-Reps: on the graph before the batch,
+// the head of every tight edge that gets heavier or disappears is
+// affected, and so, superstep by superstep, is the head of every tight
+// edge out of an affected node. A node outside that set still has its old
+// shortest path, so its distance stays a valid upper bound. After the batch
+// is applied the affected nodes are reset, and the seeded solver relaxes
+// from their unaffected in-neighbours and the tails of changed edges only.
+// solveFromSeeds(seeds, stats) runs the solver of the chosen mode.
+template <typename Weight, typename SeededSolve>
+RepairReport repairDistances(
+    BasicGraphShard<Weight>& shard,
+    const PartitionMap& partition,
+    int rank,
+    int size,
+    FrontierExchange<BasicGraphShard<Weight>>& exchange,
+    vector<double>& distances,
+    const vector<char>& isSource,
+    const vector<EdgeUpdate>& batch,
+    SeededSolve solveFromSeeds
+) {
+    MPI_Barrier(MPI_COMM_WORLD);
+    auto repairStart = steady_clock::now();
+    int nodeCount = shard.getGlobalNodeCount();
+    int ownedCount = shard.getOwnedCount();
+    shard.prepareUpdates();
+
+    // Updates this rank applies, with the weight as stored
+    vector<const EdgeUpdate*> ownUpdates;
+    vector<Weight> newWeights;
+    for (const EdgeUpdate& update : batch) {
+        if (update.from < 0 || update.from >= nodeCount || update.to < 0 || update.to >= nodeCount) {
+            if (rank == 0) {
+                cerr << "Warning: Skipping update of " << update.from << " -> " << update.to << " (invalid node)\n";
+            }
+            continue;
+        }
+        if (partition.getOwner(update.from) != rank) {
+            continue;
+        }
+        Weight stored = Weight();
+        if (update.kind != EdgeUpdateKind::Delete && !WeightTraits<Weight>::convert(update.weight, stored)) {
+            cerr << "Warning: Skipping update of " << update.from << " -> " << update.to << " (weight does not fit "
+                 << getWeightTypeName(WeightTraits<Weight>::TYPE) << ")\n";
+            continue;
+        }
+        ownUpdates.push_back(&update);
+        newWeights.push_back(stored);
+    }
+
+    // 1. Invalidation on the old graph. A candidate (v, d) says that an
+    // edge into v that is going away or becoming invalid gave v distance
+    // d; v is affected if that is its distance.
+    RepairReport local;
+    vector<char> affected(ownedCount, 0);
+    vector<int> affectedNodes, wave;
+    vector<vector<DistanceUpdate>> outgoing(size);
+    auto markTight = [&](int slot, double candidate) {
+        if (!affected[slot] && !isSource[slot] && distances[slot] != INF && candidate == distances[slot]) {
+            affected[slot] = 1;
+            affectedNodes.push_back(slot);
+            wave.push_back(slot);
+        }
+    };
+    auto offerTight = [&](int slot, double candidate) {
+        if (shard.isOwnedSlot(slot)) {
+            markTight(slot, candidate);
+        } else {
+            outgoing[shard.getGhostOwner(slot)].emplace_back(shard.getGlobalId(slot), candidate);
+        }
+    };
+
+    for (size_t i = 0; i < ownUpdates.size(); i++) {
+        const EdgeUpdate& update = *ownUpdates[i];
+        int u = partition.getLocalIndex(update.from);
+        int v = shard.findSlot(update.to, partition, rank);
+        if (update.kind == EdgeUpdateKind::Insert || distances[u] == INF || v < 0) {
+            continue;
+        }
+        for (int e = shard.edgeBegin(u); e < shard.edgeEnd(u); e++) {
+            if (shard.getTarget(e) == v &&
+                (update.kind == EdgeUpdateKind::Delete || newWeights[i] > shard.getWeight(e))) {
+                offerTight(v, distances[u] + (double)shard.getWeight(e));
+            }
+        }
+    }
+    MessageCounters counters;
+    while (true) {
+        for (const DistanceUpdate& candidate : MPIWrapper::exchangeDistanceUpdates(outgoing, counters)) {
+            markTight(partition.getLocalIndex(candidate.nodeId), candidate.distance);
+        }
+        for (vector<DistanceUpdate>& messages : outgoing) {
+            messages.clear();
+        }
+        int localFlag = wave.empty() ? 0 : 1;
+        int globalFlag = 0;
+        exchange.allreduce(&localFlag, &globalFlag, 1, MPI_INT, MPI_MAX);
+        if (globalFlag == 0) {
+            break;
+        }
+        local.rounds++;
+        vector<int> frontier;
+        frontier.swap(wave);
+        for (int u : frontier) {
+            for (int e = shard.edgeBegin(u); e < shard.edgeEnd(u); e++) {
+                offerTight(shard.getTarget(e), distances[u] + (double)shard.getWeight(e));
+            }
+        }
+    }
+
+    // 2. Apply the batch; the tails of changed edges are re-relaxed
+    vector<int> changedTails;
+    for (size_t i = 0; i < ownUpdates.size(); i++) {
+        const EdgeUpdate& update = *ownUpdates[i];
+        int u = partition.getLocalIndex(update.from);
+        int v = shard.findSlot(update.to, partition, rank);
+        if (update.kind == EdgeUpdateKind::Insert) {
+            if (v < 0) {
+                v = shard.addGhost(update.to, partition.getOwner(update.to));
+            }
+            shard.insertEdge(u, v, newWeights[i]);
+            local.edgesChanged++;
+            changedTails.push_back(u);
+            continue;
+        }
+        long long changed = 0;
+        for (int e = shard.edgeEnd(u) - 1; v >= 0 && e >= shard.edgeBegin(u); e--) {
+            if (shard.getTarget(e) != v) {
+                continue;
+            }
+            if (update.kind == EdgeUpdateKind::Delete) {
+                shard.removeEdge(u, e);
+            } else {
+                shard.setWeight(e, newWeights[i]);
+            }
+            changed++;
+        }
+        if (changed == 0) {
+            cerr << "Warning: Skipping update of " << update.from << " -> " << update.to << " (no such edge)\n";
+            continue;
+        }
+        local.edgesChanged += changed;
+        changedTails.push_back(u);
+    }
+    exchange.growGhosts();
+    shard.prepareUpdates();
+
+    // 3. Reset the affected nodes everywhere this rank sees them, then
+    // re-relax from the reached nodes next to them
+    for (int slot : affectedNodes) {
+        distances[slot] = INF;
+    }
+    vector<int> affectedIds;
+    for (int slot : affectedNodes) {
+        affectedIds.push_back(shard.getGlobalId(slot));
+    }
+    vector<int> resetSlots = affectedNodes;
+    for (int nodeId : MPIWrapper::allgatherNodes(affectedIds)) {
+        int slot = shard.findSlot(nodeId, partition, rank);
+        if (slot >= 0 && !shard.isOwnedSlot(slot)) {
+            distances[slot] = INF;
+            resetSlots.push_back(slot);
+        }
+    }
+
+    vector<int> seeds;
+    vector<char> seeded(ownedCount, 0);
+    auto addSeed = [&](int u) {
+        if (!seeded[u] && distances[u] != INF) {
+            seeded[u] = 1;
+            seeds.push_back(u);
+        }
+    };
+    for (int slot : resetSlots) {
+        for (int i = shard.incomingBegin(slot); i < shard.incomingEnd(slot); i++) {
+            addSeed(shard.getIncomingSource(i));
+        }
+    }
+    for (int u : changedTails) {
+        addSeed(u);
+    }
+
+    SolverStats stats;
+    solveFromSeeds(seeds, stats);
+    local.affected = affectedNodes.size();
+    local.seeds = seeds.size();
+    local.edgesRelaxed = stats.edgesRelaxed;
+
+    long long localCounts[4] = {local.edgesChanged, local.affected, local.seeds, local.edgesRelaxed};
+    long long totalCounts[4];
+    MPI_Allreduce(localCounts, totalCounts, 4, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    RepairReport report;
+    report.edgesChanged = totalCounts[0];
+    report.affected = totalCounts[1];
+    report.seeds = totalCounts[2];
+    report.edgesRelaxed = totalCounts[3];
+    report.rounds = local.rounds;
+    MPI_Barrier(MPI_COMM_WORLD);
+    report.repairMs = duration<double, milli>(steady_clock::now() - repairStart).count();
+    return report;
+}
+
+void printUsage(const char* programName) {
+    cout << "Usage: mpirun -np N " << programName << " <graph_file> <source> <destination> [options]\n";
+    cout << "       mpirun -np N " << programName << " <graph_file> --batch <query_file|-> [options]\n";
+    cout << "       mpirun -np N " << programName << " <graph_file> --sssp <sources> [options]\n";
+    cout << "\nOptions:\n";
+    cout << "  --mode bsp|pipelined|delta|async\n";
+    cout << "                      - Bellman-Ford supersteps (default), supersteps whose\n";
+    cout << "                        exchange overlaps interior relaxation, delta-stepping,\n";
+    cout << "                        or asynchronous updates with token termination detection\n";
+    cout << "  --delta <w>|auto    - Bucket width for delta-stepping (default: auto)\n";
+    cout << "  --partition roundrobin|contiguous|bfs|coordinate\n";
+    cout << "                      - Node ownership scheme (default: roundrobin)\n";
+    cout << "  --partition-file <f> - Owner table written by the partitioner tool\n";
+    cout << "  --threads <n>       - Relaxation threads per process (default: 1)\n";
+    cout << "  --simd auto|scalar|avx2|avx512\n";
+    cout << "                      - Relaxation kernel (default: auto, the widest the CPU runs)\n";
+    cout << "  --weights double|float|uint32\n";
+    cout << "                      - Stored edge weight type (default: double); float and\n";
+    cout << "                        uint32 (integral weights only) halve the weight arrays\n";
+    cout << "  --flush-updates <n> - Async: send a rank's buffer at n updates (default: 1024)\n";
+    cout << "  --flush-us <t>      - Async: or once its oldest update is t us old (default: 200)\n";
+    cout << "  --steal             - Async: idle processes take frontier work from busy ones\n";
+    cout << "  --trace <f>         - Write a per-rank timeline of solver phases to f\n";
+    cout << "  --trace-format chrome|csv\n";
+    cout << "                      - Trace Event JSON for chrome://tracing or Perfetto\n";
+    cout << "                        (default), or one CSV row per event\n";
+    cout << "  --warmup <n>        - Untimed passes over the query or batch (default: 0)\n";
+    cout << "  --repeat <n>        - Timed passes; the report shows the last (default: 1)\n";
+    cout << "  --json <f>          - Write pass times and counters as benchmark JSON\n";
+    cout << "  --name <s>          - Implementation name in the JSON\n";
+    cout << "                        (default: Distributed[-Pipelined|-Delta|-Async][-Steal])\n";
+    cout << "  --label <s>         - Run label in the JSON (e.g. a build or commit)\n";
+    cout << "  --output <f>        - Batch result file (default: stdout)\n";
+    cout << "  --format csv|jsonl  - Batch result format (default: csv)\n";
+    cout << "  --sssp <sources>    - Distances from the sources to every node: \"s\",\n";
+    cout << "                        \"s1,s2,...\" (multi-source) or \"@file\" (one per line)\n";
+    cout << "  --distances <f>     - Write the distance field to f (binary, see DistanceField.h)\n";
+    cout << "  --distance-format double|float|fixed\n";
+    cout << "                      - Stored values (default: double)\n";
+    cout << "  --fixed-scale <s>   - Fixed point units per distance unit (default: fit the largest)\n";
+    cout << "  --distance-io parallel|gather\n";
+    cout << "                      - Every rank writes its own nodes with MPI-IO (default), or\n";
+    cout << "                        rank 0 gathers the field and writes it\n";
+    cout << "  --updates <f>       - Apply the edge updates of f batch by batch and repair the\n";
+    cout << "                        distances after each (see DynamicGraph.h)\n";
+    cout << "  --verify-updates    - Check the repaired field against a search from scratch\n";
+    cout << "  --checkpoint <p>    - Save each rank's search state to <p>.<rank>.{0,1} in the\n";
+    cout << "                        background (bsp, pipelined and delta modes); removed when\n";
+    cout << "                        the run completes\n";
+    cout << "  --checkpoint-every <n> - Supersteps between checkpoints (default: 50)\n";
+    cout << "  --restart           - Resume from the newest checkpoint complete on every rank;\n";
+    cout << "                        a resumed batch keeps the answers already in --output\n";
+    cout << "  --collectives auto|flat|hierarchical\n";
+    cout << "                      - Reduce within each host first and across hosts only\n";
+    cout << "                        between leaders (auto: when a host runs several ranks)\n";
+    cout << "  --ranks-per-host <k> - Treat runs of k consecutive ranks as one host\n";
+    cout << "                        (default: the ranks sharing memory)\n";
+}
+
+// The whole run for one stored weight type. Takes over from main() after
+// MPI is up and calls MPI_Finalize itself.
+template <typename Weight>
+int runSolver(int argc, char* argv[], int rank, int size) {
     if (argc < 4) {
         if (rank == 0) {
-            cout << "Usage: mpirun -np N " << argv[0] << " graph.txt source dest\n";
+            printUsage(argv[0]);
         }
         MPI_Finalize();
         return 1;
     }
-    
+
     string graphFile = argv[1];
-    int source = atoi(argv[2]);
-    int destination = atoi(argv[3]);
-    
-    // All processes load graph
-    Graph graph;
-    if (!graph.loadFromFile(graphFile)) {
+    bool batchMode = (string(argv[2]) == "--batch");
+    bool oneToAll = (string(argv[2]) == "--sssp");
+    int source = (batchMode || oneToAll) ? 0 : atoi(argv[2]);
+    int destination = (batchMode || oneToAll) ? 0 : atoi(argv[3]);
+    string queryFile = batchMode ? argv[3] : "";
+    string outputFile = "-";
+    ResultFormat format = ResultFormat::CSV;
+
+    // Parse options
+    SolverMode mode = SolverMode::BSP;
+    double delta = 0.0;  // 0 = derive from weights
+    string schemeName = "roundrobin";
+    string partitionFile;
+    int threadCount = 1;
+    SimdLevel simdLevel = detectSimdLevel();
+    int flushUpdates = 1024;
+    double flushAgeUs = 200.0;
+    bool stealing = false;
+    string traceFile;
+    TraceFormat traceFormat = TraceFormat::Chrome;
+    int warmupCount = 0;
+    int repeatCount = 1;
+    string jsonFile;
+    string resultName;
+    string runLabel;
+    vector<int> sources;
+    string distanceFile;
+    DistanceEncoding distanceEncoding = DistanceEncoding::Float64;
+    double fixedScale = 0.0;  // 0 = fit the largest distance
+    DistanceIO distanceIO = DistanceIO::Parallel;
+    string updateFile;
+    bool verifyUpdates = false;
+    string checkpointPrefix;
+    int checkpointInterval = 50;
+    bool restart = false;
+    string collectives = "auto";
+    int ranksPerHost = 0;
+    if (oneToAll && !parseSourceList(argv[3], sources)) {
+        MPI_Finalize();
+        return 1;
+    }
+    for (int i = 4; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--weights" && i + 1 < argc) {
+            i++;  // Picked by main()
+        } else if (arg == "--mode" && i + 1 < argc) {
+            string modeName = argv[++i];
+            if (modeName == "delta") {
+                mode = SolverMode::Delta;
+            } else if (modeName == "async") {
+                mode = SolverMode::Async;
+            } else if (modeName == "pipelined") {
+                mode = SolverMode::Pipelined;
+            } else if (modeName != "bsp") {
+                if (rank == 0) {
+                    cerr << "Error: Unknown mode " << modeName << "\n";
+                }
+                MPI_Finalize();
+                return 1;
+            }
+        } else if (arg == "--delta" && i + 1 < argc) {
+            string value = argv[++i];
+            delta = (value == "auto") ? 0.0 : atof(value.c_str());
+            if (delta < 0.0 || (value != "auto" && delta == 0.0)) {
+                if (rank == 0) {
+                    cerr << "Error: --delta must be a positive weight or 'auto'\n";
+                }
+                MPI_Finalize();
+                return 1;
+            }
+        } else if (arg == "--partition" && i + 1 < argc) {
+            schemeName = argv[++i];
+            if (schemeName != "roundrobin" && schemeName != "contiguous" &&
+                schemeName != "bfs" && schemeName != "coordinate") {
+                if (rank == 0) {
+                    cerr << "Error: Unknown partition scheme " << schemeName << "\n";
+                }
+                MPI_Finalize();
+                return 1;
+            }
+        } else if (arg == "--partition-file" && i + 1 < argc) {
+            partitionFile = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threadCount = atoi(argv[++i]);
+            if (threadCount <= 0) {
+                if (rank == 0) {
+                    cerr << "Error: --threads must be positive\n";
+                }
+                MPI_Finalize();
+                return 1;
+            }
+#ifndef _OPENMP
+            if (rank == 0 && threadCount > 1) {
+                cerr << "Warning: Built without OpenMP, using 1 thread per process\n";
+            }
+            threadCount = 1;
+#endif
+        } else if (arg == "--simd" && i + 1 < argc) {
+            string levelName = argv[++i];
+            if (!parseSimdLevel(levelName, simdLevel) || !isSimdLevelSupported(simdLevel)) {
+                if (rank == 0) {
+                    cerr << "Error: SIMD level " << levelName << " is unknown or not supported by this CPU\n";
+                }
+                MPI_Finalize();
+                return 1;
+            }
+        } else if (arg == "--flush-updates" && i + 1 < argc) {
+            flushUpdates = atoi(argv[++i]);
+            if (flushUpdates <= 0) {
+                if (rank == 0) {
+                    cerr << "Error: --flush-updates must be positive\n";
+                }
+                MPI_Finalize();
+                return 1;
+            }
+        } else if (arg == "--flush-us" && i + 1 < argc) {
+            flushAgeUs = atof(argv[++i]);
+        } else if (arg == "--steal") {
+            stealing = true;
+        } else if (arg == "--trace" && i + 1 < argc) {
+            traceFile = argv[++i];
+        } else if (arg == "--trace-format" && i + 1 < argc) {
+            if (!parseTraceFormat(argv[++i], traceFormat)) {
+                if (rank == 0) {
+                    cerr << "Error: Unknown trace format " << argv[i] << "\n";
+                }
+                MPI_Finalize();
+                return 1;
+            }
+        } else if ((arg == "--warmup" || arg == "--repeat") && i + 1 < argc) {
+            int passes = atoi(argv[++i]);
+            if (passes < 0 || (arg == "--repeat" && passes == 0)) {
+                if (rank == 0) {
+                    cerr << "Error: --repeat must be positive, --warmup non-negative\n";
+                }
+                MPI_Finalize();
+                return 1;
+            }
+            (arg == "--warmup" ? warmupCount : repeatCount) = passes;
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonFile = argv[++i];
+        } else if (arg == "--name" && i + 1 < argc) {
+            resultName = argv[++i];
+        } else if (arg == "--label" && i + 1 < argc) {
+            runLabel = argv[++i];
+        } else if (batchMode && arg == "--output" && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (batchMode && arg == "--format" && i + 1 < argc) {
+            if (!parseResultFormat(argv[++i], format)) {
+                if (rank == 0) {
+                    cerr << "Error: Unknown result format " << argv[i] << "\n";
+                }
+                MPI_Finalize();
+                return 1;
+            }
+        } else if (oneToAll && arg == "--distances" && i + 1 < argc) {
+            distanceFile = argv[++i];
+        } else if (oneToAll && arg == "--distance-format" && i + 1 < argc) {
+            if (!parseDistanceEncoding(argv[++i], distanceEncoding)) {
+                if (rank == 0) {
+                    cerr << "Error: Unknown distance format " << argv[i] << "\n";
+                }
+                MPI_Finalize();
+                return 1;
+            }
+        } else if (oneToAll && arg == "--fixed-scale" && i + 1 < argc) {
+            fixedScale = atof(argv[++i]);
+            if (fixedScale <= 0.0) {
+                if (rank == 0) {
+                    cerr << "Error: --fixed-scale must be positive\n";
+                }
+                MPI_Finalize();
+                return 1;
+            }
+        } else if (oneToAll && arg == "--distance-io" && i + 1 < argc) {
+            string ioName = argv[++i];
+            if (ioName == "gather") {
+                distanceIO = DistanceIO::Gather;
+            } else if (ioName != "parallel") {
+                if (rank == 0) {
+                    cerr << "Error: Unknown distance I/O " << ioName << "\n";
+                }
+                MPI_Finalize();
+                return 1;
+            }
+        } else if (oneToAll && arg == "--updates" && i + 1 < argc) {
+            updateFile = argv[++i];
+        } else if (oneToAll && arg == "--verify-updates") {
+            verifyUpdates = true;
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            checkpointPrefix = argv[++i];
+        } else if (arg == "--checkpoint-every" && i + 1 < argc) {
+            checkpointInterval = atoi(argv[++i]);
+            if (checkpointInterval <= 0) {
+                if (rank == 0) {
+                    cerr << "Error: --checkpoint-every must be positive\n";
+                }
+                MPI_Finalize();
+                return 1;
+            }
+        } else if (arg == "--restart") {
+            restart = true;
+        } else if (arg == "--collectives" && i + 1 < argc) {
+            collectives = argv[++i];
+            if (collectives != "auto" && collectives != "flat" && collectives != "hierarchical") {
+                if (rank == 0) {
+                    cerr << "Error: --collectives must be auto, flat or hierarchical\n";
+                }
+                MPI_Finalize();
+                return 1;
+            }
+        } else if (arg == "--ranks-per-host" && i + 1 < argc) {
+            ranksPerHost = atoi(argv[++i]);
+            if (ranksPerHost <= 0) {
+                if (rank == 0) {
+                    cerr << "Error: --ranks-per-host must be positive\n";
+                }
+                MPI_Finalize();
+                return 1;
+            }
+        } else {
+            if (rank == 0) {
+                cerr << "Error: Unknown option " << arg << "\n";
+                printUsage(argv[0]);
+            }
+            MPI_Finalize();
+            return 1;
+        }
+    }
+
+    if (stealing && mode != SolverMode::Async) {
+        if (rank == 0) {
+            cerr << "Error: --steal requires --mode async\n";
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    // The asynchronous solver has no point where nothing is in flight, and
+    // a resumed run only continues the pass it was checkpointed in
+    if (!checkpointPrefix.empty() || restart) {
+        const char* problem = nullptr;
+        if (checkpointPrefix.empty()) {
+            problem = "--restart requires --checkpoint";
+        } else if (mode == SolverMode::Async) {
+            problem = "--checkpoint requires --mode bsp, pipelined or delta";
+        } else if (warmupCount > 0 || repeatCount > 1) {
+            problem = "--checkpoint cannot be combined with --warmup or --repeat";
+        }
+        if (problem) {
+            if (rank == 0) {
+                cerr << "Error: " << problem << "\n";
+            }
+            MPI_Finalize();
+            return 1;
+        }
+    }
+
+    // Every rank reads only the rows it owns
+    auto loadStart = high_resolution_clock::now();
+
+    int nodeCount;
+    long long edgeCount;
+    if (!GraphShard::readGraphSize(graphFile, nodeCount, edgeCount)) {
         cerr << "Process " << rank << ": Error loading graph\n";
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
-    
-    int nodeCount = graph.getNodeCount();
-    int edgeCount = graph.getEdgeCount();
-    
-    // Round-robin partitioning
-    vector<int> myPartition = Partitioner::getRoundRobinPartition(graph, rank, size);
-    unordered_set<int> myNodes(myPartition.begin(), myPartition.end());
-    
-    MPI_Barrier(MPI_COMM_WORLD);
-    auto startTime = high_resolution_clock::now();
-    
-    // Initialize distances
-    vector<double> distances(nodeCount, numeric_limits<double>::infinity());
-    vector<double> globalDistances(nodeCount, numeric_limits<double>::infinity());
-    
-    // Set source distance
-    if (myNodes.count(source)) {
-        distances[source] = 0.0;
-    }
-    
-    // Initial synchronization
-    MPI_Allreduce(distances.data(), globalDistances.data(), nodeCount, 
-                  MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
-    distances = globalDistances;
-    
-    // Statistics
-    int iterationsCompleted = 0;
-    int edgesRelaxed = 0;
-    int localUpdates = 0;
-    
-    // Bellman-Ford style relaxation
-    int maxIterations = nodeCount;
-    
-    for (int iteration = 0; iteration < maxIterations; iteration++) {
-        bool localChanged = false;
-        iterationsCompleted++;
-        
-        // Each process relaxes edges from its partition
-        for (int u : myPartition) {
-            if (distances[u] == numeric_limits<double>::infinity()) {
-                continue;
+
+    if (source < 0 || source >= nodeCount || destination < 0 || destination >= nodeCount) {
+        if (rank == 0) {
+            cerr << "Error: Invalid source or destination node\n";
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    for (int sourceNode : sources) {
+        if (sourceNode < 0 || sourceNode >= nodeCount) {
+            if (rank == 0) {
+                cerr << "Error: Invalid source node " << sourceNode << "\n";
             }
-            
-            for (const Edge& e : graph.getAdjacencyList(u)) {
-                int v = e.destination;
-                double newDist = distances[u] + e.weight;
-                edgesRelaxed++;
-                
-                if (newDist < distances[v]) {
-                    distances[v] = newDist;
-                    localChanged = true;
-                    localUpdates++;
-                }
-            }
-        }
-        
-        // Synchronize distances across all processes
-        MPI_Allreduce(distances.data(), globalDistances.data(), nodeCount, 
-                      MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
-        distances = globalDistances;
-        
-        // Check global convergence
-        int localFlag = localChanged ? 1 : 0;
-        int globalFlag = 0;
-        MPI_Allreduce(&localFlag, &globalFlag, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-        
-        if (globalFlag == 0) {
-            break;
+            MPI_Finalize();
+            return 1;
+        }
+    }
+
+    // A reordered graph is solved in its own numbering; node IDs on the
+    // command line, in queries and in results stay the original ones
+    vector<int> originalIds;
+    vector<int> internalIds;
+    if (!GraphShard::readOriginalIds(graphFile, originalIds)) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (!originalIds.empty()) {
+        internalIds.assign(nodeCount, -1);
+        for (int v = 0; v < nodeCount; v++) {
+            if (originalIds[v] < 0 || originalIds[v] >= nodeCount || internalIds[originalIds[v]] >= 0) {
+                cerr << "Process " << rank << ": Invalid original ID table in " << graphFile << "\n";
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            internalIds[originalIds[v]] = v;
+        }
+    }
+    auto toInternal = [&](int node) { return internalIds.empty() ? node : internalIds[node]; };
+    vector<int> internalSources;
+    for (int sourceNode : sources) {
+        internalSources.push_back(toInternal(sourceNode));
+    }
+
+    // Every rank reads the whole update file and applies its own updates
+    vector<vector<EdgeUpdate>> updateBatches;
+    if (!updateFile.empty()) {
+        int loaded = loadEdgeUpdates(updateFile, updateBatches);
+        int allLoaded = 0;
+        MPI_Allreduce(&loaded, &allLoaded, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+        if (!allLoaded) {
+            MPI_Finalize();
+            return 1;
+        }
+        // Out-of-range IDs are left for repairDistances() to reject
+        for (vector<EdgeUpdate>& batch : updateBatches) {
+            for (EdgeUpdate& update : batch) {
+                if (update.from >= 0 && update.from < nodeCount && update.to >= 0 && update.to < nodeCount) {
+                    update.from = toInternal(update.from);
+                    update.to = toInternal(update.to);
+                }
+            }
+        }
+    }
+
+    NodeTopology topology(ranksPerHost);
+    topology.setHierarchical(collectives == "hierarchical" ||
+                             (collectives == "auto" && topology.benefitsFromHierarchy()));
+    PartitionMap partition = buildPartitionMap(schemeName, partitionFile, graphFile,
+                                               nodeCount, rank, size, topology);
+    // A rank that finds its share damaged reports why; all ranks then stop
+    BasicGraphShard<Weight> shard;
+    int shardLoaded = shard.loadFromFile(graphFile, partition, rank);
+    int allShardsLoaded = 0;
+    MPI_Allreduce(&shardLoaded, &allShardsLoaded, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if (!allShardsLoaded) {
+        if (rank == 0) {
+            cerr << "Error: Failed to load graph file " << graphFile << "\n";
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    edgeCount = shard.getGlobalEdgeCount();
+
+    double loadMs = duration<double, milli>(high_resolution_clock::now() - loadStart).count();
+
+    if (mode == SolverMode::Delta && delta == 0.0) {
+        delta = computeAutoDelta(shard);
+    }
+
+    // Scratch state shared by all queries: owner-local distances (owned
+    // slots followed by ghost slots) and the exchange buffers
+    vector<double> distances(shard.getSlotCount(), INF);
+    FrontierExchange exchange(shard, partition, topology, distances, rank, size, flushUpdates, flushAgeUs);
+    exchange.setSimdLevel(simdLevel);
+    TerminationDetector termination(rank, size);
+    WorkStealer stealer(shard, rank, size, ASYNC_ROUND_NODES_PER_THREAD * threadCount);
+    vector<RelaxBuffer> buffers(threadCount);
+    SolverStats stats;
+    SolverTrace trace(rank, !traceFile.empty());
+
+    // Checkpoints belong to one run (its kind and sources; a batch checks
+    // its queries as it replays them) on one partition (the graph size, the
+    // global IDs of every rank's own nodes and their edges and weights)
+    CheckpointWriter checkpointWriter(checkpointPrefix, rank);
+    uint64_t runHash = 0, partitionHash = 0;
+    if (!checkpointPrefix.empty()) {
+        PayloadChecksum runKey;
+        int kind = batchMode ? 2 : (oneToAll ? 1 : 0);
+        vector<int> runSources = oneToAll ? internalSources : vector<int>();
+        if (!batchMode && !oneToAll) {
+            runSources = {toInternal(source), toInternal(destination)};
+        }
+        runKey.update(&kind, sizeof(kind));
+        runKey.update(runSources.data(), runSources.size() * sizeof(int));
+        runHash = runKey.finish();
+
+        PayloadChecksum partitionKey;
+        partitionKey.update(&nodeCount, sizeof(nodeCount));
+        partitionKey.update(&edgeCount, sizeof(edgeCount));
+        for (int slot = 0; slot < shard.getOwnedCount(); slot++) {
+            int globalId = shard.getGlobalId(slot);
+            partitionKey.update(&globalId, sizeof(globalId));
+        }
+        vector<int> edgeTargets;
+        vector<double> edgeWeights;
+        for (int slot = 0; slot < shard.getOwnedCount(); slot++) {
+            for (int e = shard.edgeBegin(slot); e < shard.edgeEnd(slot); e++) {
+                edgeTargets.push_back(shard.getGlobalId(shard.getTarget(e)));
+                edgeWeights.push_back(shard.getWeight(e));
+            }
+        }
+        partitionKey.update(edgeTargets.data(), edgeTargets.size() * sizeof(int));
+        partitionKey.update(edgeWeights.data(), edgeWeights.size() * sizeof(double));
+        partitionHash = partitionKey.finish();
+    }
+    SolverCheckpoint solverCheckpoint(checkpointWriter, distances, shard.getOwnedCount(), checkpointInterval,
+                                      runHash, partitionHash, rank, size);
+    SolverCheckpoint* checkpointing = checkpointPrefix.empty() ? nullptr : &solverCheckpoint;
+
+    // A restarted run continues from the newest checkpoint all ranks have;
+    // a fresh one first drops any left by an earlier run, whose numbers
+    // would otherwise clash with its own
+    CheckpointState resumeState;
+    bool resumed = false;
+    bool resumePending = false;
+    if (restart) {
+        if (!checkpointWriter.loadLatest(resumeState, runHash, partitionHash, size)) {
+            MPI_Finalize();
+            return 1;
+        }
+        resumed = resumePending = true;
+    } else if (checkpointing) {
+        checkpointWriter.remove();
+    }
+
+    // Run the solver of the chosen mode from the current distances; with
+    // seeds, only those own nodes start active
+    auto runMode = [&](const vector<int>* seeds, SolverStats& runStats, SolverCheckpoint* runCheckpoint) {
+        switch (mode) {
+            case SolverMode::Delta:
+                runDeltaStepping(shard, exchange, distances, delta, buffers, runStats, trace, seeds,
+                                 runCheckpoint);
+                break;
+            case SolverMode::Async:
+                runAsync(shard, partition, rank, exchange, distances, termination,
+                         stealing ? &stealer : nullptr, buffers, runStats, trace, seeds);
+                break;
+            case SolverMode::Pipelined:
+                runPipelinedBellmanFord(shard, exchange, distances, buffers, runStats, trace, seeds,
+                                        runCheckpoint);
+                break;
+            default:
+                runBellmanFord(shard, exchange, distances, buffers, runStats, trace, seeds, runCheckpoint);
+        }
+    };
+
+    // Distances from every node in sourceNodes to all nodes; each rank
+    // ends up with the final distances of its owned slots. The first solve
+    // of a restarted run picks the search up where the checkpoint left it.
+    auto solveFrom = [&](const vector<int>& sourceNodes) {
+        auto solveStart = steady_clock::now();
+        fill(distances.begin(), distances.end(), INF);
+        if (resumePending) {
+            copy(resumeState.distances.begin(), resumeState.distances.end(), distances.begin());
+            resumePending = false;
+            runMode(&resumeState.frontier, stats, checkpointing);
+        } else {
+            for (int sourceNode : sourceNodes) {
+                if (partition.getOwner(sourceNode) == rank) {
+                    distances[partition.getLocalIndex(sourceNode)] = 0.0;
+                }
+            }
+            runMode(nullptr, stats, checkpointing);
+        }
+        stats.solveMs += duration<double, milli>(steady_clock::now() - solveStart).count();
+    };
+
+    // Re-relax from own seed nodes, keeping the current distances
+    auto solveFromSeeds = [&](const vector<int>& seeds, SolverStats& repairStats) {
+        runMode(&seeds, repairStats, nullptr);
+    };
+
+    // Solve one query; the destination distance is returned on rank 0
+    vector<int> querySources(1);
+    auto solveQuery = [&](int querySource, int queryDestination) {
+        querySources[0] = querySource;
+        solveFrom(querySources);
+
+        // Only the owner holds the authoritative distance of the destination
+        double ownedDist = (partition.getOwner(queryDestination) == rank)
+            ? distances[partition.getLocalIndex(queryDestination)] : INF;
+        double finalDist = INF;
+        MPI_Reduce(&ownedDist, &finalDist, 1, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+        return finalDist;
+    };
+
+    QueryReader reader;
+    QueryResultWriter writer;
+    int ok = 1;
+    if (batchMode && rank == 0) {
+        // A restarted batch keeps the results answered before the checkpoint
+        ok = reader.open(queryFile) &&
+             (resumed ? writer.resume(outputFile, format, resumeState.query) : writer.open(outputFile, format));
+    }
+    MPI_Bcast(&ok, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (!ok) {
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Warm-up passes are discarded. Counters are reset for every pass, so
+    // the report describes the last one; the JSON summarises the times of
+    // all measured passes. A repeated batch is buffered by rank 0 on the
+    // first pass and replayed; results are written on the last pass only.
+    int passCount = warmupCount + repeatCount;
+    vector<Query> replay;
+    vector<double> passTimesUs;
+    high_resolution_clock::time_point startTime, endTime;
+    double finalDist = INF;
+    int queryCount = 0;
+    vector<double> latencies;
+    for (int pass = 0; pass < passCount; pass++) {
+        bool lastPass = (pass == passCount - 1);
+        stats = SolverStats();
+        exchange.getCounters() = MessageCounters();
+        trace.clear();
+        queryCount = 0;
+        latencies.clear();
+        if (resumed) {
+            solverCheckpoint.resume(resumeState, stats);
+        }
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        startTime = high_resolution_clock::now();
+        trace.start();
+
+        if (batchMode) {
+            // Rank 0 reads the stream and broadcasts one query at a time, so
+            // queries can keep arriving on stdin while earlier ones are solved
+            auto isValid = [&](const Query& query) {
+                return query.source >= 0 && query.source < nodeCount &&
+                       query.destination >= 0 && query.destination < nodeCount;
+            };
+            // A resumed batch skips the queries answered before the checkpoint,
+            // and every rank checks that they are the ones the run had read
+            int answered = resumed ? resumeState.query : 0;
+            PayloadChecksum queryKey;
+            while (true) {
+                int pair[2] = {-1, -1};
+                Query query;
+                if (rank == 0 && pass > 0) {
+                    if (queryCount < (int)replay.size()) {
+                        pair[0] = replay[queryCount].source;
+                        pair[1] = replay[queryCount].destination;
+                    }
+                } else if (rank == 0) {
+                    while (reader.next(query)) {
+                        if (isValid(query)) {
+                            pair[0] = query.source;
+                            pair[1] = query.destination;
+                            if (passCount > 1) {
+                                replay.push_back(query);
+                            }
+                            break;
+                        }
+                        cerr << "Warning: Skipping query " << query.source << " -> "
+                             << query.destination << " (invalid node)\n";
+                    }
+                }
+                MPI_Bcast(pair, 2, MPI_INT, 0, MPI_COMM_WORLD);
+                if (pair[0] >= 0) {
+                    queryKey.update(pair, sizeof(pair));
+                }
+                if (resumePending && (pair[0] < 0 || (queryCount == answered &&
+                                                      queryKey.finish() != resumeState.queryHash))) {
+                    if (rank == 0) {
+                        cerr << "Error: " << queryFile << " does not hold the queries of the checkpointed run\n";
+                    }
+                    MPI_Finalize();
+                    return 1;
+                }
+                if (pair[0] < 0) {
+                    break;
+                }
+                if (queryCount < answered) {
+                    queryCount++;
+                    continue;
+                }
+
+                if (checkpointing) {
+                    checkpointing->query = queryCount;
+                    checkpointing->queryHash = queryKey.finish();
+                }
+                auto queryStart = high_resolution_clock::now();
+                double dist = solveQuery(toInternal(pair[0]), toInternal(pair[1]));
+                double latencyUs = duration<double, micro>(high_resolution_clock::now() - queryStart).count();
+
+                if (rank == 0) {
+                    latencies.push_back(latencyUs);
+                    if (lastPass) {
+                        writer.write(queryCount, Query(pair[0], pair[1]), dist, -1, latencyUs);
+                        // Answers before a checkpoint must survive a crash
+                        if (checkpointing) {
+                            writer.flush();
+                        }
+                    }
+                }
+                queryCount++;
+            }
+            if (rank == 0) {
+                writer.flush();
+            }
+        } else if (oneToAll) {
+            solveFrom(internalSources);
+            queryCount = 1;
+        } else {
+            finalDist = solveQuery(toInternal(source), toInternal(destination));
+            queryCount = 1;
+        }
+
+        endTime = high_resolution_clock::now();
+        if (pass >= warmupCount) {
+            passTimesUs.push_back(duration<double, micro>(endTime - startTime).count());
         }
     }
-    
-    auto endTime = high_resolution_clock::now();
     auto duration = duration_cast<milliseconds>(endTime - startTime).count();
-    
+    SampleStats passTimes = SampleStats::compute(passTimesUs);
+
+    // The search is complete, so its checkpoints are of no further use
+    double checkpointStallMs = 0.0;
+    if (checkpointing) {
+        checkpointWriter.finish();
+        checkpointWriter.remove();
+        checkpointing = nullptr;
+        double localStallMs = checkpointWriter.getStallMs();
+        MPI_Reduce(&localStallMs, &checkpointStallMs, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    }
+
+    // Edge updates: repair the field batch by batch, outside the timed
+    // passes; the counters, load table and trace stay those of the initial
+    // search
+    vector<RepairReport> repairs;
+    double fullRecomputeMs = 0.0;
+    long long mismatches = 0;
+    if (!updateBatches.empty()) {
+        SolverStats savedStats = stats;
+        MessageCounters savedCounters = exchange.getCounters();
+        SolverTrace savedTrace = trace;
+        vector<char> isSource(shard.getOwnedCount(), 0);
+        for (int sourceNode : internalSources) {
+            if (partition.getOwner(sourceNode) == rank) {
+                isSource[partition.getLocalIndex(sourceNode)] = 1;
+            }
+        }
+        for (const vector<EdgeUpdate>& batch : updateBatches) {
+            repairs.push_back(repairDistances(shard, partition, rank, size, exchange, distances,
+                                              isSource, batch, solveFromSeeds));
+        }
+
+        if (verifyUpdates) {
+            vector<double> repaired(distances.begin(), distances.begin() + shard.getOwnedCount());
+            MPI_Barrier(MPI_COMM_WORLD);
+            auto verifyStart = steady_clock::now();
+            solveFrom(internalSources);
+            MPI_Barrier(MPI_COMM_WORLD);
+            fullRecomputeMs = chrono::duration<double, milli>(steady_clock::now() - verifyStart).count();
+            long long localMismatches = 0;
+            for (int slot = 0; slot < shard.getOwnedCount(); slot++) {
+                double want = distances[slot];
+                double got = repaired[slot];
+                localMismatches += !sameDistance(want, got);
+            }
+            MPI_Allreduce(&localMismatches, &mismatches, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+            copy(repaired.begin(), repaired.end(), distances.begin());
+        }
+
+        long long localEdges = shard.getEdgeCount();
+        MPI_Allreduce(&localEdges, &edgeCount, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+        stats = savedStats;
+        exchange.getCounters() = savedCounters;
+        trace = savedTrace;
+    }
+
+    // One-to-all: summarise the field and write it, outside the timed passes
+    long long reachedNodes = 0;
+    double maxDistance = 0.0;
+    double distanceScale = 1.0;
+    double distanceWriteMs = 0.0;
+    if (oneToAll) {
+        long long localReached = 0;
+        double localMax = 0.0;
+        for (int slot = 0; slot < shard.getOwnedCount(); slot++) {
+            if (distances[slot] != INF) {
+                localReached++;
+                localMax = max(localMax, distances[slot]);
+            }
+        }
+        MPI_Allreduce(&localReached, &reachedNodes, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+        MPI_Allreduce(&localMax, &maxDistance, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+        if (!distanceFile.empty()) {
+            distanceScale = fixedScale > 0.0 ? fixedScale : DistanceFieldFormat::chooseFixedScale(maxDistance);
+            auto writeStart = high_resolution_clock::now();
+            long long saturated = writeDistanceField(distanceFile, distanceEncoding, distanceScale, distanceIO,
+                                                     shard, partition, distances, sources,
+                                                     originalIds, rank, size);
+            distanceWriteMs = duration_cast<microseconds>(high_resolution_clock::now() - writeStart).count() / 1000.0;
+            if (saturated < 0) {
+                MPI_Finalize();
+                return 1;
+            }
+            if (saturated > 0 && rank == 0) {
+                cerr << "Warning: " << saturated << " distances exceed the fixed-point range and were clamped\n";
+            }
+        }
+    }
+
     // Gather statistics
-    int totalEdgesRelaxed, totalLocalUpdates, maxIterations_global;
-    MPI_Reduce(&edgesRelaxed, &totalEdgesRelaxed, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&localUpdates, &totalLocalUpdates, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&iterationsCompleted, &maxIterations_global, 1, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
-    
+    long long totalEdgesRelaxed, totalLocalUpdates;
+    int maxIterations_global;
+    MPI_Reduce(&stats.edgesRelaxed, &totalEdgesRelaxed, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&stats.localUpdates, &totalLocalUpdates, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&stats.iterations, &maxIterations_global, 1, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // Message traffic summed over ranks
+    const MessageCounters& counters = exchange.getCounters();
+    long long localTraffic[5] = {counters.messagesSent, counters.bytesSent, counters.updatesOffered,
+                                 counters.updatesSent, counters.sendStalls};
+    long long totalTraffic[5] = {0, 0, 0, 0, 0};
+    MPI_Reduce(localTraffic, totalTraffic, 5, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    MessageCounters traffic;
+    traffic.messagesSent = totalTraffic[0];
+    traffic.bytesSent = totalTraffic[1];
+    traffic.updatesOffered = totalTraffic[2];
+    traffic.updatesSent = totalTraffic[3];
+    traffic.sendStalls = totalTraffic[4];
+
+    // Per-rank load: time relaxing versus communicating or waiting, and
+    // where the idle time went
+    const int LOAD_FIELDS = 8;
+    double busyMs = trace.getTotalMs(TracePhase::Compute);
+    double localLoad[LOAD_FIELDS] = {busyMs, stats.solveMs - busyMs,
+                                     trace.getTotalMs(TracePhase::Exchange),
+                                     trace.getTotalMs(TracePhase::Allreduce),
+                                     trace.getTotalMs(TracePhase::Convergence),
+                                     trace.getTotalMs(TracePhase::Wait),
+                                     (double)stats.verticesStolen, (double)stats.verticesGiven};
+    vector<double> rankLoad(rank == 0 ? LOAD_FIELDS * size : 0);
+    MPI_Gather(localLoad, LOAD_FIELDS, MPI_DOUBLE, rankLoad.data(), LOAD_FIELDS, MPI_DOUBLE,
+               0, MPI_COMM_WORLD);
+    int totalStealRequests = 0;
+    MPI_Reduce(&stats.stealRequests, &totalStealRequests, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    // Per-rank state: shard plus slot-sized distances
+    long long localGhosts = shard.getGhostCount(), maxGhosts = 0;
+    long long localBytes = shard.getMemoryBytes() + distances.size() * sizeof(double), maxBytes = 0;
+    long long localCut = shard.getCutEdgeCount(), totalCut = 0;
+    int localOwned = shard.getOwnedCount(), maxOwned = 0;
+    MPI_Reduce(&localCut, &totalCut, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    // Cut edges whose target lives on another host
+    long long localHostCut = 0, totalHostCut = 0;
+    int myHost = topology.getHostOf(rank);
+    for (int e = 0; e < shard.getEdgeCount(); e++) {
+        int target = shard.getTarget(e);
+        localHostCut += (target >= shard.getOwnedCount() && topology.getHostOf(shard.getGhostOwner(target)) != myHost);
+    }
+    MPI_Reduce(&localHostCut, &totalHostCut, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&localOwned, &maxOwned, 1, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&localGhosts, &maxGhosts, 1, MPI_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&localBytes, &maxBytes, 1, MPI_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // Startup cost: slowest shard load and largest peak RSS
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    long long localRss = usage.ru_maxrss, maxRss = 0;  // KB on Linux
+    double maxLoadMs = 0.0;
+    MPI_Reduce(&localRss, &maxRss, 1, MPI_LONG_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&loadMs, &maxLoadMs, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // Timeline: every rank's events are gathered on rank 0 as raw bytes
+    bool traceWritten = true;
+    if (!traceFile.empty()) {
+        const vector<TraceEvent>& events = trace.getEvents();
+        int traceBytes = events.size() * sizeof(TraceEvent);
+        vector<int> byteCounts(size), offsets(size, 0);
+        MPI_Gather(&traceBytes, 1, MPI_INT, byteCounts.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+        vector<TraceEvent> allEvents;
+        if (rank == 0) {
+            for (int r = 1; r < size; r++) {
+                offsets[r] = offsets[r - 1] + byteCounts[r - 1];
+            }
+            allEvents.resize((offsets[size - 1] + byteCounts[size - 1]) / sizeof(TraceEvent));
+        }
+        MPI_Gatherv(events.data(), traceBytes, MPI_BYTE, allEvents.data(), byteCounts.data(),
+                    offsets.data(), MPI_BYTE, 0, MPI_COMM_WORLD);
+        if (rank == 0) {
+            traceWritten = SolverTrace::write(traceFile, traceFormat, allEvents, size);
+        }
+    }
+
     if (rank == 0) {
-        double finalDist = distances[destination];
-        
-        cout << "===========================================\n";
-        cout << "Distributed Dijkstra (BSP Model)\n";
-        cout << "===========================================\n";
-        cout << "Graph Statistics:\n";
-        cout << "  Nodes: " << nodeCount << "\n";
-        cout << "  Edges: " << edgeCount << "\n";
-        cout << "-------------------------------------------\n";
-        cout << "Parallel Configuration:\n";
-        cout << "  Partitioning: Round-Robin\n";
-        cout << "  Processes: " << size << "\n";
-        cout << "  Nodes per process: ~" << (nodeCount / size) << "\n";
-        cout << "-------------------------------------------\n";
-        cout << "Results:\n";
-        cout << "  Source: " << source << "\n";
-        cout << "  Destination: " << destination << "\n";
-        cout << "  Distance: " << finalDist << "\n";
-        cout << "-------------------------------------------\n";
-        cout << "Performance:\n";
-        cout << "  Execution time: " << duration << " ms\n";
-        cout << "  Iterations: " << maxIterations_global << "\n";
-        cout << "  Total edges relaxed: " << totalEdgesRelaxed << "\n";
-        cout << "  Distance updates: " << totalLocalUpdates << "\n";
-        cout << "===========================================\n";
-    }
-    
+        // Batch results may go to stdout, so the report goes to stderr
+        ostream& report = batchMode ? cerr : cout;
+        report << "===========================================\n";
+        switch (mode) {
+            case SolverMode::Delta:
+                report << "Distributed Delta-Stepping (BSP Model)\n";
+                break;
+            case SolverMode::Async:
+                report << "Distributed Dijkstra (Asynchronous Model)\n";
+                break;
+            case SolverMode::Pipelined:
+                report << "Distributed Dijkstra (Pipelined BSP Model)\n";
+                break;
+            default:
+                report << "Distributed Dijkstra (BSP Model)\n";
+        }
+        report << "===========================================\n";
+        report << "Graph Statistics:\n";
+        report << "  Nodes: " << nodeCount << "\n";
+        report << "  Edges: " << edgeCount << "\n";
+        if (WeightTraits<Weight>::TYPE != WeightType::Float64) {
+            report << "  Weights: " << getWeightTypeName(WeightTraits<Weight>::TYPE) << "\n";
+        }
+        report << "-------------------------------------------\n";
+        report << "Parallel Configuration:\n";
+        report << "  Partitioning: " << (partitionFile.empty() ? schemeName : partitionFile) << "\n";
+        report << "  Processes: " << size << "\n";
+        report << "  Threads per process: " << threadCount << "\n";
+        report << "  Relaxation kernel: " << getSimdLevelName(simdLevel) << "\n";
+        report << "  Nodes per process: ~" << (nodeCount / size) << "\n";
+        report << "  Edge cut: " << totalCut << " (" << (edgeCount > 0 ? 100.0 * totalCut / edgeCount : 0.0) << "%)\n";
+        report << "  Hosts: " << topology.getHostCount() << " (max " << topology.getMaxHostSize()
+               << " processes per host), collectives: " << (topology.isHierarchical() ? "hierarchical" : "flat") << "\n";
+        if (topology.getHostCount() > 1) {
+            report << "  Cross-host cut: " << totalHostCut << " ("
+                   << (edgeCount > 0 ? 100.0 * totalHostCut / edgeCount : 0.0) << "%)\n";
+        }
+        if (partition.getScheme() == PartitionScheme::Explicit) {
+            report << "  Owner table: " << partition.getOwnerTableBytes() / 1024 << " KB per host (shared)\n";
+        }
+        report << "  Imbalance: " << (double)maxOwned * size / max(nodeCount, 1) << "\n";
+        report << "  Ghost nodes per process: " << maxGhosts << " (max)\n";
+        report << "  State per process: " << maxBytes / 1024 << " KB (max)\n";
+        report << "  Shard load time: " << maxLoadMs << " ms (max)\n";
+        report << "  Peak RSS per process: " << maxRss << " KB (max)\n";
+        if (mode == SolverMode::Delta) {
+            report << "  Delta: " << delta << "\n";
+        }
+        report << "-------------------------------------------\n";
+        if (oneToAll) {
+            report << "Results:\n";
+            report << "  Sources: " << sources.size() << "\n";
+            report << "  Reached: " << reachedNodes << " of " << nodeCount << " nodes\n";
+            report << "  Max distance: " << maxDistance << "\n";
+            if (!updateFile.empty()) {
+                double repairMs = 0.0;
+                for (size_t b = 0; b < repairs.size(); b++) {
+                    const RepairReport& repair = repairs[b];
+                    repairMs += repair.repairMs;
+                    report << "  Batch " << b + 1 << ": " << updateBatches[b].size() << " updates, "
+                           << repair.edgesChanged << " edges changed, " << repair.affected << " affected, "
+                           << repair.seeds << " seeds, " << repair.rounds << " invalidation rounds, "
+                           << repair.edgesRelaxed << " edges relaxed, " << repair.repairMs << " ms\n";
+                }
+                report << "  Repair time: " << repairMs << " ms for " << repairs.size() << " batch(es)\n";
+                if (verifyUpdates) {
+                    report << "  Full recompute: " << fullRecomputeMs << " ms; " << mismatches
+                           << " mismatching nodes\n";
+                }
+            }
+            if (!distanceFile.empty()) {
+                report << "  Distances: " << distanceFile << " (" << getDistanceEncodingName(distanceEncoding)
+                       << ", " << (distanceIO == DistanceIO::Gather ? "gathered" : "parallel MPI-IO")
+                       << ", " << distanceWriteMs << " ms)\n";
+                if (distanceEncoding == DistanceEncoding::Fixed32) {
+                    report << "  Fixed-point scale: " << distanceScale << "\n";
+                }
+            }
+            report << "-------------------------------------------\n";
+        } else if (!batchMode) {
+            report << "Results:\n";
+            report << "  Source: " << source << "\n";
+            report << "  Destination: " << destination << "\n";
+            report << "  Distance: " << finalDist << "\n";
+            report << "-------------------------------------------\n";
+        }
+        report << "Performance:\n";
+        report << "  Execution time: " << duration << " ms\n";
+        if (repeatCount > 1) {
+            report << "  Measured passes: " << passTimes.samples << " (median "
+                   << passTimes.median / 1000.0 << " ms, min " << passTimes.min / 1000.0
+                   << " ms, stddev " << passTimes.stddev / 1000.0 << " ms)\n";
+        }
+        report << "  Iterations: " << maxIterations_global << "\n";
+        if (mode == SolverMode::Delta) {
+            report << "  Buckets processed: " << stats.buckets << "\n";
+        }
+        if (mode == SolverMode::Async) {
+            report << "  Termination rounds: " << stats.tokenRounds << "\n";
+        }
+        report << "  Total edges relaxed: " << totalEdgesRelaxed << "\n";
+        report << "  Distance updates: " << totalLocalUpdates << "\n";
+        report << "  Updates exchanged: " << traffic.updatesSent << "\n";
+        report << "  Messages sent: " << traffic.messagesSent << " (" << traffic.bytesSent / 1024 << " KB)\n";
+        report << "  Coalescing ratio: " << traffic.coalescingRatio() << "\n";
+        if (mode == SolverMode::Async) {
+            report << "  Send stalls: " << traffic.sendStalls << "\n";
+        }
+        if (stealing) {
+            report << "  Steal requests: " << totalStealRequests << "\n";
+        }
+        if (!checkpointPrefix.empty()) {
+            report << "  Checkpoints: " << checkpointWriter.getWrittenCount() << " (every " << checkpointInterval
+                   << " supersteps, " << checkpointStallMs << " ms stalled max)\n";
+        }
+        if (resumed) {
+            report << "  Resumed from checkpoint " << resumeState.sequence << " (query " << resumeState.query
+                   << ", superstep " << resumeState.iterations << ")\n";
+        }
+        report << "-------------------------------------------\n";
+        report << "Load per process (ms; idle = exchange + allreduce + convergence + wait + other):\n";
+        report << "  Rank      Busy      Idle  Exchange Allreduce  Converge      Wait   Stolen    Given\n";
+        double maxBusy = 0.0, sumBusy = 0.0;
+        for (int r = 0; r < size; r++) {
+            const double* load = &rankLoad[LOAD_FIELDS * r];
+            report << "  " << setw(4) << r << fixed << setprecision(1);
+            for (int f = 0; f < 6; f++) {
+                report << setw(10) << load[f];
+            }
+            report << setw(9) << (long long)load[6] << setw(9) << (long long)load[7] << "\n";
+            report.unsetf(ios::floatfield);
+            report << setprecision(6);
+            maxBusy = max(maxBusy, load[0]);
+            sumBusy += load[0];
+        }
+        double busyImbalance = sumBusy > 0.0 ? maxBusy * size / sumBusy : 1.0;
+        report << "  Busy imbalance (max/mean): " << busyImbalance << "\n";
+        if (!traceFile.empty() && traceWritten) {
+            report << "  Trace: " << traceFile << " (" << (traceFormat == TraceFormat::CSV ? "csv" : "chrome") << ")\n";
+        }
+        report << "===========================================\n";
+        if (batchMode) {
+            double wallMs = duration_cast<microseconds>(endTime - startTime).count() / 1000.0;
+            LatencySummary::compute(latencies, wallMs).print();
+        }
+
+        if (!jsonFile.empty()) {
+            BenchmarkResult result;
+            if (!resultName.empty()) {
+                result.implementation = resultName;
+            } else {
+                result.implementation = (mode == SolverMode::Delta) ? "Distributed-Delta"
+                                      : (mode == SolverMode::Async) ? "Distributed-Async"
+                                      : (mode == SolverMode::Pipelined) ? "Distributed-Pipelined" : "Distributed";
+                if (stealing) {
+                    result.implementation += "-Steal";
+                }
+            }
+            result.processes = size;
+            result.threads = threadCount;
+            result.timeUs = passTimes;
+            result.addMetric("per_query_us", passTimes.median / max(queryCount, 1));
+            result.addMetric("iterations", maxIterations_global);
+            result.addMetric("edges_relaxed", totalEdgesRelaxed);
+            result.addMetric("distance_updates", totalLocalUpdates);
+            result.addMetric("updates_exchanged", traffic.updatesSent);
+            result.addMetric("messages_sent", traffic.messagesSent);
+            result.addMetric("bytes_sent", traffic.bytesSent);
+            result.addMetric("busy_imbalance", busyImbalance);
+            result.addMetric("simd_lanes", getSimdLevelLanes(simdLevel));
+            result.addMetric("hosts", topology.getHostCount());
+            result.addMetric("cross_host_cut", totalHostCut);
+            if (!checkpointPrefix.empty()) {
+                result.addMetric("checkpoints_written", checkpointWriter.getWrittenCount());
+                result.addMetric("checkpoint_stall_ms", checkpointStallMs);
+            }
+            if (oneToAll) {
+                result.addMetric("reached_nodes", reachedNodes);
+                result.addMetric("max_distance", maxDistance);
+                if (!distanceFile.empty()) {
+                    result.addMetric("distance_write_ms", distanceWriteMs);
+                }
+            } else if (!batchMode) {
+                result.addMetric("distance", finalDist);
+            }
+            BenchmarkReport benchmark(runLabel, graphFile, nodeCount, edgeCount, queryCount, -1,
+                                      warmupCount, repeatCount);
+            benchmark.add(result);
+            if (benchmark.write(jsonFile)) {
+                report << "Results written to " << jsonFile << "\n";
+            }
+        }
+    }
+
     MPI_Finalize();
-    return 0;
+    return mismatches == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    // Only the main thread calls MPI; relaxation threads never do
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // The weight type fixes the shard type, so it is picked before the
+    // rest of the command line is parsed
+    WeightType weightType = WeightType::Float64;
+    for (int i = 4; i + 1 < argc; i++) {
+        if (string(argv[i]) == "--weights" && !parseWeightType(argv[i + 1], weightType)) {
+            if (rank == 0) {
+                cerr << "Error: Unknown weight type " << argv[i + 1] << "\n";
+            }
+            MPI_Finalize();
+            return 1;
+        }
+    }
+
+    switch (weightType) {
+        case WeightType::Float32:
+            return runSolver<float>(argc, argv, rank, size);
+        case WeightType::UInt32:
+            return runSolver<uint32_t>(argc, argv, rank, size);
+        default:
+            return runSolver<double>(argc, argv, rank, size);
+    }
 }
@@ -1,119 +1,97 @@
-#include "../include/Graph.h"
+#include "../include/CSRGraph.h"
+#include "../include/GraphGenerator.h"
+#include "../include/NodeOrdering.h"
 #include <iostream>
 #include <random>
-#include <ctime>
+#include <chrono>
+#include <thread>
 #include <cstring>
+#include <vector>
+#include <type_traits>
 
 using namespace std;
 
-// Generate a random connected graph
-void generateRandomGraph(
-    int numNodes,
-    int numEdges,
-    const string& filename,
-    double minWeight = 1.0,
-    double maxWeight = 100.0
-) {
-    Graph graph(numNodes);
-    
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_real_distribution<> weightDist(minWeight, maxWeight);
-    uniform_real_distribution<> coordDist(0.0, 1000.0);
-    uniform_int_distribution<> nodeDist(0, numNodes - 1);
-    
-    // Assign random coordinates to all nodes (for A* heuristic)
-    for (int i = 0; i < numNodes; i++) {
-        double x = coordDist(gen);
-        double y = coordDist(gen);
-        graph.setNodeCoordinates(i, x, y);
+// True if the output path selects the binary CSR format
+bool isBinaryOutput(const string& filename) {
+    return filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".bin") == 0;
+}
+
+// Convert an existing graph file (text or binary) to the format selected
+// by the output extension. Binary output uses Graph's layout and may be
+// renumbered; text output is always written in the original node IDs.
+template <typename Graph>
+bool convertGraph(const string& inputFile, const string& outputFile, NodeOrder reorder) {
+    if (reorder != NodeOrder::Identity && !isBinaryOutput(outputFile)) {
+        cerr << "Error: --reorder needs binary (.bin) output, which keeps the original IDs\n";
+        return false;
     }
-    
-    // First, create a connected graph (spanning tree)
-    cout << "Creating connected graph backbone...\n";
-    for (int i = 1; i < numNodes; i++) {
-        int parent = nodeDist(gen) % i;  // Connect to a previous node
-        double weight = weightDist(gen);
-        graph.addBidirectionalEdge(parent, i, weight);
+    Graph graph;
+    if (!graph.loadFromFile(inputFile)) {
+        return false;
     }
-    
-    // Add remaining edges randomly
-    int edgesAdded = numNodes - 1;  // Already added spanning tree edges
-    int attempts = 0;
-    int maxAttempts = numEdges * 10;
-    
-    cout << "Adding additional edges...\n";
-    while (edgesAdded < numEdges && attempts < maxAttempts) {
-        int from = nodeDist(gen);
-        int to = nodeDist(gen);
-        
-        // Avoid self-loops
-        if (from != to) {
-            double weight = weightDist(gen);
-            graph.addBidirectionalEdge(from, to, weight);
-            edgesAdded += 2;  // Bidirectional adds 2 edges
+
+    if (reorder != NodeOrder::Identity) {
+        auto start = chrono::steady_clock::now();
+        vector<int> order;
+        if (!NodeOrdering::compute(graph, reorder, order)) {
+            return false;
         }
-        
-        attempts++;
-    }
-    
-    // Save to file
-    cout << "Saving graph to " << filename << "...\n";
-    if (graph.saveToFile(filename)) {
-        cout << "✓ Graph generated successfully!\n";
-        graph.printInfo();
-    } else {
-        cerr << "✗ Error saving graph to file!\n";
+        double spanBefore = NodeOrdering::averageEdgeSpan(graph);
+        graph = graph.permute(order);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cout << "Reordered nodes (" << getNodeOrderName(reorder) << ") in " << ms
+             << " ms; mean edge span " << spanBefore << " -> " << NodeOrdering::averageEdgeSpan(graph) << "\n";
     }
-}
 
-// Generate a grid graph (useful for testing)
-void generateGridGraph(
-    int rows,
-    int cols,
-    const string& filename,
-    double edgeWeight = 1.0
-) {
-    int numNodes = rows * cols;
-    Graph graph(numNodes);
-    
-    cout << "Generating " << rows << "x" << cols << " grid graph...\n";
-    
-    // Assign grid coordinates
-    for (int r = 0; r < rows; r++) {
-        for (int c = 0; c < cols; c++) {
-            int nodeId = r * cols + c;
-            graph.setNodeCoordinates(nodeId, c * 10.0, r * 10.0);
+    cout << "Converting " << inputFile << " -> " << outputFile << "...\n";
+    if (isBinaryOutput(outputFile)) {
+        if (!graph.saveBinaryFile(outputFile)) {
+            return false;
         }
-    }
-    
-    // Add edges (4-connected grid)
-    for (int r = 0; r < rows; r++) {
-        for (int c = 0; c < cols; c++) {
-            int nodeId = r * cols + c;
-            
-            // Right neighbor
-            if (c < cols - 1) {
-                int neighbor = r * cols + (c + 1);
-                graph.addBidirectionalEdge(nodeId, neighbor, edgeWeight);
-            }
-            
-            // Bottom neighbor
-            if (r < rows - 1) {
-                int neighbor = (r + 1) * cols + c;
-                graph.addBidirectionalEdge(nodeId, neighbor, edgeWeight);
+    } else {
+        ofstream file(outputFile);
+        if (!file.is_open()) {
+            cerr << "Error: Cannot create file " << outputFile << endl;
+            return false;
+        }
+        file << graph.getNodeCount() << " " << graph.getEdgeCount() << "\n";
+        for (int u = 0; u < graph.getNodeCount(); u++) {
+            for (auto e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++) {
+                file << graph.getOriginalId(u) << " " << graph.getOriginalId(graph.getTarget(e))
+                     << " " << graph.getWeight(e) << "\n";
             }
         }
     }
-    
-    // Save to file
-    cout << "Saving grid graph to " << filename << "...\n";
-    if (graph.saveToFile(filename)) {
-        cout << "✓ Grid graph generated successfully!\n";
-        graph.printInfo();
-    } else {
+
+    cout << "✓ Conversion complete!\n";
+    graph.printInfo();
+    return true;
+}
+
+// Generate a model's graph and stream it to the output file
+bool generateGraph(GraphModel& model, const string& filename, int threads) {
+    auto start = chrono::steady_clock::now();
+    model.prepare(threads);
+
+    cout << "Saving graph to " << filename << "...\n";
+    long long edgeCount = 0;
+    bool ok = isBinaryOutput(filename)
+        ? writeBinaryGraph(model, filename, threads, edgeCount)
+        : writeTextGraph(model, filename, threads, edgeCount);
+    if (!ok) {
         cerr << "✗ Error saving graph to file!\n";
+        return false;
     }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    int nodeCount = model.getNodeCount();
+    cout << "✓ Graph generated successfully!\n";
+    cout << "Graph Info:\n";
+    cout << "  Nodes: " << nodeCount << "\n";
+    cout << "  Edges: " << edgeCount << "\n";
+    cout << "  Avg degree: " << (nodeCount > 0 ? (double)edgeCount / nodeCount : 0) << "\n";
+    cout << "  Time: " << seconds << " s (" << threads << " threads)\n";
+    return true;
 }
 
 // Print usage information
@@ -122,14 +100,105 @@ void printUsage(const char* programName) {
     cout << "Usage:\n";
     cout << "  Random graph: " << programName << " <nodes> <edges> <output_file> [min_weight] [max_weight]\n";
     cout << "  Grid graph:   " << programName << " --grid <rows> <cols> <output_file> [edge_weight]\n";
+    cout << "  R-MAT graph:  " << programName << " --rmat <scale> <edge_factor> <output_file> [min_weight] [max_weight]\n";
+    cout << "  k-NN graph:   " << programName << " --knn <nodes> <k> <output_file> [max_detour]\n";
+    cout << "  Convert:      " << programName << " --convert <input_file> <output_file>\n";
+    cout << "\nOptions (anywhere on the command line):\n";
+    cout << "  --seed <s>            Random seed; without it a fresh seed is drawn and printed\n";
+    cout << "  --threads <t>         Generator threads (default: hardware threads)\n";
+    cout << "  --rmat-probs a,b,c    R-MAT quadrant probabilities (default 0.57,0.19,0.19)\n";
+    cout << "  --weights <type>      Convert: binary weight type double (default), float,\n";
+    cout << "                        or uint32 (integral weights only)\n";
+    cout << "  --edge-index 32|64    Convert: binary edge index width (default: 32)\n";
+    cout << "  --reorder <order>     Convert: renumber nodes for locality, bfs, rcm (reverse\n";
+    cout << "                        Cuthill-McKee) or hilbert (needs coordinates). The file\n";
+    cout << "                        keeps the original IDs, which all tools accept and print.\n";
+    cout << "\nModels:\n";
+    cout << "  random  Connected: random spanning tree plus uniform random edges\n";
+    cout << "  grid    4-connected grid\n";
+    cout << "  rmat    2^scale nodes, edge_factor * 2^scale edges, skewed degrees (Graph500)\n";
+    cout << "  knn     Road-like: random points joined to their k nearest neighbours,\n";
+    cout << "          weight = length * detour factor in [1, max_detour) (default 1.5)\n";
+    cout << "All edges are written in both directions. The same seed gives the same\n";
+    cout << "file for any thread count. Output is streamed, so graphs much larger\n";
+    cout << "than memory-resident edge lists can be generated.\n";
+    cout << "\nOutput files ending in .bin are written in the binary CSR format\n";
+    cout << "(memory-mappable, loaded directly by sequential and distributed).\n";
     cout << "\nExamples:\n";
     cout << "  " << programName << " 1000 5000 data/synthetic/graph_1000.txt\n";
     cout << "  " << programName << " 1000 5000 data/synthetic/graph_1000.txt 1.0 100.0\n";
+    cout << "  " << programName << " 1000 5000 data/synthetic/graph_1000.txt --seed 42\n";
     cout << "  " << programName << " --grid 50 50 data/synthetic/grid_50x50.txt\n";
     cout << "  " << programName << " --grid 50 50 data/synthetic/grid_50x50.txt 2.5\n";
+    cout << "  " << programName << " --rmat 20 16 data/synthetic/rmat_20.bin --seed 1 --threads 8\n";
+    cout << "  " << programName << " --knn 10000000 6 data/synthetic/knn_10m.bin --seed 1\n";
+    cout << "  " << programName << " 1000 5000 data/synthetic/graph_1000.bin\n";
+    cout << "  " << programName << " --convert data/graph_15000.txt data/graph_15000.bin\n";
+    cout << "  " << programName << " --convert data/road.txt data/road.bin --weights uint32\n";
+    cout << "  " << programName << " --convert data/road.bin data/road_rcm.bin --reorder rcm\n";
+}
+
+// Print the common part of the generation banner
+void printBanner(const string& model, const string& filename, int threads) {
+    cout << "===========================================\n";
+    cout << "Graph Generator\n";
+    cout << "===========================================\n";
+    cout << "Model:       " << model << "\n";
+    cout << "Output:      " << filename << "\n";
+    cout << "Threads:     " << threads << "\n";
 }
 
 int main(int argc, char* argv[]) {
+    // Options may appear anywhere; the remaining arguments are positional
+    bool seeded = false;
+    unsigned seed = 0;
+    int threads = max(1u, thread::hardware_concurrency());
+    double rmatA = 0.57, rmatB = 0.19, rmatC = 0.19;
+    EdgeIndexType indexType = EdgeIndexType::Int32;
+    WeightType weightType = WeightType::Float64;
+    NodeOrder reorder = NodeOrder::Identity;
+    vector<char*> args;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], nullptr, 10);
+            seeded = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+            if (threads <= 0) {
+                cerr << "Error: --threads must be positive\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--rmat-probs") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%lf,%lf,%lf", &rmatA, &rmatB, &rmatC) != 3 ||
+                rmatA < 0 || rmatB < 0 || rmatC < 0 || rmatA + rmatB + rmatC > 1.0) {
+                cerr << "Error: --rmat-probs expects a,b,c with a + b + c <= 1\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--weights") == 0 && i + 1 < argc) {
+            if (!parseWeightType(argv[++i], weightType)) {
+                cerr << "Error: Unknown weight type " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--reorder") == 0 && i + 1 < argc) {
+            if (!parseNodeOrder(argv[++i], reorder)) {
+                cerr << "Error: Unknown node order " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--edge-index") == 0 && i + 1 < argc) {
+            if (!parseEdgeIndexType(argv[++i], indexType)) {
+                cerr << "Error: Unknown edge index width " << argv[i] << "\n";
+                return 1;
+            }
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    argc = args.size();
+    argv = args.data();
+    if (!seeded) {
+        seed = random_device()();
+    }
+
     // Check for help flag
     if (argc < 2 || strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-h") == 0) {
         printUsage(argv[0]);
@@ -149,13 +218,97 @@ int main(int argc, char* argv[]) {
         string filename = argv[4];
         double edgeWeight = (argc >= 6) ? atof(argv[5]) : 1.0;
         
-        if (rows <= 0 || cols <= 0) {
+        if (rows <= 0 || cols <= 0 || (long long)rows * cols > numeric_limits<int>::max()) {
             cerr << "Error: Invalid grid dimensions\n";
             return 1;
         }
         
-        generateGridGraph(rows, cols, filename, edgeWeight);
-        return 0;
+        printBanner("grid", filename, threads);
+        cout << "Grid:        " << rows << "x" << cols << "\n";
+        cout << "===========================================\n\n";
+        GridGraphModel model(rows, cols, edgeWeight);
+        return generateGraph(model, filename, threads) ? 0 : 1;
+    }
+
+    // R-MAT / Kronecker graph generation
+    if (strcmp(argv[1], "--rmat") == 0) {
+        if (argc < 5) {
+            cerr << "Error: R-MAT graph requires <scale> <edge_factor> <output_file>\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        int scale = atoi(argv[2]);
+        int edgeFactor = atoi(argv[3]);
+        string filename = argv[4];
+        double minWeight = (argc >= 6) ? atof(argv[5]) : 1.0;
+        double maxWeight = (argc >= 7) ? atof(argv[6]) : 100.0;
+
+        if (scale <= 0 || scale > 30 || edgeFactor <= 0) {
+            cerr << "Error: R-MAT needs 1 <= scale <= 30 and a positive edge factor\n";
+            return 1;
+        }
+        if (minWeight >= maxWeight) {
+            cerr << "Error: min_weight must be less than max_weight\n";
+            return 1;
+        }
+
+        printBanner("rmat", filename, threads);
+        cout << "Nodes:       " << (1LL << scale) << " (scale " << scale << ")\n";
+        cout << "Edges:       " << ((long long)edgeFactor << scale) << " x 2 directions\n";
+        cout << "Quadrants:   a=" << rmatA << " b=" << rmatB << " c=" << rmatC
+             << " d=" << 1.0 - rmatA - rmatB - rmatC << "\n";
+        cout << "Weight range: [" << minWeight << ", " << maxWeight << "]\n";
+        cout << "Seed:        " << seed << "\n";
+        cout << "===========================================\n\n";
+        RmatGraphModel model(scale, edgeFactor, seed, rmatA, rmatB, rmatC, minWeight, maxWeight);
+        return generateGraph(model, filename, threads) ? 0 : 1;
+    }
+
+    // Geometric k-nearest-neighbour graph generation
+    if (strcmp(argv[1], "--knn") == 0) {
+        if (argc < 5) {
+            cerr << "Error: k-NN graph requires <nodes> <k> <output_file>\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        int numNodes = atoi(argv[2]);
+        int k = atoi(argv[3]);
+        string filename = argv[4];
+        double maxDetour = (argc >= 6) ? atof(argv[5]) : 1.5;
+
+        if (numNodes <= 1 || k <= 0) {
+            cerr << "Error: k-NN graph needs at least 2 nodes and a positive k\n";
+            return 1;
+        }
+        if (maxDetour < 1.0) {
+            cerr << "Error: max_detour must be at least 1\n";
+            return 1;
+        }
+
+        printBanner("knn", filename, threads);
+        cout << "Nodes:       " << numNodes << "\n";
+        cout << "Neighbours:  " << k << "\n";
+        cout << "Max detour:  " << maxDetour << "\n";
+        cout << "Seed:        " << seed << "\n";
+        cout << "===========================================\n\n";
+        KnnGraphModel model(numNodes, k, seed, maxDetour);
+        return generateGraph(model, filename, threads) ? 0 : 1;
+    }
+    
+    // Format conversion
+    if (strcmp(argv[1], "--convert") == 0) {
+        if (argc < 4) {
+            cerr << "Error: Convert requires <input_file> <output_file>\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        bool ok = withGraphLayout(indexType, weightType, [&](auto* graphType) {
+            return convertGraph<remove_pointer_t<decltype(graphType)>>(argv[2], argv[3], reorder);
+        });
+        return ok ? 0 : 1;
     }
     
     // Random graph generation
@@ -166,7 +319,7 @@ int main(int argc, char* argv[]) {
     }
     
     int numNodes = atoi(argv[1]);
-    int numEdges = atoi(argv[2]);
+    long long numEdges = atoll(argv[2]);
     string filename = argv[3];
     double minWeight = (argc >= 5) ? atof(argv[4]) : 1.0;
     double maxWeight = (argc >= 6) ? atof(argv[5]) : 100.0;
@@ -182,7 +335,7 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
-    int maxPossibleEdges = numNodes * (numNodes - 1);  // Directed edges
+    long long maxPossibleEdges = (long long)numNodes * (numNodes - 1);  // Directed edges
     if (numEdges > maxPossibleEdges) {
         cerr << "Warning: Number of edges exceeds maximum possible. Using maximum.\n";
         numEdges = maxPossibleEdges;
@@ -194,16 +347,17 @@ int main(int argc, char* argv[]) {
     }
     
     // Generate the graph
-    cout << "===========================================\n";
-    cout << "Graph Generator\n";
-    cout << "===========================================\n";
+    printBanner("random", filename, threads);
     cout << "Nodes:       " << numNodes << "\n";
     cout << "Edges:       " << numEdges << "\n";
-    cout << "Output:      " << filename << "\n";
     cout << "Weight range: [" << minWeight << ", " << maxWeight << "]\n";
+    cout << "Seed:        " << seed << "\n";
     cout << "===========================================\n\n";
     
-    generateRandomGraph(numNodes, numEdges, filename, minWeight, maxWeight);
+    RandomGraphModel model(numNodes, numEdges, seed, minWeight, maxWeight);
+    if (!generateGraph(model, filename, threads)) {
+        return 1;
+    }
     
     cout << "\n===========================================\n";
     cout << "Generation complete!\n";
@@ -0,0 +1,151 @@
+#include "../include/Dijkstra.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+
+using namespace std;
+
+// Per-method totals over the verification queries
+struct MethodTotals {
+    double ms = 0.0;
+    long long settled = 0;
+    int mismatches = 0;
+};
+
+// Compare landmark A* and Euclidean A* against plain Dijkstra on random pairs
+bool verifyLandmarks(const CSRGraph& graph, const LandmarkSet& landmarks, int queryCount) {
+    mt19937 rng(7);
+    uniform_int_distribution<int> pick(0, graph.getNodeCount() - 1);
+
+    SearchSpace<BinaryHeapQueue> space;
+    MethodTotals dijkstra, euclidean, alt;
+    EuclideanHeuristic euclideanHeuristic{graph};
+    LandmarkHeuristic landmarkHeuristic{landmarks};
+
+    auto record = [](MethodTotals& totals, const PathResult& expected, const PathResult& actual,
+                     chrono::high_resolution_clock::time_point start) {
+        totals.ms += chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+        totals.settled += actual.stats.nodesSettled;
+        bool same = expected.found == actual.found &&
+                    (!expected.found || sameDistance(expected.totalDistance, actual.totalDistance));
+        if (!same) {
+            totals.mismatches++;
+        }
+        return same;
+    };
+
+    for (int i = 0; i < queryCount; i++) {
+        int source = pick(rng);
+        int destination = pick(rng);
+
+        auto start = chrono::high_resolution_clock::now();
+        PathResult expected = sequentialDijkstra(graph, space, source, destination);
+        record(dijkstra, expected, expected, start);
+
+        start = chrono::high_resolution_clock::now();
+        PathResult result = sequentialAStarDijkstra(graph, space, source, destination, euclideanHeuristic);
+        record(euclidean, expected, result, start);
+
+        start = chrono::high_resolution_clock::now();
+        result = sequentialAStarDijkstra(graph, space, source, destination, landmarkHeuristic);
+        if (!record(alt, expected, result, start) && alt.mismatches <= 5) {
+            cerr << "Mismatch " << source << " -> " << destination << ": Dijkstra "
+                 << expected.totalDistance << ", ALT " << result.totalDistance << "\n";
+        }
+    }
+
+    cout << "-------------------------------------------\n";
+    cout << "Verification (" << queryCount << " random queries):\n";
+    auto print = [&](const char* name, const MethodTotals& totals) {
+        cout << "  " << name << totals.ms / queryCount << " ms/query, "
+             << totals.settled / queryCount << " nodes settled, "
+             << totals.mismatches << " wrong distances\n";
+    };
+    print("Dijkstra:     ", dijkstra);
+    print("Euclidean A*: ", euclidean);
+    print("Landmark A*:  ", alt);
+    if (alt.ms > 0.0) {
+        cout << "  Speedup over Dijkstra: " << dijkstra.ms / alt.ms << "x\n";
+    }
+    return alt.mismatches == 0;
+}
+
+void printUsage(const char* programName) {
+    cout << "Landmark Preprocess - Precompute ALT lower bounds for A*\n\n";
+    cout << "Usage:\n";
+    cout << "  " << programName << " <graph_file> <output_file> [options]\n";
+    cout << "\nArguments:\n";
+    cout << "  graph_file    - Path to graph data file (text or binary)\n";
+    cout << "  output_file   - Landmark file for sequential/query_server --landmarks\n";
+    cout << "  --count <k>   - Number of landmarks (default: 16)\n";
+    cout << "  --seed <s>    - Seed for the first landmark (default: 1)\n";
+    cout << "  --verify <n>  - Check n random queries against Dijkstra\n";
+    cout << "\nExample:\n";
+    cout << "  " << programName << " data/graph_15000.txt data/graph_15000.lm --verify 200\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    string graphFile = argv[1];
+    string outputFile = argv[2];
+    int count = 16;
+    unsigned seed = 1;
+    int verifyCount = 0;
+    for (int i = 3; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--count" && i + 1 < argc) {
+            count = atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--verify" && i + 1 < argc) {
+            verifyCount = atoi(argv[++i]);
+        } else {
+            cerr << "Error: Unknown option " << arg << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (count <= 0) {
+        cerr << "Error: --count must be positive\n";
+        return 1;
+    }
+
+    CSRGraph graph;
+    if (!graph.loadFromFile(graphFile)) {
+        cerr << "Error: Failed to load graph file\n";
+        return 1;
+    }
+
+    cout << "===========================================\n";
+    cout << "Landmark Preprocessing\n";
+    cout << "===========================================\n";
+    graph.printInfo();
+
+    auto start = chrono::high_resolution_clock::now();
+    LandmarkSet landmarks = LandmarkSet::build(graph, count, seed);
+    double buildMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+
+    cout << "-------------------------------------------\n";
+    landmarks.printInfo();
+    cout << "  Build time: " << buildMs << " ms\n";
+
+    if (!landmarks.saveToFile(outputFile)) {
+        return 1;
+    }
+    cout << "✓ Landmarks written to " << outputFile << "\n";
+
+    bool ok = true;
+    if (verifyCount > 0) {
+        ok = verifyLandmarks(graph, landmarks, verifyCount);
+    }
+    cout << "===========================================\n";
+
+    return ok ? 0 : 1;
+}
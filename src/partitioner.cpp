@@ -0,0 +1,142 @@
+#include "../include/CSRGraph.h"
+#include "../include/Partitioner.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+
+using namespace std;
+
+// Owner table for a named scheme
+vector<int> computeOwners(const CSRGraph& graph, const string& scheme, int parts) {
+    if (scheme == "bfs") {
+        return Partitioner::getBFSPartition(graph, parts);
+    }
+    if (scheme == "coordinate") {
+        return Partitioner::getCoordinatePartition(graph, parts);
+    }
+    PartitionScheme arithmetic = (scheme == "contiguous")
+        ? PartitionScheme::Contiguous : PartitionScheme::RoundRobin;
+    return PartitionMap(arithmetic, graph.getNodeCount(), parts).getOwnerArray();
+}
+
+// Print quality and per-part boundary statistics for one scheme
+void reportScheme(const CSRGraph& graph, const string& scheme, const vector<int>& owners,
+                  int parts, int ranksPerHost, double elapsedMs) {
+    cout << "-------------------------------------------\n";
+    cout << "Scheme: " << scheme << " (" << elapsedMs << " ms)\n";
+    Partitioner::computePartitionStats(graph, owners, parts, ranksPerHost).print();
+
+    PartitionMap partition(owners, parts);
+    cout << "  Per part: owned / boundary / ghosts / cut edges\n";
+    for (int r = 0; r < parts; r++) {
+        BoundaryStats stats;
+        Partitioner::identifyBoundaryNodes(graph, partition.getOwnedNodes(r), r, parts, &stats);
+        cout << "    " << r << ": " << stats.ownedNodes << " / " << stats.boundaryNodes
+             << " / " << stats.remoteNeighbors << " / " << stats.cutEdges << "\n";
+    }
+}
+
+void printUsage(const char* programName) {
+    cout << "Graph Partitioner - Compare partitions and write owner tables\n\n";
+    cout << "Usage:\n";
+    cout << "  " << programName << " <graph_file> <parts> [scheme] [output_file] [options]\n";
+    cout << "\nArguments:\n";
+    cout << "  graph_file    - Path to graph data file (text or binary)\n";
+    cout << "  parts         - Number of parts (MPI processes)\n";
+    cout << "  scheme        - roundrobin, contiguous, bfs, coordinate or all (default: all)\n";
+    cout << "  output_file   - Write the owner table for use with distributed --partition-file\n";
+    cout << "\nOptions:\n";
+    cout << "  --ranks-per-host <k> - Number the parts so that each run of k consecutive ranks\n";
+    cout << "                         (one host when mpirun fills hosts slot by slot) holds\n";
+    cout << "                         heavily connected parts, and report the cross-host cut\n";
+    cout << "\nExample:\n";
+    cout << "  " << programName << " data/graph_15000.txt 4\n";
+    cout << "  " << programName << " data/graph_15000.txt 4 bfs data/graph_15000.4.part\n";
+    cout << "  " << programName << " data/graph_15000.txt 8 bfs data/graph_15000.8.part --ranks-per-host 4\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    vector<string> positional;
+    int ranksPerHost = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--ranks-per-host" && i + 1 < argc) {
+            ranksPerHost = atoi(argv[++i]);
+            if (ranksPerHost <= 0) {
+                cerr << "Error: --ranks-per-host must be positive\n";
+                return 1;
+            }
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    string graphFile = positional[0];
+    int parts = atoi(positional[1].c_str());
+    string scheme = (positional.size() >= 3) ? positional[2] : "all";
+    string outputFile = (positional.size() >= 4) ? positional[3] : "";
+
+    if (parts <= 0) {
+        cerr << "Error: Number of parts must be positive\n";
+        return 1;
+    }
+
+    vector<string> schemes = {"roundrobin", "contiguous", "bfs", "coordinate"};
+    if (scheme != "all") {
+        bool known = false;
+        for (const string& s : schemes) {
+            known = known || (s == scheme);
+        }
+        if (!known) {
+            cerr << "Error: Unknown scheme " << scheme << "\n";
+            return 1;
+        }
+        schemes = {scheme};
+    } else if (!outputFile.empty()) {
+        cerr << "Error: Choose a single scheme when writing an owner table\n";
+        return 1;
+    }
+
+    CSRGraph graph;
+    if (!graph.loadFromFile(graphFile)) {
+        cerr << "Error: Failed to load graph file\n";
+        return 1;
+    }
+
+    cout << "===========================================\n";
+    cout << "Graph Partitioner\n";
+    cout << "===========================================\n";
+    graph.printInfo();
+
+    for (const string& s : schemes) {
+        auto start = chrono::high_resolution_clock::now();
+        vector<int> owners = computeOwners(graph, s, parts);
+        if (ranksPerHost > 0 && ranksPerHost < parts) {
+            owners = Partitioner::groupPartsByHost(graph, owners, parts, ranksPerHost);
+        }
+        double elapsed = chrono::duration<double, milli>(
+            chrono::high_resolution_clock::now() - start).count();
+
+        reportScheme(graph, s, owners, parts, ranksPerHost, elapsed);
+
+        if (!outputFile.empty()) {
+            if (!Partitioner::savePartition(outputFile, owners, parts)) {
+                return 1;
+            }
+            cout << "✓ Owner table written to " << outputFile << "\n";
+        }
+    }
+    cout << "===========================================\n";
+
+    return 0;
+}
@@ -0,0 +1,341 @@
+#include "../include/QueryEngine.h"
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+// Server configuration from the command line
+struct ServerOptions {
+    SearchOptions search;
+    int threads = 1;
+    string queryFile = "-";
+    string outputFile = "-";
+    ResultFormat format = ResultFormat::CSV;
+    vector<int> scaling;  // Thread counts to compare, empty = serve once
+    int repeat = 1;       // Passes over the query set in scaling mode
+    int cacheTrees = 0;   // Shortest-path trees kept for repeated sources, 0 = off
+};
+
+// Serve a query stream with a fixed pool, writing results as they finish.
+// Rows are written in completion order; the query column gives the input
+// position.
+template <typename Queue>
+int serveQueries(const CSRGraph& graph, const CSRGraph* reverse, const ServerOptions& options) {
+    QueryReader reader;
+    QueryResultWriter writer;
+    if (!reader.open(options.queryFile) || !writer.open(options.outputFile, options.format)) {
+        return 1;
+    }
+
+    mutex outputMutex;
+    vector<double> latencies;
+    auto handler = [&](int index, const Query& query, const PathResult& result, double latencyUs) {
+        int hops = result.found ? (int)result.path.size() - 1 : -1;
+        lock_guard<mutex> lock(outputMutex);
+        latencies.push_back(latencyUs);
+        writer.write(index, query, result.totalDistance, hops, latencyUs);
+    };
+
+    int nodeCount = graph.getNodeCount();
+    auto start = chrono::high_resolution_clock::now();
+
+    // One cache for all workers, so a tree built by one serves the others
+    PathTreeCache treeCache(options.cacheTrees);
+    SearchOptions search = options.search;
+    if (options.cacheTrees > 0) {
+        search.treeCache = &treeCache;
+    }
+    QueryEngine<Queue> engine(graph, reverse, search, options.threads, handler);
+    Query query;
+    int index = 0;
+    while (reader.next(query)) {
+        if (query.source < 0 || query.source >= nodeCount ||
+            query.destination < 0 || query.destination >= nodeCount) {
+            cerr << "Warning: Skipping query " << query.source << " -> "
+                 << query.destination << " (invalid node)\n";
+            continue;
+        }
+        engine.submit(index++, query);
+    }
+    engine.wait();
+    writer.flush();
+
+    double wallMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+    LatencySummary::compute(latencies, wallMs).print();
+    if (search.treeCache) {
+        treeCache.getStats().print();
+    }
+
+    cerr << "Per-thread load: queries / busy ms\n";
+    vector<typename QueryEngine<Queue>::WorkerStats> workerStats = engine.getWorkerStats();
+    for (size_t i = 0; i < workerStats.size(); i++) {
+        cerr << "  " << i << ": " << workerStats[i].queries << " / " << workerStats[i].busyMs << "\n";
+    }
+    return 0;
+}
+
+// Run the same in-memory query set with each thread count and report how
+// throughput scales. Results are discarded; only timings are kept.
+template <typename Queue>
+int measureScaling(const CSRGraph& graph, const CSRGraph* reverse, const ServerOptions& options) {
+    QueryReader reader;
+    if (!reader.open(options.queryFile)) {
+        return 1;
+    }
+    vector<Query> queries;
+    Query query;
+    while (reader.next(query)) {
+        if (query.source >= 0 && query.source < graph.getNodeCount() &&
+            query.destination >= 0 && query.destination < graph.getNodeCount()) {
+            queries.push_back(query);
+        }
+    }
+    if (queries.empty()) {
+        cerr << "Error: No valid queries\n";
+        return 1;
+    }
+
+    cout << "-------------------------------------------\n";
+    cout << "Thread scaling (" << queries.size() << " queries x " << options.repeat
+         << ", " << thread::hardware_concurrency() << " hardware threads)\n";
+    cout << "Threads  Time_ms  Queries/sec  p50_us  p99_us  Speedup  Per-thread_qps"
+         << (options.cacheTrees > 0 ? "  Cache_hit_rate" : "") << "\n";
+
+    double baseQps = 0.0;
+    for (int threads : options.scaling) {
+        mutex latencyMutex;
+        vector<double> latencies;
+        latencies.reserve(queries.size() * options.repeat);
+        auto handler = [&](int, const Query&, const PathResult&, double latencyUs) {
+            lock_guard<mutex> lock(latencyMutex);
+            latencies.push_back(latencyUs);
+        };
+
+        // Every thread count starts from an empty cache
+        PathTreeCache treeCache(options.cacheTrees);
+        SearchOptions search = options.search;
+        if (options.cacheTrees > 0) {
+            search.treeCache = &treeCache;
+        }
+        QueryEngine<Queue> engine(graph, reverse, search, threads, handler);
+        auto start = chrono::high_resolution_clock::now();
+        int index = 0;
+        for (int pass = 0; pass < options.repeat; pass++) {
+            for (const Query& q : queries) {
+                engine.submit(index++, q);
+            }
+        }
+        engine.wait();
+        double wallMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+
+        LatencySummary summary = LatencySummary::compute(latencies, wallMs);
+        if (baseQps == 0.0) {
+            baseQps = summary.queriesPerSecond / threads;
+        }
+        double speedup = baseQps > 0.0 ? summary.queriesPerSecond / baseQps : 0.0;
+        cout << threads << "  " << wallMs << "  " << summary.queriesPerSecond << "  "
+             << summary.p50Us << "  " << summary.p99Us << "  " << speedup << "  "
+             << summary.queriesPerSecond / threads;
+        if (options.cacheTrees > 0) {
+            cout << "  " << treeCache.getStats().hitRate();
+        }
+        cout << "\n";
+    }
+    cout << "-------------------------------------------\n";
+    return 0;
+}
+
+template <typename Queue>
+int runServer(const CSRGraph& graph, const CSRGraph* reverse, const ServerOptions& options) {
+    if (!options.scaling.empty()) {
+        return measureScaling<Queue>(graph, reverse, options);
+    }
+    return serveQueries<Queue>(graph, reverse, options);
+}
+
+void printUsage(const char* programName) {
+    cout << "Query Server - Concurrent shortest-path queries over one shared graph\n\n";
+    cout << "Usage:\n";
+    cout << "  " << programName << " <graph_file> [options]\n";
+    cout << "\nOptions:\n";
+    cout << "  --queries <f|->      - \"source destination\" lines (default: stdin)\n";
+    cout << "  --threads <n>        - Worker threads (default: hardware threads)\n";
+    cout << "  --output <f>         - Result file (default: stdout)\n";
+    cout << "  --format csv|jsonl   - Result format (default: csv)\n";
+    cout << "  --scaling <n,n,...>  - Compare throughput across thread counts\n";
+    cout << "  --repeat <k>         - Passes over the query set in scaling mode (default: 1)\n";
+    cout << "  --ch <f>             - Answer with a hierarchy from ch_preprocess\n";
+    cout << "  --landmarks <f>      - A* with ALT bounds from landmark_preprocess\n";
+    cout << "  --cache-trees <n>    - Keep shortest-path trees of up to n repeated sources and\n";
+    cout << "                         answer their queries from them (default: off; not\n";
+    cout << "                         with --bidir or --ch)\n";
+    cout << "  --astar, --bidir, --heap binary|dary|radix\n";
+    cout << "                       - Search options, as for the sequential binary\n";
+    cout << "\nExample:\n";
+    cout << "  " << programName << " data/graph_15000.txt --queries queries.txt --threads 4\n";
+    cout << "  " << programName << " data/graph_15000.txt --queries queries.txt --scaling 1,2,4,8\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    string graphFile = argv[1];
+    ServerOptions options;
+    string hierarchyFile;
+    string landmarkFile;
+    options.threads = max(1u, thread::hardware_concurrency());
+
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--astar") {
+            options.search.useAStar = true;
+        } else if (arg == "--bidir") {
+            options.search.bidirectional = true;
+        } else if (arg == "--heap" && i + 1 < argc) {
+            if (!parseQueuePolicy(argv[++i], options.search.policy)) {
+                cerr << "Error: Unknown heap policy " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--ch" && i + 1 < argc) {
+            hierarchyFile = argv[++i];
+        } else if (arg == "--landmarks" && i + 1 < argc) {
+            landmarkFile = argv[++i];
+            options.search.useAStar = true;
+        } else if (arg == "--queries" && i + 1 < argc) {
+            options.queryFile = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = atoi(argv[++i]);
+        } else if (arg == "--output" && i + 1 < argc) {
+            options.outputFile = argv[++i];
+        } else if (arg == "--format" && i + 1 < argc) {
+            if (!parseResultFormat(argv[++i], options.format)) {
+                cerr << "Error: Unknown result format " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--scaling" && i + 1 < argc) {
+            stringstream list(argv[++i]);
+            string item;
+            while (getline(list, item, ',')) {
+                options.scaling.push_back(atoi(item.c_str()));
+            }
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            options.repeat = atoi(argv[++i]);
+        } else if (arg == "--cache-trees" && i + 1 < argc) {
+            options.cacheTrees = atoi(argv[++i]);
+            if (options.cacheTrees <= 0) {
+                cerr << "Error: --cache-trees must be positive\n";
+                return 1;
+            }
+        } else {
+            cerr << "Error: Unknown option " << arg << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    bool validThreads = options.threads > 0 && options.repeat > 0;
+    for (int threads : options.scaling) {
+        validThreads = validThreads && threads > 0;
+    }
+    if (!validThreads) {
+        cerr << "Error: Thread counts and --repeat must be positive\n";
+        return 1;
+    }
+    if (!options.scaling.empty() && options.queryFile == "-") {
+        cerr << "Error: --scaling needs a query file to replay\n";
+        return 1;
+    }
+    if (options.search.useAStar && options.search.policy == QueuePolicy::Radix) {
+        cerr << "Error: --heap radix requires monotone keys; use it without --astar\n";
+        return 1;
+    }
+    if (!hierarchyFile.empty() && !landmarkFile.empty()) {
+        cerr << "Error: --ch and --landmarks cannot be combined\n";
+        return 1;
+    }
+    if (!hierarchyFile.empty() && (options.search.useAStar || options.search.bidirectional)) {
+        cerr << "Error: --ch replaces the search; it cannot be combined with --astar or --bidir\n";
+        return 1;
+    }
+    // Cached trees would answer instead of the configured search
+    if (options.cacheTrees > 0 && (!hierarchyFile.empty() || options.search.bidirectional)) {
+        cerr << "Error: --cache-trees only combines with one-directional searches; drop --ch and --bidir\n";
+        return 1;
+    }
+
+    // Results may go to stdout, so progress is reported on stderr
+    cerr << "===========================================\n";
+    cerr << "Query Server\n";
+    cerr << "===========================================\n";
+    cerr << "Loading graph from: " << graphFile << "\n";
+
+    CSRGraph graph;
+    if (!graph.loadFromFile(graphFile)) {
+        cerr << "Error: Failed to load graph file\n";
+        return 1;
+    }
+    cerr << "Nodes: " << graph.getNodeCount() << ", Edges: " << graph.getEdgeCount() << "\n";
+
+    CSRGraph reverse;
+    if (options.search.bidirectional) {
+        reverse = graph.getReverse();
+    }
+    const CSRGraph* reverseGraph = options.search.bidirectional ? &reverse : nullptr;
+
+    // The hierarchy is shared read-only by all workers
+    ContractionHierarchy hierarchy;
+    if (!hierarchyFile.empty()) {
+        if (!hierarchy.loadFromFile(hierarchyFile)) {
+            return 1;
+        }
+        if (!hierarchy.matches(graph)) {
+            cerr << "Error: " << hierarchyFile << " was built for a different graph\n";
+            return 1;
+        }
+        options.search.hierarchy = &hierarchy;
+        cerr << "Algorithm:   Contraction Hierarchies\n";
+    }
+
+    LandmarkSet landmarks;
+    if (!landmarkFile.empty()) {
+        if (!landmarks.loadFromFile(landmarkFile)) {
+            return 1;
+        }
+        if (!landmarks.matches(graph)) {
+            cerr << "Error: " << landmarkFile << " was computed for a different graph\n";
+            return 1;
+        }
+        options.search.landmarks = &landmarks;
+    }
+    if (!options.search.hierarchy) {
+        cerr << "Algorithm:   " << (options.search.bidirectional ? "Bidirectional " : "")
+             << (options.search.useAStar ? "Dijkstra + A*" : "Standard Dijkstra")
+             << (options.search.landmarks ? " (landmarks)" : "") << "\n";
+    }
+    cerr << "Heap:        " << getQueuePolicyName(options.search.policy) << "\n";
+    if (options.scaling.empty()) {
+        cerr << "Threads:     " << options.threads << "\n";
+    }
+    if (options.cacheTrees > 0) {
+        cerr << "Tree cache:  " << options.cacheTrees << " trees (up to "
+             << (long long)options.cacheTrees * graph.getNodeCount() * sizeof(int) / 1024 << " KB)\n";
+    }
+
+    // Instantiate the engine for the queue policy chosen at runtime
+    switch (options.search.policy) {
+        case QueuePolicy::DaryHeap:
+            return runServer<DaryHeapQueue<4>>(graph, reverseGraph, options);
+        case QueuePolicy::Radix:
+            return runServer<RadixHeapQueue>(graph, reverseGraph, options);
+        default:
+            return runServer<BinaryHeapQueue>(graph, reverseGraph, options);
+    }
+}
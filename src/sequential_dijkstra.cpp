@@ -1,243 +1,607 @@
-#include "../include/Graph.h"
-#include <queue>
+#include "../include/Dijkstra.h"
+#include "../include/QueryBatch.h"
+#include "../include/DistanceField.h"
+#include "../include/NodeOrdering.h"
+#include "../include/DynamicGraph.h"
+#include <algorithm>
 #include <vector>
 #include <limits>
+#include <cmath>
 #include <iostream>
 #include <chrono>
+#include <type_traits>
 
 using namespace std;
 
-// Sequential Dijkstra's Algorithm
-PathResult sequentialDijkstra(const Graph& graph, int source, int destination) {
-    PathResult result;
+// Answer a single query and print the full report
+template <typename Queue, typename Graph>
+int runSingleQuery(const Graph& graph, const Graph* reverse,
+                   const SearchOptions& options, int source, int destination) {
+    QuerySolver<Queue, Graph> solver(graph, reverse, options);
+
+    // Run algorithm
+    cout << "Computing shortest path...\n";
+
+    auto startTime = chrono::high_resolution_clock::now();
+
+    PathResult result = solver.solve(source, destination);
+
+    auto endTime = chrono::high_resolution_clock::now();
+    auto duration = chrono::duration_cast<chrono::milliseconds>(endTime - startTime);
+
+    result.executionTime = duration.count();
+
+    // Display results
+    cout << "\n===========================================\n";
+    cout << "Results\n";
+    cout << "===========================================\n";
+    result.printResult();
+    result.stats.print();
+    cout << "===========================================\n";
+
+    return 0;
+}
+
+// Stream queries through one solver, writing a result line per query
+template <typename Queue, typename Graph>
+int runBatch(const Graph& graph, const Graph* reverse, const SearchOptions& options,
+             QueryReader& reader, QueryResultWriter& writer) {
+    QuerySolver<Queue, Graph> solver(graph, reverse, options);
     int nodeCount = graph.getNodeCount();
-    
-    // Initialize distances and predecessors
-    vector<double> distances(nodeCount, numeric_limits<double>::infinity());
-    vector<int> predecessors(nodeCount, -1);
-    vector<bool> visited(nodeCount, false);
-    
-    // Priority queue: min-heap based on distance
-    priority_queue<PQElement, vector<PQElement>, greater<PQElement>> pq;
-    
-    // Start from source
-    distances[source] = 0.0;
-    pq.push(PQElement(source, 0.0, 0.0));
-    
-    int nodesProcessed = 0;
-    
-    while (!pq.empty()) {
-        PQElement current = pq.top();
-        pq.pop();
-        
-        int currentNode = current.nodeId;
-        
-        // Skip if already visited
-        if (visited[currentNode]) {
+    vector<double> latencies;
+
+    auto batchStart = chrono::high_resolution_clock::now();
+    Query query;
+    int index = 0;
+    while (reader.next(query)) {
+        if (query.source < 0 || query.source >= nodeCount ||
+            query.destination < 0 || query.destination >= nodeCount) {
+            cerr << "Warning: Skipping query " << query.source << " -> "
+                 << query.destination << " (invalid node)\n";
             continue;
         }
-        
-        visited[currentNode] = true;
-        nodesProcessed++;
-        
-        // Early termination if destination reached
-        if (currentNode == destination) {
-            break;
-        }
-        
-        // Explore neighbors
-        const vector<Edge>& edges = graph.getAdjacencyList(currentNode);
-        
-        for (const Edge& edge : edges) {
-            int neighbor = edge.destination;
-            double newDistance = distances[currentNode] + edge.weight;
-            
-            // Relaxation step
-            if (newDistance < distances[neighbor]) {
-                distances[neighbor] = newDistance;
-                predecessors[neighbor] = currentNode;
-                pq.push(PQElement(neighbor, newDistance, newDistance));
-            }
-        }
+
+        auto start = chrono::high_resolution_clock::now();
+        PathResult result = solver.solve(query.source, query.destination);
+        double latencyUs = chrono::duration<double, micro>(
+            chrono::high_resolution_clock::now() - start).count();
+
+        latencies.push_back(latencyUs);
+        int hops = result.found ? (int)result.path.size() - 1 : -1;
+        writer.write(index++, query, result.totalDistance, hops, latencyUs);
     }
-    
-    // Reconstruct path
-    if (distances[destination] != numeric_limits<double>::infinity()) {
-        result.found = true;
-        result.totalDistance = distances[destination];
-        
-        // Build path from destination to source
-        vector<int> reversePath;
-        int current = destination;
-        
-        while (current != -1) {
-            reversePath.push_back(current);
-            current = predecessors[current];
-        }
-        
-        // Reverse to get path from source to destination
-        result.path.assign(reversePath.rbegin(), reversePath.rend());
-    }
-    
-    return result;
+    writer.flush();
+
+    double wallMs = chrono::duration<double, milli>(
+        chrono::high_resolution_clock::now() - batchStart).count();
+    LatencySummary::compute(latencies, wallMs).print();
+    if (options.treeCache) {
+        options.treeCache->getStats().print();
+    }
+    return 0;
+}
+
+// Where and how a one-to-all run stores its distance field
+struct DistanceOutput {
+    string filename;  // Empty: report only
+    DistanceEncoding encoding = DistanceEncoding::Float64;
+    double fixedScale = 0.0;  // 0 = fit the largest distance
+};
+
+// Stream a distance field to disk; distanceOf(v) gives the distance of
+// original node v
+template <typename DistanceOf>
+int writeDistanceOutput(const DistanceOutput& output, int nodeCount, const vector<int>& sources,
+                        double maxDistance, const DistanceOf& distanceOf) {
+    double scale = output.fixedScale > 0.0 ? output.fixedScale
+                                           : DistanceFieldFormat::chooseFixedScale(maxDistance);
+    auto writeStart = chrono::high_resolution_clock::now();
+    DistanceFieldWriter writer;
+    if (!writer.open(output.filename, output.encoding, nodeCount, sources, scale)) {
+        return 1;
+    }
+    for (int v = 0; v < nodeCount; v++) {
+        writer.append(distanceOf(v));
+    }
+    if (!writer.close()) {
+        return 1;
+    }
+    double writeMs = chrono::duration<double, milli>(
+        chrono::high_resolution_clock::now() - writeStart).count();
+
+    cout << "Distances: " << output.filename << " (" << getDistanceEncodingName(output.encoding)
+         << ", " << nodeCount * getDistanceEncodingBytes(output.encoding) / 1024 << " KB, "
+         << writeMs << " ms)\n";
+    if (output.encoding == DistanceEncoding::Fixed32) {
+        cout << "Fixed-point scale: " << scale << "\n";
+    }
+    if (writer.getSaturatedCount() > 0) {
+        cerr << "Warning: " << writer.getSaturatedCount()
+             << " distances exceed the fixed-point range and were clamped\n";
+    }
+    return 0;
 }
 
-// Sequential Dijkstra with A* heuristic
-PathResult sequentialAStarDijkstra(const Graph& graph, int source, int destination) {
-    PathResult result;
+// Run one-to-all Dijkstra from all sources and stream the distances to disk.
+// Sources and the field are in original node IDs.
+template <typename Queue, typename Graph>
+int runOneToAll(const Graph& graph, const vector<int>& sources, const DistanceOutput& output) {
+    SearchSpace<Queue> space;
     int nodeCount = graph.getNodeCount();
-    
-    // Initialize distances and predecessors
-    vector<double> distances(nodeCount, numeric_limits<double>::infinity());
-    vector<int> predecessors(nodeCount, -1);
-    vector<bool> visited(nodeCount, false);
-    
-    // Priority queue: min-heap based on f-score (distance + heuristic)
-    priority_queue<PQElement, vector<PQElement>, greater<PQElement>> pq;
-    
-    // Start from source
-    distances[source] = 0.0;
-    double heuristic = graph.getHeuristic(source, destination);
-    pq.push(PQElement(source, 0.0, heuristic));
-    
-    int nodesProcessed = 0;
-    
-    while (!pq.empty()) {
-        PQElement current = pq.top();
-        pq.pop();
-        
-        int currentNode = current.nodeId;
-        
-        // Skip if already visited
-        if (visited[currentNode]) {
-            continue;
+    vector<int> internalSources;
+    for (int sourceNode : sources) {
+        internalSources.push_back(graph.getInternalId(sourceNode));
+    }
+
+    cout << "Computing distances from " << sources.size() << " source(s)...\n";
+    auto startTime = chrono::high_resolution_clock::now();
+    SearchStats stats = oneToAllDijkstra(graph, space, internalSources);
+    double solveMs = chrono::duration<double, milli>(
+        chrono::high_resolution_clock::now() - startTime).count();
+
+    long long reached = 0;
+    double maxDistance = 0.0;
+    for (int v = 0; v < nodeCount; v++) {
+        double d = space.getDistance(v);
+        if (d < numeric_limits<double>::infinity()) {
+            reached++;
+            maxDistance = max(maxDistance, d);
         }
-        
-        visited[currentNode] = true;
-        nodesProcessed++;
-        
-        // Early termination if destination reached
-        if (currentNode == destination) {
-            break;
-        }
-        
-        // Explore neighbors
-        const vector<Edge>& edges = graph.getAdjacencyList(currentNode);
-        
-        for (const Edge& edge : edges) {
-            int neighbor = edge.destination;
-            double newDistance = distances[currentNode] + edge.weight;
-            
-            // Relaxation step
-            if (newDistance < distances[neighbor]) {
-                distances[neighbor] = newDistance;
-                predecessors[neighbor] = currentNode;
-                
-                // Calculate f-score: g(n) + h(n)
-                double heuristic = graph.getHeuristic(neighbor, destination);
-                double fScore = newDistance + heuristic;
-                
-                pq.push(PQElement(neighbor, newDistance, fScore));
+    }
+
+    cout << "\n===========================================\n";
+    cout << "Results\n";
+    cout << "===========================================\n";
+    cout << "Reached: " << reached << " of " << nodeCount << " nodes\n";
+    cout << "Max distance: " << maxDistance << "\n";
+    cout << "Execution time: " << solveMs << " ms\n";
+    stats.print();
+
+    if (!output.filename.empty() &&
+        writeDistanceOutput(output, nodeCount, sources, maxDistance,
+                            [&](int v) { return space.getDistance(graph.getInternalId(v)); }) != 0) {
+        return 1;
+    }
+    cout << "===========================================\n";
+    return 0;
+}
+
+// One-to-all distances kept up to date through the batches of an update
+// file; the field written at the end is that of the updated graph. With
+// verify the final field is checked against a search from scratch.
+template <typename Graph>
+int runDynamicOneToAll(const Graph& graph, const vector<int>& sources, const string& updateFile,
+                       bool verify, const DistanceOutput& output) {
+    vector<vector<EdgeUpdate>> batches;
+    if (!loadEdgeUpdates(updateFile, batches)) {
+        return 1;
+    }
+    int nodeCount = graph.getNodeCount();
+    vector<int> internalSources;
+    for (int sourceNode : sources) {
+        internalSources.push_back(graph.getInternalId(sourceNode));
+    }
+    // Updates name original IDs; out-of-range ones are left for apply() to reject
+    for (vector<EdgeUpdate>& batch : batches) {
+        for (EdgeUpdate& update : batch) {
+            if (update.from >= 0 && update.from < nodeCount && update.to >= 0 && update.to < nodeCount) {
+                update.from = graph.getInternalId(update.from);
+                update.to = graph.getInternalId(update.to);
             }
         }
     }
-    
-    // Reconstruct path
-    if (distances[destination] != numeric_limits<double>::infinity()) {
-        result.found = true;
-        result.totalDistance = distances[destination];
-        
-        // Build path from destination to source
-        vector<int> reversePath;
-        int current = destination;
-        
-        while (current != -1) {
-            reversePath.push_back(current);
-            current = predecessors[current];
-        }
-        
-        // Reverse to get path from source to destination
-        result.path.assign(reversePath.rbegin(), reversePath.rend());
-    }
-    
-    return result;
+
+    DynamicGraph dynamic(graph);
+    IncrementalSSSP field(dynamic);
+    cout << "Computing distances from " << sources.size() << " source(s)...\n";
+    RepairStats initial = field.compute(internalSources);
+
+    cout << "\n===========================================\n";
+    cout << "Results\n";
+    cout << "===========================================\n";
+    cout << "Initial field: " << initial.repairMs << " ms (" << initial.settled << " nodes settled)\n";
+    double repairMs = 0.0;
+    for (size_t b = 0; b < batches.size(); b++) {
+        RepairStats stats = field.applyBatch(batches[b]);
+        repairMs += stats.repairMs;
+        cout << "Batch " << b + 1 << ": " << batches[b].size() << " updates, " << stats.edgesChanged
+             << " edges changed, " << stats.affected << " affected, " << stats.settled
+             << " settled, " << stats.edgesScanned << " edges scanned, " << stats.repairMs << " ms\n";
+    }
+    cout << "Repair time: " << repairMs << " ms for " << batches.size() << " batch(es)\n";
+
+    long long reached = 0;
+    double maxDistance = 0.0;
+    for (int v = 0; v < nodeCount; v++) {
+        double d = field.getDistance(v);
+        if (d < numeric_limits<double>::infinity()) {
+            reached++;
+            maxDistance = max(maxDistance, d);
+        }
+    }
+    cout << "Reached: " << reached << " of " << nodeCount << " nodes\n";
+    cout << "Max distance: " << maxDistance << "\n";
+
+    int status = 0;
+    if (verify) {
+        IncrementalSSSP reference(dynamic);
+        RepairStats full = reference.compute(internalSources);
+        long long mismatches = 0;
+        for (int v = 0; v < nodeCount; v++) {
+            double want = reference.getDistance(v);
+            double got = field.getDistance(v);
+            mismatches += !sameDistance(want, got);
+        }
+        cout << "Full recompute: " << full.repairMs << " ms; " << mismatches << " mismatching nodes\n";
+        status = mismatches == 0 ? 0 : 1;
+    }
+
+    if (!output.filename.empty() &&
+        writeDistanceOutput(output, nodeCount, sources, maxDistance,
+                            [&](int v) { return field.getDistance(graph.getInternalId(v)); }) != 0) {
+        return 1;
+    }
+    cout << "===========================================\n";
+    return status;
+}
+
+template <typename Queue, typename Graph>
+int runQueries(const Graph& graph, const Graph* reverse, const SearchOptions& options,
+               bool batchMode, QueryReader& reader, QueryResultWriter& writer,
+               int source, int destination) {
+    if (batchMode) {
+        return runBatch<Queue>(graph, reverse, options, reader, writer);
+    }
+    return runSingleQuery<Queue>(graph, reverse, options, source, destination);
 }
 
 void printUsage(const char* programName) {
     cout << "Sequential Dijkstra - Baseline Shortest Path Finder\n\n";
     cout << "Usage:\n";
-    cout << "  " << programName << " <graph_file> <source> <destination> [--astar]\n";
+    cout << "  " << programName << " <graph_file> <source> <destination> [--astar] [--bidir] [--heap <policy>]\n";
+    cout << "  " << programName << " <graph_file> <source> <destination> --ch <file> | --landmarks <file> [--bidir]\n";
+    cout << "  " << programName << " <graph_file> --batch <query_file|-> [--output <file>] [--format csv|jsonl] [search options]\n";
+    cout << "  " << programName << " <graph_file> --sssp <sources> [--distances <file>] [--distance-format <f>] [--heap <policy>]\n";
     cout << "\nArguments:\n";
     cout << "  graph_file    - Path to graph data file\n";
     cout << "  source        - Source node ID\n";
     cout << "  destination   - Destination node ID\n";
     cout << "  --astar       - Use A* heuristic (optional)\n";
+    cout << "  --bidir       - Search from both ends (optional, combines with --astar)\n";
+    cout << "  --heap        - Priority queue: binary (lazy, default), dary (indexed\n";
+    cout << "                  4-ary with decrease-key) or radix (Dijkstra only)\n";
+    cout << "  --ch          - Answer with a hierarchy from ch_preprocess (optional)\n";
+    cout << "  --landmarks   - A* with ALT bounds from landmark_preprocess (optional)\n";
+    cout << "  --batch       - Answer \"source destination\" lines from a file or stdin (-)\n";
+    cout << "  --output      - Batch result file (default: stdout)\n";
+    cout << "  --format      - Batch result format: csv (default) or jsonl\n";
+    cout << "  --cache-trees - Batch: keep shortest-path trees of up to n repeated sources\n";
+    cout << "                  and answer their queries from them (default: off; not\n";
+    cout << "                  with --bidir or --ch)\n";
+    cout << "  --sssp        - Distances from the sources to every node; sources are\n";
+    cout << "                  \"s\", \"s1,s2,...\" (multi-source) or \"@file\" (one per line)\n";
+    cout << "  --distances   - Distance field output file (binary, see DistanceField.h)\n";
+    cout << "  --distance-format double|float|fixed\n";
+    cout << "                - Stored values: double (default), float or 32-bit fixed point\n";
+    cout << "  --fixed-scale - Fixed point units per distance unit (default: fit the largest)\n";
+    cout << "  --updates     - Apply the edge updates of a file batch by batch, repairing\n";
+    cout << "                  the distances instead of recomputing them (see DynamicGraph.h)\n";
+    cout << "  --verify-updates\n";
+    cout << "                - Check the repaired field against a search from scratch\n";
+    cout << "  --weights double|float|uint32\n";
+    cout << "                - Stored edge weight type (default: double); float and uint32\n";
+    cout << "                  (integral weights only) give 8-byte edges\n";
+    cout << "  --edge-index 32|64\n";
+    cout << "                - Edge index width (default: 32); 64 for more than 2^31 - 1 edges\n";
+    cout << "  --reorder bfs|rcm|hilbert\n";
+    cout << "                - Renumber nodes for locality after loading; node IDs on the\n";
+    cout << "                  command line and in results stay the file's IDs\n";
     cout << "\nExample:\n";
     cout << "  " << programName << " data/synthetic/graph_1000.txt 0 999\n";
     cout << "  " << programName << " data/synthetic/graph_1000.txt 0 999 --astar\n";
+    cout << "  " << programName << " data/synthetic/graph_1000.txt 0 999 --heap dary\n";
+    cout << "  " << programName << " data/synthetic/graph_1000.txt 0 999 --bidir --astar\n";
+    cout << "  " << programName << " data/synthetic/graph_1000.txt 0 999 --ch data/synthetic/graph_1000.ch\n";
+    cout << "  " << programName << " data/synthetic/graph_1000.txt 0 999 --landmarks data/synthetic/graph_1000.lm\n";
+    cout << "  " << programName << " data/synthetic/graph_1000.txt --batch queries.txt --format jsonl\n";
+    cout << "  " << programName << " data/synthetic/graph_1000.txt --sssp 0,17,42 --distances d.bin --distance-format float\n";
+    cout << "  " << programName << " data/synthetic/graph_1000.txt --sssp 0 --updates traffic.txt --verify-updates\n";
+    cout << "  " << programName << " data/road.bin --batch queries.txt --weights uint32\n";
+    cout << "  " << programName << " data/road.bin --batch queries.txt --reorder hilbert\n";
 }
 
-int main(int argc, char* argv[]) {
+// The whole run for one graph type
+template <typename Graph>
+int runSequential(int argc, char* argv[]) {
     // Check arguments
+    bool batchMode = (argc >= 3 && string(argv[2]) == "--batch");
+    bool oneToAll = (argc >= 3 && string(argv[2]) == "--sssp");
     if (argc < 4) {
         printUsage(argv[0]);
         return 1;
     }
-    
+
     string graphFile = argv[1];
-    int source = atoi(argv[2]);
-    int destination = atoi(argv[3]);
-    bool useAStar = (argc >= 5 && string(argv[4]) == "--astar");
-    
+    int source = (batchMode || oneToAll) ? -1 : atoi(argv[2]);
+    int destination = (batchMode || oneToAll) ? -1 : atoi(argv[3]);
+    SearchOptions options;
+    string queryFile = batchMode ? argv[3] : "";
+    string outputFile = "-";
+    ResultFormat format = ResultFormat::CSV;
+    string hierarchyFile;
+    string landmarkFile;
+    vector<int> sources;
+    DistanceOutput distanceOutput;
+    NodeOrder reorder = NodeOrder::Identity;
+    string updateFile;
+    bool verifyUpdates = false;
+    int cacheTrees = 0;
+    if (oneToAll && !parseSourceList(argv[3], sources)) {
+        return 1;
+    }
+
+    for (int i = 4; i < argc; i++) {
+        string arg = argv[i];
+        if ((arg == "--weights" || arg == "--edge-index") && i + 1 < argc) {
+            i++;  // Picked by main()
+        } else if (arg == "--reorder" && i + 1 < argc) {
+            if (!parseNodeOrder(argv[++i], reorder)) {
+                cerr << "Error: Unknown node order " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--astar") {
+            options.useAStar = true;
+        } else if (arg == "--bidir") {
+            options.bidirectional = true;
+        } else if (arg == "--heap" && i + 1 < argc) {
+            if (!parseQueuePolicy(argv[++i], options.policy)) {
+                cerr << "Error: Unknown heap policy " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--ch" && i + 1 < argc) {
+            hierarchyFile = argv[++i];
+        } else if (arg == "--landmarks" && i + 1 < argc) {
+            landmarkFile = argv[++i];
+            options.useAStar = true;
+        } else if (batchMode && arg == "--output" && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (batchMode && arg == "--cache-trees" && i + 1 < argc) {
+            cacheTrees = atoi(argv[++i]);
+            if (cacheTrees <= 0) {
+                cerr << "Error: --cache-trees must be positive\n";
+                return 1;
+            }
+        } else if (batchMode && arg == "--format" && i + 1 < argc) {
+            if (!parseResultFormat(argv[++i], format)) {
+                cerr << "Error: Unknown result format " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (oneToAll && arg == "--distances" && i + 1 < argc) {
+            distanceOutput.filename = argv[++i];
+        } else if (oneToAll && arg == "--distance-format" && i + 1 < argc) {
+            if (!parseDistanceEncoding(argv[++i], distanceOutput.encoding)) {
+                cerr << "Error: Unknown distance format " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (oneToAll && arg == "--updates" && i + 1 < argc) {
+            updateFile = argv[++i];
+        } else if (oneToAll && arg == "--verify-updates") {
+            verifyUpdates = true;
+        } else if (oneToAll && arg == "--fixed-scale" && i + 1 < argc) {
+            distanceOutput.fixedScale = atof(argv[++i]);
+            if (distanceOutput.fixedScale <= 0.0) {
+                cerr << "Error: --fixed-scale must be positive\n";
+                return 1;
+            }
+        } else {
+            cerr << "Error: Unknown option " << arg << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // The radix heap needs monotone keys, which A* only gives with a
+    // consistent heuristic
+    if (options.useAStar && options.policy == QueuePolicy::Radix) {
+        cerr << "Error: --heap radix requires monotone keys; use it without --astar\n";
+        return 1;
+    }
+    if (!hierarchyFile.empty() && !landmarkFile.empty()) {
+        cerr << "Error: --ch and --landmarks cannot be combined\n";
+        return 1;
+    }
+    if (!hierarchyFile.empty() && (options.useAStar || options.bidirectional)) {
+        cerr << "Error: --ch replaces the search; it cannot be combined with --astar or --bidir\n";
+        return 1;
+    }
+    // Cached trees would answer instead of the configured search
+    if (cacheTrees > 0 && (!hierarchyFile.empty() || options.bidirectional)) {
+        cerr << "Error: --cache-trees only combines with one-directional searches; drop --ch and --bidir\n";
+        return 1;
+    }
+    // Goal-directed searches need a single destination
+    if (oneToAll && (options.useAStar || options.bidirectional || !hierarchyFile.empty())) {
+        cerr << "Error: --sssp runs plain Dijkstra; drop --astar, --bidir, --ch and --landmarks\n";
+        return 1;
+    }
+
+    // Hierarchies and landmarks index nodes by the numbering they were
+    // built for; reorder with generator --convert and preprocess that file
+    if (reorder != NodeOrder::Identity && (!hierarchyFile.empty() || !landmarkFile.empty())) {
+        cerr << "Error: --reorder cannot be combined with --ch or --landmarks\n";
+        return 1;
+    }
+
+    QueryReader reader;
+    QueryResultWriter writer;
+    if (batchMode && (!reader.open(queryFile) || !writer.open(outputFile, format))) {
+        return 1;
+    }
+
+    // Batch results may go to stdout, so progress is reported on stderr
+    ostream& report = batchMode ? cerr : cout;
+
     // Load graph
-    cout << "===========================================\n";
-    cout << "Sequential Dijkstra's Algorithm\n";
-    cout << "===========================================\n";
-    cout << "Loading graph from: " << graphFile << "\n";
-    
+    report << "===========================================\n";
+    report << "Sequential Dijkstra's Algorithm\n";
+    report << "===========================================\n";
+    report << "Loading graph from: " << graphFile << "\n";
+
     Graph graph;
     if (!graph.loadFromFile(graphFile)) {
         cerr << "Error: Failed to load graph file\n";
         return 1;
     }
-    
-    cout << "✓ Graph loaded successfully\n";
-    graph.printInfo();
-    
+
+    report << "✓ Graph loaded successfully\n";
+    if (batchMode) {
+        report << "Nodes: " << graph.getNodeCount() << ", Edges: " << graph.getEdgeCount() << "\n";
+    } else {
+        graph.printInfo();
+    }
+
+    if (reorder != NodeOrder::Identity) {
+        auto orderStart = chrono::high_resolution_clock::now();
+        vector<int> order;
+        if (!NodeOrdering::compute(graph, reorder, order)) {
+            return 1;
+        }
+        double spanBefore = NodeOrdering::averageEdgeSpan(graph);
+        graph = graph.permute(order);
+        auto orderTime = chrono::duration_cast<chrono::milliseconds>(
+            chrono::high_resolution_clock::now() - orderStart);
+        report << "Reordered:   " << getNodeOrderName(reorder) << " in " << orderTime.count()
+               << " ms (mean edge span " << spanBefore << " -> "
+               << NodeOrdering::averageEdgeSpan(graph) << ")\n";
+    }
+
     // Validate source and destination
-    if (source < 0 || source >= graph.getNodeCount() ||
-        destination < 0 || destination >= graph.getNodeCount()) {
+    if (!batchMode && !oneToAll && (source < 0 || source >= graph.getNodeCount() ||
+                       destination < 0 || destination >= graph.getNodeCount())) {
         cerr << "Error: Invalid source or destination node\n";
         return 1;
     }
-    
-    cout << "\nSource:      " << source << "\n";
-    cout << "Destination: " << destination << "\n";
-    cout << "Algorithm:   " << (useAStar ? "Dijkstra + A*" : "Standard Dijkstra") << "\n";
-    
-    // Run algorithm
-    cout << "Computing shortest path...\n";
-    
-    auto startTime = chrono::high_resolution_clock::now();
-    
-    PathResult result;
-    if (useAStar) {
-        result = sequentialAStarDijkstra(graph, source, destination);
+
+    if (oneToAll) {
+        for (int sourceNode : sources) {
+            if (sourceNode < 0 || sourceNode >= graph.getNodeCount()) {
+                cerr << "Error: Invalid source node " << sourceNode << "\n";
+                return 1;
+            }
+        }
+        report << "\nSources:     " << sources.size() << "\n";
+        if (!updateFile.empty()) {
+            report << "Updates:     " << updateFile << "\n";
+            return runDynamicOneToAll(graph, sources, updateFile, verifyUpdates, distanceOutput);
+        }
+        report << "Heap:        " << getQueuePolicyName(options.policy) << "\n";
+        switch (options.policy) {
+            case QueuePolicy::DaryHeap:
+                return runOneToAll<DaryHeapQueue<4>>(graph, sources, distanceOutput);
+            case QueuePolicy::Radix:
+                return runOneToAll<RadixHeapQueue>(graph, sources, distanceOutput);
+            default:
+                return runOneToAll<BinaryHeapQueue>(graph, sources, distanceOutput);
+        }
+    }
+
+    if (!batchMode) {
+        report << "\nSource:      " << source << "\n";
+        report << "Destination: " << destination << "\n";
+    }
+    // Queries are answered from the hierarchy instead of the graph
+    ContractionHierarchy hierarchy;
+    if (!hierarchyFile.empty()) {
+        auto loadStart = chrono::high_resolution_clock::now();
+        if (!hierarchy.loadFromFile(hierarchyFile)) {
+            return 1;
+        }
+        if (!hierarchy.matches(graph)) {
+            cerr << "Error: " << hierarchyFile << " was built for a different graph\n";
+            return 1;
+        }
+        auto loadTime = chrono::duration_cast<chrono::milliseconds>(
+            chrono::high_resolution_clock::now() - loadStart);
+        report << "Hierarchy loaded in " << loadTime.count() << " ms\n";
+        options.hierarchy = &hierarchy;
+    }
+
+    // Landmark lower bounds replace the Euclidean A* heuristic
+    LandmarkSet landmarks;
+    if (!landmarkFile.empty()) {
+        auto loadStart = chrono::high_resolution_clock::now();
+        if (!landmarks.loadFromFile(landmarkFile)) {
+            return 1;
+        }
+        if (!landmarks.matches(graph)) {
+            cerr << "Error: " << landmarkFile << " was computed for a different graph\n";
+            return 1;
+        }
+        auto loadTime = chrono::duration_cast<chrono::milliseconds>(
+            chrono::high_resolution_clock::now() - loadStart);
+        report << "Landmarks loaded in " << loadTime.count() << " ms\n";
+        options.landmarks = &landmarks;
+    }
+
+    if (options.hierarchy) {
+        report << "Algorithm:   Contraction Hierarchies\n";
     } else {
-        result = sequentialDijkstra(graph, source, destination);
+        report << "Algorithm:   " << (options.bidirectional ? "Bidirectional " : "")
+               << (options.useAStar ? "Dijkstra + A*" : "Standard Dijkstra")
+               << (options.landmarks ? " (landmarks)" : "") << "\n";
     }
-    
-    auto endTime = chrono::high_resolution_clock::now();
-    auto duration = chrono::duration_cast<chrono::milliseconds>(endTime - startTime);
-    
-    result.executionTime = duration.count();
-    
-    // Display results
-    cout << "\n===========================================\n";
-    cout << "Results\n";
-    cout << "===========================================\n";
-    result.printResult();
-    cout << "===========================================\n";
-    
-    return 0;
+    report << "Heap:        " << getQueuePolicyName(options.policy) << "\n";
+
+    PathTreeCache treeCache(cacheTrees);
+    if (cacheTrees > 0) {
+        options.treeCache = &treeCache;
+        report << "Tree cache:  " << cacheTrees << " trees (up to "
+               << (long long)cacheTrees * graph.getNodeCount() * sizeof(int) / 1024 << " KB)\n";
+    }
+
+    // The backward search walks incoming edges
+    Graph reverse;
+    if (options.bidirectional) {
+        auto reverseStart = chrono::high_resolution_clock::now();
+        reverse = graph.getReverse();
+        auto reverseTime = chrono::duration_cast<chrono::milliseconds>(
+            chrono::high_resolution_clock::now() - reverseStart);
+        report << "Reverse graph built in " << reverseTime.count() << " ms\n";
+    }
+    const Graph* reverseGraph = options.bidirectional ? &reverse : nullptr;
+
+    // Instantiate the solver for the queue policy chosen at runtime
+    switch (options.policy) {
+        case QueuePolicy::DaryHeap:
+            return runQueries<DaryHeapQueue<4>>(graph, reverseGraph, options, batchMode,
+                                                reader, writer, source, destination);
+        case QueuePolicy::Radix:
+            return runQueries<RadixHeapQueue>(graph, reverseGraph, options, batchMode,
+                                              reader, writer, source, destination);
+        default:
+            return runQueries<BinaryHeapQueue>(graph, reverseGraph, options, batchMode,
+                                               reader, writer, source, destination);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // The graph layout fixes the solver instantiation, so it is picked
+    // before the rest of the command line is parsed
+    EdgeIndexType indexType = EdgeIndexType::Int32;
+    WeightType weightType = WeightType::Float64;
+    for (int i = 4; i + 1 < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--weights" && !parseWeightType(argv[i + 1], weightType)) {
+            cerr << "Error: Unknown weight type " << argv[i + 1] << "\n";
+            return 1;
+        }
+        if (arg == "--edge-index" && !parseEdgeIndexType(argv[i + 1], indexType)) {
+            cerr << "Error: Unknown edge index width " << argv[i + 1] << "\n";
+            return 1;
+        }
+    }
+
+    return withGraphLayout(indexType, weightType, [&](auto* graphType) {
+        return runSequential<remove_pointer_t<decltype(graphType)>>(argc, argv);
+    });
 }